@@ -14,5 +14,11 @@ let package = Package(
             .product(name: "SotoCore", package: "soto-core"),
             .product(name: "Benchmark", package: "Benchmark"),
         ]),
+        .target(name: "soto-end-to-end", dependencies: [
+            .byName(name: "CAllocationCounter"),
+            .product(name: "SotoCore", package: "soto-core"),
+            .product(name: "SotoTestUtils", package: "soto-core"),
+        ]),
+        .target(name: "CAllocationCounter", dependencies: []),
     ]
 )
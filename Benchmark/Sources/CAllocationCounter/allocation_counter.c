@@ -0,0 +1,132 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the Soto for AWS open source project
+//
+// Copyright (c) 2017-2020 the Soto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.txt for the list of Soto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+#include <errno.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+#include "allocation_counter.h"
+
+#if defined(__GLIBC__)
+
+/* the glibc implementations, these are exported so they can be called from
+   replacement allocation functions */
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void __libc_free(void *ptr);
+extern void *__libc_memalign(size_t alignment, size_t size);
+
+static _Atomic int64_t allocationCount = 0;
+static _Atomic int64_t freeCount = 0;
+static _Atomic int64_t allocatedBytes = 0;
+
+static void
+countAllocation(size_t size) {
+  atomic_fetch_add_explicit(&allocationCount, 1, memory_order_relaxed);
+  atomic_fetch_add_explicit(&allocatedBytes, (int64_t)size, memory_order_relaxed);
+}
+
+static void
+countFree(void) {
+  atomic_fetch_add_explicit(&freeCount, 1, memory_order_relaxed);
+}
+
+void *
+malloc(size_t size) {
+  countAllocation(size);
+  return __libc_malloc(size);
+}
+
+void *
+calloc(size_t count, size_t size) {
+  countAllocation(count * size);
+  return __libc_calloc(count, size);
+}
+
+void *
+realloc(void *ptr, size_t size) {
+  void *newPtr = __libc_realloc(ptr, size);
+  if (ptr == NULL) {
+    countAllocation(size);
+  } else if (size == 0) {
+    countFree();
+  } else if (newPtr != NULL) {
+    countAllocation(size);
+    countFree();
+  }
+  return newPtr;
+}
+
+void
+free(void *ptr) {
+  if (ptr != NULL)
+    countFree();
+  __libc_free(ptr);
+}
+
+int
+posix_memalign(void **memptr, size_t alignment, size_t size) {
+  /* alignment has to be a power of two multiple of sizeof(void *) */
+  if (alignment % sizeof(void *) != 0 || (alignment & (alignment - 1)) != 0)
+    return EINVAL;
+  void *ptr = __libc_memalign(alignment, size);
+  if (ptr == NULL)
+    return ENOMEM;
+  countAllocation(size);
+  *memptr = ptr;
+  return 0;
+}
+
+void *
+aligned_alloc(size_t alignment, size_t size) {
+  countAllocation(size);
+  return __libc_memalign(alignment, size);
+}
+
+void *
+memalign(size_t alignment, size_t size) {
+  countAllocation(size);
+  return __libc_memalign(alignment, size);
+}
+
+int
+Soto_AllocationCounterIsEnabled(void) {
+  return 1;
+}
+
+Soto_AllocationCounts
+Soto_AllocationCounterSnapshot(void) {
+  Soto_AllocationCounts counts;
+  counts.allocations = atomic_load_explicit(&allocationCount, memory_order_relaxed);
+  counts.frees = atomic_load_explicit(&freeCount, memory_order_relaxed);
+  counts.bytes = atomic_load_explicit(&allocatedBytes, memory_order_relaxed);
+  return counts;
+}
+
+#else
+
+int
+Soto_AllocationCounterIsEnabled(void) {
+  return 0;
+}
+
+Soto_AllocationCounts
+Soto_AllocationCounterSnapshot(void) {
+  Soto_AllocationCounts counts = {0, 0, 0};
+  return counts;
+}
+
+#endif
@@ -0,0 +1,52 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the Soto for AWS open source project
+//
+// Copyright (c) 2017-2020 the Soto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.txt for the list of Soto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _ALLOCATION_COUNTER_H_
+#define _ALLOCATION_COUNTER_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Process wide counts of heap allocations. On glibc platforms malloc, calloc,
+   realloc, free and the aligned allocation functions are replaced by versions
+   that count each call before forwarding it to the glibc implementation. On
+   other platforms nothing is counted and Soto_AllocationCounterIsEnabled
+   returns 0.
+
+   Counters are never reset, take the difference between two snapshots to
+   count the allocations made by a piece of code. */
+typedef struct Soto_AllocationCounts {
+  /* number of allocations, resizing memory with realloc counts as one
+     allocation and one free whether or not the memory moves */
+  int64_t allocations;
+  /* number of frees */
+  int64_t frees;
+  /* total bytes requested by the allocations */
+  int64_t bytes;
+} Soto_AllocationCounts;
+
+/* Returns 1 if allocations are being counted */
+int Soto_AllocationCounterIsEnabled(void);
+
+/* Current allocation counts */
+Soto_AllocationCounts Soto_AllocationCounterSnapshot(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _ALLOCATION_COUNTER_H_ */
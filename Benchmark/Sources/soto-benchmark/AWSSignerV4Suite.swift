@@ -25,6 +25,18 @@ let awsSignerV4Suite = BenchmarkSuite(name: "AWSSignerV4", settings: Iterations(
         _ = signer.signHeaders(url: URL(string: "https://test-bucket.s3.amazonaws.com/test-put.txt")!, method: .GET, headers: ["Content-Type": "application/x-www-form-urlencoded; charset=utf-8"], body: .string(string))
     }
 
+    let headers: HTTPHeaders = [
+        "Content-Type": "application/x-www-form-urlencoded; charset=utf-8",
+        "x-amz-acl": "private",
+        "x-amz-storage-class": "STANDARD",
+        "x-amz-meta-title": "  My Document ",
+        "x-amz-meta-author": "Soto",
+        "Cache-Control": "no-cache",
+    ]
+    suite.benchmark("sign-headers-query-and-headers") {
+        _ = signer.signHeaders(url: URL(string: "https://test-bucket.s3.amazonaws.com/folder/test%20put+1.txt?acl=&list-type=2&prefix=folder%2F")!, method: .PUT, headers: headers, body: .string(string))
+    }
+
     suite.benchmark("sign-url") {
         _ = signer.signURL(url: URL(string: "https://test-bucket.s3.amazonaws.com/test-put.txt")!, method: .GET, body: .string(string), expires: .hours(1))
     }
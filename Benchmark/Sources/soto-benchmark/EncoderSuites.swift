@@ -14,6 +14,7 @@
 
 import Benchmark
 import Foundation
+import NIO
 import SotoCore
 import SotoXML
 
@@ -36,6 +37,16 @@ extension QueryEncoder: EncoderProtocol {
     }
 }
 
+/// QueryEncoder writing straight into a ByteBuffer
+struct QueryByteBufferEncoder: EncoderProtocol {
+    let encoder = QueryEncoder()
+    let byteBufferAllocator = ByteBufferAllocator()
+
+    func encode<Input: Encodable>(_ value: Input) throws -> ByteBuffer? {
+        try self.encoder.encode(value, byteBufferAllocator: self.byteBufferAllocator)
+    }
+}
+
 struct Numbers: Codable {
     let b: Bool
     let i: Int
@@ -92,6 +103,17 @@ let xmlDecoderSuite = BenchmarkSuite(name: "XMLDecoder", settings: Iterations(10
         let result = try XML.Element(xmlString: xml)
     }
 
+    // small query protocol response. Parsing many of these is dominated by the cost of setting up the Expat parser,
+    // which is recycled from a per thread pool
+    var sqsResponse = #"<SendMessageResponse><SendMessageResult><MD5OfMessageBody>fafb00f5732ab283681e124bf8747ed1</MD5OfMessageBody><MessageId>5fea7756-0ea4-451a-a703-a558b933e274</MessageId></SendMessageResult><ResponseMetadata><RequestId>27daac76-34dd-47df-bd01-1f6e873584a0</RequestId></ResponseMetadata></SendMessageResponse>"#
+    suite.benchmark("parseSmallResponse") {
+        let parser = try XML.IncrementalParser()
+        try sqsResponse.withUTF8 { bytes in
+            try parser.feed(UnsafeRawBufferPointer(bytes))
+        }
+        _ = try parser.finish()
+    }
+
     if let numbers = try? XML.Element(xmlString: #"<numbers><b>true</b><i>362222</i><f>3.14</f><d>2.777776</d></numbers>"#) {
         suite.benchmark("numbers") {
             _ = try XMLDecoder().decode(Numbers.self, from: numbers)
@@ -140,3 +162,8 @@ let dictionaryDecoderSuite = BenchmarkSuite(name: "DictionaryDecoder", settings:
 let queryEncoderSuite = BenchmarkSuite(name: "QueryEncoder", settings: Iterations(10000), WarmupIterations(10)) { suite in
     encoderSuite(for: QueryEncoder(), suite: suite)
 }
+
+/// Suite of benchmark tests for QueryEncoder writing into a ByteBuffer
+let queryByteBufferEncoderSuite = BenchmarkSuite(name: "QueryEncoder-ByteBuffer", settings: Iterations(10000), WarmupIterations(10)) { suite in
+    encoderSuite(for: QueryByteBufferEncoder(), suite: suite)
+}
@@ -17,6 +17,7 @@ import Benchmark
 let suites = [
     awsSignerV4Suite,
     queryEncoderSuite,
+    queryByteBufferEncoderSuite,
     xmlEncoderSuite,
     xmlDecoderSuite,
     dictionaryDecoderSuite,
@@ -0,0 +1,160 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the Soto for AWS open source project
+//
+// Copyright (c) 2017-2020 the Soto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.txt for the list of Soto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import NIO
+import SotoTestUtils
+
+/// Generates the responses replayed by the test server. The contents are deterministic and modelled on real service
+/// responses, so they exercise the same parsing and decoding paths: entity escaped strings, timestamps, nested lists etc.
+enum Corpus {
+    static let allocator = ByteBufferAllocator()
+
+    /// S3 ListObjectsV2 response
+    /// - Parameters:
+    ///   - keys: Range of object indices to include
+    ///   - nextContinuationToken: Continuation token for next page, nil if this is the last page
+    static func s3ListObjectsV2(keys: Range<Int>, nextContinuationToken: String?) -> ByteBuffer {
+        var buffer = self.allocator.buffer(capacity: keys.count * 400 + 512)
+        buffer.writeString("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n")
+        buffer.writeString("<ListBucketResult xmlns=\"http://s3.amazonaws.com/doc/2006-03-01/\">")
+        buffer.writeString("<Name>soto-benchmark</Name><Prefix></Prefix><KeyCount>\(keys.count)</KeyCount><MaxKeys>\(keys.count)</MaxKeys>")
+        if let nextContinuationToken = nextContinuationToken {
+            buffer.writeString("<IsTruncated>true</IsTruncated><NextContinuationToken>\(nextContinuationToken)</NextContinuationToken>")
+        } else {
+            buffer.writeString("<IsTruncated>false</IsTruncated>")
+        }
+        for index in keys {
+            buffer.writeString("<Contents>")
+            buffer.writeString("<Key>photos/\(2000 + index % 21)/\(index % 12 + 1)/image-\(self.padded(index, width: 8)).jpg</Key>")
+            buffer.writeString("<LastModified>2020-\(self.padded(index % 12 + 1, width: 2))-\(self.padded(index % 28 + 1, width: 2))T12:34:56.000Z</LastModified>")
+            buffer.writeString("<ETag>&quot;\(self.hex(index, length: 32))&quot;</ETag>")
+            buffer.writeString("<Size>\(index * 7919 % 10_000_000)</Size>")
+            buffer.writeString("<Owner><ID>\(self.hex(42, length: 64))</ID><DisplayName>soto-benchmark</DisplayName></Owner>")
+            buffer.writeString("<StorageClass>STANDARD</StorageClass>")
+            buffer.writeString("</Contents>")
+        }
+        buffer.writeString("</ListBucketResult>")
+        return buffer
+    }
+
+    /// EC2 DescribeInstances response
+    /// - Parameters:
+    ///   - reservations: Number of reservations
+    ///   - instancesPerReservation: Number of instances in each reservation
+    static func ec2DescribeInstances(reservations: Int, instancesPerReservation: Int) -> ByteBuffer {
+        var buffer = self.allocator.buffer(capacity: reservations * instancesPerReservation * 1200 + 512)
+        buffer.writeString("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n")
+        buffer.writeString("<DescribeInstancesResponse xmlns=\"http://ec2.amazonaws.com/doc/2016-11-15/\">")
+        buffer.writeString("<requestId>8f7724cf-496f-496e-8fe3-example</requestId><reservationSet>")
+        for reservation in 0..<reservations {
+            buffer.writeString("<item><reservationId>r-\(self.hex(reservation, length: 17))</reservationId><ownerId>123456789012</ownerId>")
+            buffer.writeString("<groupSet/><instancesSet>")
+            for instance in 0..<instancesPerReservation {
+                let index = reservation * instancesPerReservation + instance
+                let ipAddress = (10, index / 65536 % 256, index / 256 % 256, index % 256)
+                buffer.writeString("<item>")
+                buffer.writeString("<instanceId>i-\(self.hex(index, length: 17))</instanceId><imageId>ami-\(self.hex(index % 16, length: 17))</imageId>")
+                buffer.writeString("<instanceState><code>16</code><name>running</name></instanceState>")
+                buffer.writeString("<privateDnsName>ip-\(ipAddress.0)-\(ipAddress.1)-\(ipAddress.2)-\(ipAddress.3).ec2.internal</privateDnsName><dnsName/>")
+                buffer.writeString("<reason/><keyName>soto-benchmark</keyName><amiLaunchIndex>\(instance)</amiLaunchIndex>")
+                buffer.writeString("<instanceType>m5.large</instanceType><launchTime>2020-10-14T12:34:56.000Z</launchTime>")
+                buffer.writeString("<placement><availabilityZone>us-east-1\(["a", "b", "c"][index % 3])</availabilityZone><groupName/><tenancy>default</tenancy></placement>")
+                buffer.writeString("<monitoring><state>disabled</state></monitoring>")
+                buffer.writeString("<subnetId>subnet-\(self.hex(index % 6, length: 17))</subnetId><vpcId>vpc-\(self.hex(1, length: 17))</vpcId>")
+                buffer.writeString("<privateIpAddress>\(ipAddress.0).\(ipAddress.1).\(ipAddress.2).\(ipAddress.3)</privateIpAddress>")
+                buffer.writeString("<groupSet><item><groupId>sg-\(self.hex(index % 4, length: 17))</groupId><groupName>default</groupName></item></groupSet>")
+                buffer.writeString("<architecture>x86_64</architecture><rootDeviceType>ebs</rootDeviceType><rootDeviceName>/dev/xvda</rootDeviceName>")
+                buffer.writeString("<tagSet>")
+                buffer.writeString("<item><key>Name</key><value>worker-\(index)</value></item>")
+                buffer.writeString("<item><key>Environment</key><value>benchmark &amp; test</value></item>")
+                buffer.writeString("<item><key>Team</key><value>soto</value></item>")
+                buffer.writeString("</tagSet>")
+                buffer.writeString("</item>")
+            }
+            buffer.writeString("</instancesSet></item>")
+        }
+        buffer.writeString("</reservationSet></DescribeInstancesResponse>")
+        return buffer
+    }
+
+    /// DynamoDB Scan response
+    /// - Parameters:
+    ///   - items: Range of item indices to include
+    ///   - lastEvaluatedKey: Include a LastEvaluatedKey for the last item
+    static func dynamoDBScan(items: Range<Int>, lastEvaluatedKey: Bool) -> ByteBuffer {
+        var buffer = self.allocator.buffer(capacity: items.count * 320 + 256)
+        buffer.writeString("{\"Count\":\(items.count),\"ScannedCount\":\(items.count),\"Items\":[")
+        for index in items {
+            if index != items.lowerBound {
+                buffer.writeString(",")
+            }
+            self.writeDynamoDBItem(index: index, to: &buffer)
+        }
+        buffer.writeString("]")
+        if lastEvaluatedKey, let last = items.last {
+            buffer.writeString(",\"LastEvaluatedKey\":{\"pk\":{\"S\":\"user#\(self.padded(last / 10, width: 8))\"},\"sk\":{\"S\":\"order#\(self.padded(last, width: 10))\"}}")
+        }
+        buffer.writeString("}")
+        return buffer
+    }
+
+    /// DynamoDB GetItem response
+    static func dynamoDBGetItem(index: Int) -> ByteBuffer {
+        var buffer = self.allocator.buffer(capacity: 512)
+        buffer.writeString("{\"Item\":")
+        self.writeDynamoDBItem(index: index, to: &buffer)
+        buffer.writeString("}")
+        return buffer
+    }
+
+    /// write DynamoDB item in JSON
+    static func writeDynamoDBItem(index: Int, to buffer: inout ByteBuffer) {
+        buffer.writeString("{\"pk\":{\"S\":\"user#\(self.padded(index / 10, width: 8))\"}")
+        buffer.writeString(",\"sk\":{\"S\":\"order#\(self.padded(index, width: 10))\"}")
+        buffer.writeString(",\"amount\":{\"N\":\"\(index % 1000).\(self.padded(index % 100, width: 2))\"}")
+        buffer.writeString(",\"shipped\":{\"BOOL\":\(index % 2 == 0 ? "true" : "false")}")
+        buffer.writeString(",\"items\":{\"L\":[{\"S\":\"sku-\(index % 97)\"},{\"S\":\"sku-\(index % 89)\"}]}")
+        buffer.writeString(",\"address\":{\"M\":{\"city\":{\"S\":\"Edinburgh\"},\"postcode\":{\"S\":\"EH\(index % 17) \(index % 9)AB\"}}}")
+        buffer.writeString(",\"note\":{\"S\":\"Leave with \\\"neighbour\\\" if out \\u00e9\"}}")
+    }
+
+    /// Block of random bytes that upload payloads are made from
+    static func uploadBlock(size: Int) -> ByteBuffer {
+        let bytes = createRandomBuffer(23, 4129, size: size)
+        var buffer = self.allocator.buffer(capacity: size)
+        buffer.writeBytes(bytes)
+        return buffer
+    }
+
+    /// integer padded with zeros
+    static func padded(_ value: Int, width: Int) -> String {
+        let string = String(value)
+        return String(repeating: "0", count: max(0, width - string.count)) + string
+    }
+
+    /// hexadecimal string of fixed length generated from value
+    static func hex(_ value: Int, length: Int) -> String {
+        var hash = UInt64(truncatingIfNeeded: value) &+ 0x9E37_79B9_7F4A_7C15
+        var string = ""
+        string.reserveCapacity(length)
+        while string.count < length {
+            // splitmix64 step to spread the bits
+            hash = (hash ^ (hash >> 30)) &* 0xBF58_476D_1CE4_E5B9
+            hash = (hash ^ (hash >> 27)) &* 0x94D0_49BB_1331_11EB
+            hash ^= hash >> 31
+            string += String(hash, radix: 16)
+        }
+        return String(string.prefix(length))
+    }
+}
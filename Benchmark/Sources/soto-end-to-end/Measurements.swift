@@ -0,0 +1,88 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the Soto for AWS open source project
+//
+// Copyright (c) 2017-2020 the Soto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.txt for the list of Soto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import CAllocationCounter
+import Dispatch
+import Foundation
+#if canImport(Glibc)
+import Glibc
+#elseif canImport(Darwin)
+import Darwin
+#endif
+
+/// Process wide heap allocation counts. These are only available when the C allocation functions can be replaced, which
+/// is on platforms using glibc
+enum AllocationCounter {
+    struct Counts {
+        let allocations: Int
+        let frees: Int
+        let bytes: Int
+
+        static func - (lhs: Counts, rhs: Counts) -> Counts {
+            return Counts(allocations: lhs.allocations - rhs.allocations, frees: lhs.frees - rhs.frees, bytes: lhs.bytes - rhs.bytes)
+        }
+    }
+
+    /// are allocations being counted
+    static var isEnabled: Bool {
+        return Soto_AllocationCounterIsEnabled() != 0
+    }
+
+    /// current allocation counts, or nil if allocations aren't being counted
+    static func snapshot() -> Counts? {
+        guard self.isEnabled else { return nil }
+        let counts = Soto_AllocationCounterSnapshot()
+        return Counts(allocations: Int(counts.allocations), frees: Int(counts.frees), bytes: Int(counts.bytes))
+    }
+}
+
+/// Peak resident set size of the process
+enum ResidentMemory {
+    /// Reset the peak resident set size to the current resident set size, so the next call to `peak()` only covers what
+    /// happens between the two calls. This is only possible on Linux, returns false if the peak couldn't be reset
+    static func resetPeak() -> Bool {
+        #if os(Linux)
+        // writing 5 to clear_refs resets VmHWM in /proc/self/status
+        let fd = open("/proc/self/clear_refs", O_WRONLY)
+        guard fd >= 0 else { return false }
+        defer { close(fd) }
+        return write(fd, "5", 1) == 1
+        #else
+        return false
+        #endif
+    }
+
+    /// Peak resident set size in bytes, since process start or the last successful call to `resetPeak()`
+    static func peak() -> Int? {
+        #if os(Linux)
+        guard let status = try? String(contentsOfFile: "/proc/self/status", encoding: .utf8),
+              let line = status.split(separator: "\n").first(where: { $0.hasPrefix("VmHWM:") }),
+              let kilobytes = line.split(whereSeparator: { $0 == " " || $0 == "\t" }).dropFirst().first.flatMap({ Int($0) })
+        else {
+            return nil
+        }
+        return kilobytes * 1024
+        #else
+        var usage = rusage()
+        guard getrusage(RUSAGE_SELF, &usage) == 0 else { return nil }
+        // Darwin reports ru_maxrss in bytes
+        return Int(usage.ru_maxrss)
+        #endif
+    }
+}
+
+/// Monotonic clock in nanoseconds
+func monotonicNanoseconds() -> UInt64 {
+    return DispatchTime.now().uptimeNanoseconds
+}
@@ -0,0 +1,199 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the Soto for AWS open source project
+//
+// Copyright (c) 2017-2020 the Soto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.txt for the list of Soto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Dispatch
+import Foundation
+import NIO
+import SotoCore
+import SotoTestUtils
+
+/// End to end benchmark scenario. Each iteration makes one or more requests through an `AWSClient` to an
+/// `AWSTestServer` that replays canned responses from the corpus.
+struct Scenario {
+    /// name used to select scenario and in report
+    let name: String
+    /// protocol of test server
+    let serverProtocol: AWSTestServer.ServiceProtocol
+    /// number of requests the server receives each iteration
+    let requestsPerIteration: Int
+    /// bytes sent and received in request and response bodies each iteration, used to calculate throughput
+    let bytesPerIteration: Int
+    /// iterations to run if not set on the command line
+    let defaultIterations: Int
+    /// credentials used to sign requests
+    let credentialProvider: CredentialProviderFactory
+    /// client options
+    let options: AWSClient.Options
+    /// create service config for test server endpoint
+    let serviceConfig: (_ endpoint: String) -> AWSServiceConfig
+    /// response the server sends to a request
+    let respond: (AWSTestServer.Request) -> AWSTestServer.Response
+    /// run one iteration
+    let iteration: (AWSClient, AWSServiceConfig) -> EventLoopFuture<Void>
+
+    init(
+        name: String,
+        serverProtocol: AWSTestServer.ServiceProtocol,
+        requestsPerIteration: Int = 1,
+        bytesPerIteration: Int,
+        defaultIterations: Int,
+        credentialProvider: CredentialProviderFactory = .static(accessKeyId: "foo", secretAccessKey: "bar"),
+        options: AWSClient.Options = .init(),
+        serviceConfig: @escaping (_ endpoint: String) -> AWSServiceConfig,
+        respond: @escaping (AWSTestServer.Request) -> AWSTestServer.Response,
+        iteration: @escaping (AWSClient, AWSServiceConfig) -> EventLoopFuture<Void>
+    ) {
+        self.name = name
+        self.serverProtocol = serverProtocol
+        self.requestsPerIteration = requestsPerIteration
+        self.bytesPerIteration = bytesPerIteration
+        self.defaultIterations = defaultIterations
+        self.credentialProvider = credentialProvider
+        self.options = options
+        self.serviceConfig = serviceConfig
+        self.respond = respond
+        self.iteration = iteration
+    }
+}
+
+/// Measurements from running a scenario
+struct ScenarioResult: Codable {
+    struct Latency: Codable {
+        let min: Double
+        let mean: Double
+        let p50: Double
+        let p99: Double
+        let max: Double
+
+        /// Calculate statistics from iteration times in nanoseconds. Values are in milliseconds
+        init(nanoseconds: [UInt64]) {
+            precondition(nanoseconds.count > 0, "Require at least one measurement")
+            let sorted = nanoseconds.sorted()
+            func milliseconds(_ value: UInt64) -> Double { Double(value) / 1_000_000 }
+            /// nearest rank percentile
+            func percentile(_ p: Double) -> Double {
+                let rank = Int((p * Double(sorted.count)).rounded(.up))
+                return milliseconds(sorted[Swift.max(0, Swift.min(rank - 1, sorted.count - 1))])
+            }
+            self.min = milliseconds(sorted[0])
+            self.mean = milliseconds(sorted.reduce(0, +)) / Double(sorted.count)
+            self.p50 = percentile(0.5)
+            self.p99 = percentile(0.99)
+            self.max = milliseconds(sorted[sorted.count - 1])
+        }
+    }
+
+    let name: String
+    let iterations: Int
+    let requestsPerIteration: Int
+    let bytesPerIteration: Int
+    /// time taken by each iteration, in milliseconds
+    let latency: Latency
+    let requestsPerSecond: Double
+    let bytesPerSecond: Double
+    /// heap allocations per iteration, nil if allocations aren't counted on this platform
+    let allocationsPerIteration: Double?
+    /// bytes allocated on the heap per iteration, nil if allocations aren't counted on this platform
+    let allocatedBytesPerIteration: Double?
+    /// peak resident set size while the scenario was running
+    let peakResidentBytes: Int?
+    /// false if the peak resident set size couldn't be reset before the scenario, so it also covers everything run
+    /// before it in this process
+    let peakResidentReset: Bool
+}
+
+/// Runs scenarios against an `AWSTestServer`
+struct ScenarioRunner {
+    enum Error: Swift.Error {
+        case serverFailed(Swift.Error)
+    }
+
+    /// iterations to run, overrides the scenario default
+    let iterations: Int?
+    /// iterations to run before measuring
+    let warmupIterations: Int
+
+    /// Run scenario. Allocation counts include those made by the test server, as it runs in the same process.
+    func run(_ scenario: Scenario) throws -> ScenarioResult {
+        let iterations = self.iterations ?? scenario.defaultIterations
+        let server = AWSTestServer(serviceProtocol: scenario.serverProtocol)
+        let client = AWSClient(
+            credentialProvider: scenario.credentialProvider,
+            retryPolicy: .noRetry,
+            options: scenario.options,
+            httpClientProvider: .createNew
+        )
+        let serviceConfig = scenario.serviceConfig(server.address)
+        defer {
+            try? server.stop()
+            try? client.syncShutdown()
+        }
+
+        // replay responses on a background thread until all the requests have been received
+        let totalRequests = (iterations + self.warmupIterations) * scenario.requestsPerIteration
+        let serverFinished = DispatchGroup()
+        var serverError: Swift.Error?
+        serverFinished.enter()
+        DispatchQueue.global().async {
+            defer { serverFinished.leave() }
+            var requestCount = 0
+            do {
+                try server.processRaw { request in
+                    requestCount += 1
+                    return .result(scenario.respond(request), continueProcessing: requestCount < totalRequests)
+                }
+            } catch {
+                serverError = error
+            }
+        }
+
+        for _ in 0..<self.warmupIterations {
+            try scenario.iteration(client, serviceConfig).wait()
+        }
+
+        let peakReset = ResidentMemory.resetPeak()
+        var times: [UInt64] = []
+        times.reserveCapacity(iterations)
+        let startAllocations = AllocationCounter.snapshot()
+        let start = monotonicNanoseconds()
+        for _ in 0..<iterations {
+            let iterationStart = monotonicNanoseconds()
+            try scenario.iteration(client, serviceConfig).wait()
+            times.append(monotonicNanoseconds() - iterationStart)
+        }
+        let totalSeconds = Double(monotonicNanoseconds() - start) / 1_000_000_000
+        let endAllocations = AllocationCounter.snapshot()
+        let peakResidentBytes = ResidentMemory.peak()
+
+        serverFinished.wait()
+        if let serverError = serverError {
+            throw Error.serverFailed(serverError)
+        }
+
+        let allocations = endAllocations.flatMap { end in startAllocations.map { end - $0 } }
+        return ScenarioResult(
+            name: scenario.name,
+            iterations: iterations,
+            requestsPerIteration: scenario.requestsPerIteration,
+            bytesPerIteration: scenario.bytesPerIteration,
+            latency: .init(nanoseconds: times),
+            requestsPerSecond: Double(iterations * scenario.requestsPerIteration) / totalSeconds,
+            bytesPerSecond: Double(iterations * scenario.bytesPerIteration) / totalSeconds,
+            allocationsPerIteration: allocations.map { Double($0.allocations) / Double(iterations) },
+            allocatedBytesPerIteration: allocations.map { Double($0.bytes) / Double(iterations) },
+            peakResidentBytes: peakResidentBytes,
+            peakResidentReset: peakReset
+        )
+    }
+}
@@ -0,0 +1,218 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the Soto for AWS open source project
+//
+// Copyright (c) 2017-2020 the Soto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.txt for the list of Soto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Foundation
+import Logging
+import NIO
+import NIOConcurrencyHelpers
+import SotoCore
+import SotoTestUtils
+
+extension Scenario {
+    static let xmlHeaders = ["Content-Type": "application/xml"]
+    static let jsonHeaders = ["Content-Type": "application/x-amz-json-1.0"]
+
+    static func s3ServiceConfig(endpoint: String) -> AWSServiceConfig {
+        return AWSServiceConfig(
+            region: .useast1, partition: .aws, service: "s3", serviceProtocol: .restxml, apiVersion: "2006-03-01", endpoint: endpoint
+        )
+    }
+
+    static func dynamoDBServiceConfig(endpoint: String) -> AWSServiceConfig {
+        return AWSServiceConfig(
+            region: .useast1,
+            partition: .aws,
+            amzTarget: "DynamoDB_20120810",
+            service: "dynamodb",
+            serviceProtocol: .json(version: "1.0"),
+            apiVersion: "2012-08-10",
+            endpoint: endpoint
+        )
+    }
+
+    /// Decode one S3 ListObjectsV2 response with 10000 keys
+    static func s3ListObjects() -> Scenario {
+        let body = Corpus.s3ListObjectsV2(keys: 0..<10000, nextContinuationToken: nil)
+        return Scenario(
+            name: "s3-list-objects-10k",
+            serverProtocol: .xml,
+            bytesPerIteration: body.readableBytes,
+            defaultIterations: 20,
+            serviceConfig: Self.s3ServiceConfig,
+            respond: { _ in .init(httpStatus: .ok, headers: Self.xmlHeaders, body: body) },
+            iteration: { client, config in
+                let input = S3.ListObjectsV2Request(bucket: "soto-benchmark", continuationToken: nil, maxKeys: 10000)
+                let output: EventLoopFuture<S3.ListObjectsV2Output> = client.execute(
+                    operation: "ListObjectsV2", path: "/{Bucket}?list-type=2", httpMethod: .GET, serviceConfig: config, input: input
+                )
+                return output.map { _ in }
+            }
+        )
+    }
+
+    /// Paginate through an S3 bucket listing of 10 pages of 1000 keys
+    static func s3ListObjectsPaginated() -> Scenario {
+        let pageCount = 10
+        let pages = (0..<pageCount).map { page in
+            Corpus.s3ListObjectsV2(
+                keys: page * 1000..<(page + 1) * 1000,
+                nextContinuationToken: page + 1 < pageCount ? "page-\(page + 1)" : nil
+            )
+        }
+        return Scenario(
+            name: "s3-list-objects-paginated",
+            serverProtocol: .xml,
+            requestsPerIteration: pageCount,
+            bytesPerIteration: pages.reduce(0) { $0 + $1.readableBytes },
+            defaultIterations: 20,
+            serviceConfig: Self.s3ServiceConfig,
+            respond: { request in
+                let token = URLComponents(string: request.uri)?.queryItems?.first { $0.name == "continuation-token" }?.value
+                let page = token.flatMap { Int($0.dropFirst("page-".count)) } ?? 0
+                return .init(httpStatus: .ok, headers: Self.xmlHeaders, body: pages[page])
+            },
+            iteration: { client, config in
+                return client.paginate(
+                    input: S3.ListObjectsV2Request(bucket: "soto-benchmark", continuationToken: nil, maxKeys: 1000),
+                    command: { (input: S3.ListObjectsV2Request, logger: Logger, eventLoop: EventLoop?) -> EventLoopFuture<S3.ListObjectsV2Output> in
+                        client.execute(
+                            operation: "ListObjectsV2",
+                            path: "/{Bucket}?list-type=2",
+                            httpMethod: .GET,
+                            serviceConfig: config,
+                            input: input,
+                            logger: logger,
+                            on: eventLoop
+                        )
+                    },
+                    tokenKey: \S3.ListObjectsV2Output.nextContinuationToken,
+                    onPage: { _, eventLoop in eventLoop.makeSucceededFuture(true) }
+                )
+            }
+        )
+    }
+
+    /// Decode one EC2 DescribeInstances response with 2000 instances
+    static func ec2DescribeInstances() -> Scenario {
+        let body = Corpus.ec2DescribeInstances(reservations: 1000, instancesPerReservation: 2)
+        return Scenario(
+            name: "ec2-describe-instances-2k",
+            serverProtocol: .xml,
+            bytesPerIteration: body.readableBytes,
+            defaultIterations: 20,
+            serviceConfig: { endpoint in
+                AWSServiceConfig(region: .useast1, partition: .aws, service: "ec2", serviceProtocol: .ec2, apiVersion: "2016-11-15", endpoint: endpoint)
+            },
+            respond: { _ in .init(httpStatus: .ok, headers: Self.xmlHeaders, body: body) },
+            iteration: { client, config in
+                let output: EventLoopFuture<EC2.DescribeInstancesResult> = client.execute(
+                    operation: "DescribeInstances", path: "/", httpMethod: .POST, serviceConfig: config
+                )
+                return output.map { _ in }
+            }
+        )
+    }
+
+    /// Paginate through a DynamoDB scan of 4 pages of 3000 items. Each page is about 1MB, the most DynamoDB returns
+    static func dynamoDBScan() -> Scenario {
+        let pageCount = 4
+        let pageSize = 3000
+        let pages = (0..<pageCount).map { page in
+            Corpus.dynamoDBScan(items: page * pageSize..<(page + 1) * pageSize, lastEvaluatedKey: page + 1 < pageCount)
+        }
+        // requests are sent one after the other, so the pages are replayed in order
+        let requestCount = NIOAtomic<Int>.makeAtomic(value: 0)
+        return Scenario(
+            name: "dynamodb-scan-paginated",
+            serverProtocol: .json,
+            requestsPerIteration: pageCount,
+            bytesPerIteration: pages.reduce(0) { $0 + $1.readableBytes },
+            defaultIterations: 20,
+            serviceConfig: Self.dynamoDBServiceConfig,
+            respond: { _ in
+                let page = requestCount.add(1) % pageCount
+                return .init(httpStatus: .ok, headers: Self.jsonHeaders, body: pages[page])
+            },
+            iteration: { client, config in
+                return client.paginate(
+                    input: DynamoDB.ScanInput(exclusiveStartKey: nil, tableName: "soto-benchmark"),
+                    command: { (input: DynamoDB.ScanInput, logger: Logger, eventLoop: EventLoop?) -> EventLoopFuture<DynamoDB.ScanOutput> in
+                        client.execute(operation: "Scan", path: "/", httpMethod: .POST, serviceConfig: config, input: input, logger: logger, on: eventLoop)
+                    },
+                    tokenKey: \DynamoDB.ScanOutput.lastEvaluatedKey,
+                    onPage: { _, eventLoop in eventLoop.makeSucceededFuture(true) }
+                )
+            }
+        )
+    }
+
+    /// Send 64 concurrent DynamoDB GetItem requests. `AWSTestServer` serves one connection at a time, so responses close
+    /// the connection to let the server move on to the next one
+    static func dynamoDBGetItemConcurrent() -> Scenario {
+        let concurrency = 64
+        let body = Corpus.dynamoDBGetItem(index: 12345)
+        return Scenario(
+            name: "dynamodb-get-item-concurrent-64",
+            serverProtocol: .json,
+            requestsPerIteration: concurrency,
+            bytesPerIteration: body.readableBytes * concurrency,
+            defaultIterations: 20,
+            serviceConfig: Self.dynamoDBServiceConfig,
+            respond: { _ in
+                var headers = Self.jsonHeaders
+                headers["Connection"] = "close"
+                return .init(httpStatus: .ok, headers: headers, body: body)
+            },
+            iteration: { client, config in
+                let eventLoop = client.eventLoopGroup.next()
+                let responses = (0..<concurrency).map { index -> EventLoopFuture<DynamoDB.GetItemOutput> in
+                    let input = DynamoDB.GetItemInput(
+                        key: ["pk": .init(s: "user#\(index)"), "sk": .init(s: "order#\(index)")],
+                        tableName: "soto-benchmark"
+                    )
+                    return client.execute(operation: "GetItem", path: "/", httpMethod: .POST, serviceConfig: config, input: input)
+                }
+                return EventLoopFuture.andAllSucceed(responses, on: eventLoop)
+            }
+        )
+    }
+
+    /// Upload an object to S3 using aws-chunked content encoding, where each 64K chunk of the body is signed.
+    /// - Parameter size: Size of object in bytes
+    static func s3ChunkedUpload(size: Int) -> Scenario {
+        let readSize = 64 * 1024
+        // the upload body repeats this block, so the benchmark doesn't need to hold the whole body in memory
+        let block = Corpus.uploadBlock(size: 1024 * 1024)
+        return Scenario(
+            name: "s3-chunked-upload",
+            serverProtocol: .xml,
+            bytesPerIteration: size,
+            defaultIterations: 5,
+            serviceConfig: Self.s3ServiceConfig,
+            respond: { _ in .init(httpStatus: .ok, headers: ["ETag": "\"\(Corpus.hex(size, length: 32))\""]) },
+            iteration: { client, config in
+                var offset = 0
+                let payload = AWSPayload.stream(size: size) { eventLoop in
+                    let position = offset % block.readableBytes
+                    let length = min(readSize, size - offset, block.readableBytes - position)
+                    guard length > 0 else { return eventLoop.makeSucceededFuture(.end) }
+                    offset += length
+                    return eventLoop.makeSucceededFuture(.byteBuffer(block.getSlice(at: block.readerIndex + position, length: length)!))
+                }
+                let input = S3.PutObjectRequest(body: payload, bucket: "soto-benchmark", key: "uploads/object.bin")
+                return client.execute(operation: "PutObject", path: "/{Bucket}/{Key+}", httpMethod: .PUT, serviceConfig: config, input: input)
+            }
+        )
+    }
+}
@@ -0,0 +1,260 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the Soto for AWS open source project
+//
+// Copyright (c) 2017-2020 the Soto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.txt for the list of Soto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Foundation
+import SotoCore
+
+// Cut down versions of the service shapes generated by Soto, covering the parts of the responses in the corpus
+
+enum S3 {
+    struct ListObjectsV2Request: AWSEncodableShape, AWSPaginateToken {
+        static let _encoding = [
+            AWSMemberEncoding(label: "bucket", location: .uri(locationName: "Bucket")),
+            AWSMemberEncoding(label: "continuationToken", location: .querystring(locationName: "continuation-token")),
+            AWSMemberEncoding(label: "maxKeys", location: .querystring(locationName: "max-keys")),
+        ]
+
+        let bucket: String
+        let continuationToken: String?
+        let maxKeys: Int?
+
+        func usingPaginationToken(_ token: String) -> ListObjectsV2Request {
+            return .init(bucket: self.bucket, continuationToken: token, maxKeys: self.maxKeys)
+        }
+
+        private enum CodingKeys: CodingKey {}
+    }
+
+    struct ListObjectsV2Output: AWSDecodableShape {
+        let contents: [Object]?
+        let isTruncated: Bool?
+        let keyCount: Int?
+        let name: String?
+        let nextContinuationToken: String?
+
+        private enum CodingKeys: String, CodingKey {
+            case contents = "Contents"
+            case isTruncated = "IsTruncated"
+            case keyCount = "KeyCount"
+            case name = "Name"
+            case nextContinuationToken = "NextContinuationToken"
+        }
+    }
+
+    struct Object: AWSDecodableShape {
+        let eTag: String?
+        let key: String?
+        @OptionalCustomCoding<ISO8601DateCoder>
+        var lastModified: Date?
+        let owner: Owner?
+        let size: Int64?
+        let storageClass: String?
+
+        private enum CodingKeys: String, CodingKey {
+            case eTag = "ETag"
+            case key = "Key"
+            case lastModified = "LastModified"
+            case owner = "Owner"
+            case size = "Size"
+            case storageClass = "StorageClass"
+        }
+    }
+
+    struct Owner: AWSDecodableShape {
+        let displayName: String?
+        let id: String?
+
+        private enum CodingKeys: String, CodingKey {
+            case displayName = "DisplayName"
+            case id = "ID"
+        }
+    }
+
+    struct PutObjectRequest: AWSEncodableShape & AWSShapeWithPayload {
+        static let _payloadPath: String = "body"
+        static let _payloadOptions: AWSShapePayloadOptions = [.raw, .allowStreaming, .allowChunkedStreaming]
+        static let _encoding = [
+            AWSMemberEncoding(label: "body", location: .body(locationName: "Body")),
+            AWSMemberEncoding(label: "bucket", location: .uri(locationName: "Bucket")),
+            AWSMemberEncoding(label: "key", location: .uri(locationName: "Key")),
+        ]
+
+        let body: AWSPayload?
+        let bucket: String
+        let key: String
+
+        private enum CodingKeys: String, CodingKey {
+            case body = "Body"
+        }
+    }
+}
+
+enum EC2 {
+    struct _ItemEncoding: ArrayCoderProperties { static let member = "item" }
+
+    struct DescribeInstancesResult: AWSDecodableShape {
+        let nextToken: String?
+        @OptionalCustomCoding<ArrayCoder<_ItemEncoding, Reservation>>
+        var reservations: [Reservation]?
+
+        private enum CodingKeys: String, CodingKey {
+            case nextToken
+            case reservations = "reservationSet"
+        }
+    }
+
+    struct Reservation: AWSDecodableShape {
+        @OptionalCustomCoding<ArrayCoder<_ItemEncoding, Instance>>
+        var instances: [Instance]?
+        let ownerId: String?
+        let reservationId: String?
+
+        private enum CodingKeys: String, CodingKey {
+            case instances = "instancesSet"
+            case ownerId
+            case reservationId
+        }
+    }
+
+    struct Instance: AWSDecodableShape {
+        let amiLaunchIndex: Int?
+        let architecture: String?
+        let imageId: String?
+        let instanceId: String?
+        let instanceType: String?
+        let keyName: String?
+        @OptionalCustomCoding<ISO8601DateCoder>
+        var launchTime: Date?
+        let placement: Placement?
+        let privateDnsName: String?
+        let privateIpAddress: String?
+        @OptionalCustomCoding<ArrayCoder<_ItemEncoding, GroupIdentifier>>
+        var securityGroups: [GroupIdentifier]?
+        let state: InstanceState?
+        let subnetId: String?
+        @OptionalCustomCoding<ArrayCoder<_ItemEncoding, Tag>>
+        var tags: [Tag]?
+        let vpcId: String?
+
+        private enum CodingKeys: String, CodingKey {
+            case amiLaunchIndex
+            case architecture
+            case imageId
+            case instanceId
+            case instanceType
+            case keyName
+            case launchTime
+            case placement
+            case privateDnsName
+            case privateIpAddress
+            case securityGroups = "groupSet"
+            case state = "instanceState"
+            case subnetId
+            case tags = "tagSet"
+            case vpcId
+        }
+    }
+
+    struct InstanceState: AWSDecodableShape {
+        let code: Int?
+        let name: String?
+    }
+
+    struct Placement: AWSDecodableShape {
+        let availabilityZone: String?
+        let tenancy: String?
+    }
+
+    struct GroupIdentifier: AWSDecodableShape {
+        let groupId: String?
+        let groupName: String?
+    }
+
+    struct Tag: AWSDecodableShape {
+        let key: String?
+        let value: String?
+    }
+}
+
+enum DynamoDB {
+    struct AttributeValue: AWSEncodableShape & AWSDecodableShape {
+        let bool: Bool?
+        let l: [AttributeValue]?
+        let m: [String: AttributeValue]?
+        let n: String?
+        let s: String?
+
+        init(bool: Bool? = nil, l: [AttributeValue]? = nil, m: [String: AttributeValue]? = nil, n: String? = nil, s: String? = nil) {
+            self.bool = bool
+            self.l = l
+            self.m = m
+            self.n = n
+            self.s = s
+        }
+
+        private enum CodingKeys: String, CodingKey {
+            case bool = "BOOL"
+            case l = "L"
+            case m = "M"
+            case n = "N"
+            case s = "S"
+        }
+    }
+
+    struct ScanInput: AWSEncodableShape, AWSPaginateToken {
+        let exclusiveStartKey: [String: AttributeValue]?
+        let tableName: String
+
+        func usingPaginationToken(_ token: [String: AttributeValue]) -> ScanInput {
+            return .init(exclusiveStartKey: token, tableName: self.tableName)
+        }
+
+        private enum CodingKeys: String, CodingKey {
+            case exclusiveStartKey = "ExclusiveStartKey"
+            case tableName = "TableName"
+        }
+    }
+
+    struct ScanOutput: AWSDecodableShape {
+        let count: Int?
+        let items: [[String: AttributeValue]]?
+        let lastEvaluatedKey: [String: AttributeValue]?
+        let scannedCount: Int?
+
+        private enum CodingKeys: String, CodingKey {
+            case count = "Count"
+            case items = "Items"
+            case lastEvaluatedKey = "LastEvaluatedKey"
+            case scannedCount = "ScannedCount"
+        }
+    }
+
+    struct GetItemInput: AWSEncodableShape {
+        let key: [String: AttributeValue]
+        let tableName: String
+
+        private enum CodingKeys: String, CodingKey {
+            case key = "Key"
+            case tableName = "TableName"
+        }
+    }
+
+    struct GetItemOutput: AWSDecodableShape {
+        let item: [String: AttributeValue]?
+
+        private enum CodingKeys: String, CodingKey {
+            case item = "Item"
+        }
+    }
+}
@@ -0,0 +1,139 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the Soto for AWS open source project
+//
+// Copyright (c) 2017-2020 the Soto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.txt for the list of Soto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Foundation
+
+/// Report of all the scenarios run
+struct Report: Codable {
+    /// were heap allocations counted
+    let allocationCounting: Bool
+    let warmupIterations: Int
+    let scenarios: [ScenarioResult]
+}
+
+struct Options {
+    enum Format: String {
+        case text
+        case json
+    }
+
+    /// only run scenarios whose name contains this
+    var filter: String?
+    var iterations: Int?
+    var warmupIterations = 2
+    var uploadSize = 100 * 1024 * 1024
+    var format = Format.text
+    /// file to write report to, stdout if nil
+    var output: String?
+
+    static let usage = """
+    USAGE: soto-end-to-end [--filter <name>] [--iterations <count>] [--warmup <count>] [--upload-size <megabytes>]
+                           [--format text|json] [--output <path>]
+    """
+
+    init(arguments: [String]) {
+        var arguments = arguments[...]
+        func value(for option: String) -> String {
+            guard let argument = arguments.popFirst() else { Self.exit(withError: "Missing value for \(option)") }
+            return argument
+        }
+        func intValue(for option: String) -> Int {
+            guard let number = Int(value(for: option)), number >= 0 else { Self.exit(withError: "Invalid value for \(option)") }
+            return number
+        }
+        while let argument = arguments.popFirst() {
+            switch argument {
+            case "--filter":
+                self.filter = value(for: argument)
+            case "--iterations":
+                self.iterations = intValue(for: argument)
+            case "--warmup":
+                self.warmupIterations = intValue(for: argument)
+            case "--upload-size":
+                self.uploadSize = intValue(for: argument) * 1024 * 1024
+            case "--format":
+                guard let format = Format(rawValue: value(for: argument)) else { Self.exit(withError: "Invalid value for \(argument)") }
+                self.format = format
+            case "--output":
+                self.output = value(for: argument)
+            case "--help", "-h":
+                print(Self.usage)
+                Foundation.exit(0)
+            default:
+                Self.exit(withError: "Unknown option \(argument)")
+            }
+        }
+        if self.iterations == 0 {
+            Self.exit(withError: "Need at least one iteration")
+        }
+    }
+
+    static func exit(withError message: String) -> Never {
+        FileHandle.standardError.write("\(message)\n\(self.usage)\n".data(using: .utf8)!)
+        Foundation.exit(1)
+    }
+}
+
+let options = Options(arguments: Array(CommandLine.arguments.dropFirst()))
+let scenarios = [
+    Scenario.s3ListObjects(),
+    Scenario.s3ListObjectsPaginated(),
+    Scenario.ec2DescribeInstances(),
+    Scenario.dynamoDBScan(),
+    Scenario.dynamoDBGetItemConcurrent(),
+    Scenario.s3ChunkedUpload(size: options.uploadSize),
+].filter { scenario in options.filter.map { scenario.name.contains($0) } ?? true }
+
+let runner = ScenarioRunner(iterations: options.iterations, warmupIterations: options.warmupIterations)
+var results: [ScenarioResult] = []
+for scenario in scenarios {
+    do {
+        FileHandle.standardError.write("Running \(scenario.name)\n".data(using: .utf8)!)
+        try results.append(runner.run(scenario))
+    } catch {
+        Options.exit(withError: "Scenario \(scenario.name) failed: \(error)")
+    }
+}
+let report = Report(allocationCounting: AllocationCounter.isEnabled, warmupIterations: options.warmupIterations, scenarios: results)
+
+let output: Data
+switch options.format {
+case .json:
+    let encoder = JSONEncoder()
+    encoder.keyEncodingStrategy = .convertToSnakeCase
+    encoder.outputFormatting = .prettyPrinted
+    output = try encoder.encode(report)
+case .text:
+    func format(_ value: Double?, _ divisor: Double = 1, _ suffix: String = "") -> String {
+        return value.map { String(format: "%.2f", $0 / divisor) + suffix } ?? "n/a"
+    }
+    var text = ""
+    for result in report.scenarios {
+        text += "\(result.name) (\(result.iterations) iterations of \(result.requestsPerIteration) requests)\n"
+        text += "  latency       p50 \(format(result.latency.p50, 1, "ms")), p99 \(format(result.latency.p99, 1, "ms")), "
+        text += "mean \(format(result.latency.mean, 1, "ms"))\n"
+        text += "  throughput    \(format(result.requestsPerSecond)) requests/s, \(format(result.bytesPerSecond, 1024 * 1024, "MB/s"))\n"
+        text += "  allocations   \(format(result.allocationsPerIteration)) per iteration, "
+        text += "\(format(result.allocatedBytesPerIteration, 1024 * 1024, "MB")) per iteration\n"
+        text += "  peak rss      \(format(result.peakResidentBytes.map { Double($0) }, 1024 * 1024, "MB"))"
+        text += result.peakResidentReset ? "\n" : " (since process start)\n"
+    }
+    output = text.data(using: .utf8)!
+}
+
+if let path = options.output {
+    try output.write(to: URL(fileURLWithPath: path))
+} else {
+    FileHandle.standardOutput.write(output)
+}
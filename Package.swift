@@ -35,7 +35,6 @@ let package = Package(
         .target(name: "SotoCore", dependencies: [
             .byName(name: "SotoSignerV4"),
             .byName(name: "SotoXML"),
-            .byName(name: "INIParser"),
             .product(name: "Logging", package: "swift-log"),
             .product(name: "AsyncHTTPClient", package: "async-http-client"),
             .product(name: "Metrics", package: "swift-metrics"),
@@ -49,6 +48,7 @@ let package = Package(
         .target(name: "SotoCrypto", dependencies: []),
         .target(name: "SotoSignerV4", dependencies: [
             .byName(name: "SotoCrypto"),
+            .product(name: "NIOConcurrencyHelpers", package: "swift-nio"),
             .product(name: "NIOHTTP1", package: "swift-nio"),
         ]),
         .target(name: "SotoTestUtils", dependencies: [
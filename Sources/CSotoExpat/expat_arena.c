@@ -0,0 +1,249 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the Soto for AWS open source project
+//
+// Copyright (c) 2017-2020 the Soto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.txt for the list of Soto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "expat_arena.h"
+
+/* all allocations are aligned to this */
+#define ARENA_ALIGNMENT 16
+/* each allocation is preceded by its size so realloc knows how much to copy.
+   This is padded to keep allocations aligned */
+#define ALLOCATION_HEADER_SIZE ARENA_ALIGNMENT
+
+typedef struct ArenaBlock {
+  struct ArenaBlock *next;
+  size_t size;
+  size_t used;
+} ArenaBlock;
+
+struct Soto_XML_Arena {
+  /* blocks allocated, the first block is used for new allocations */
+  ArenaBlock *blocks;
+  size_t blockSize;
+  size_t capacity;
+};
+
+static _Thread_local Soto_XML_Arena *currentArena = NULL;
+
+static size_t
+alignSize(size_t size) {
+  return (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+}
+
+#define BLOCK_HEADER_SIZE alignSize(sizeof(ArenaBlock))
+#define BLOCK_DATA(block) ((char *)(block) + BLOCK_HEADER_SIZE)
+
+static ArenaBlock *
+createBlock(Soto_XML_Arena *arena, size_t size) {
+  ArenaBlock *block = malloc(BLOCK_HEADER_SIZE + size);
+  if (block == NULL)
+    return NULL;
+  block->next = NULL;
+  block->size = size;
+  block->used = 0;
+  arena->capacity += size;
+  return block;
+}
+
+static void *
+arenaMalloc(size_t size) {
+  Soto_XML_Arena *arena = currentArena;
+  ArenaBlock *block;
+  size_t required;
+  char *allocation;
+
+  if (arena == NULL)
+    return NULL;
+  required = ALLOCATION_HEADER_SIZE + alignSize(size);
+  block = arena->blocks;
+  if (block == NULL || block->size - block->used < required) {
+    if (required > arena->blockSize / 2 && block != NULL) {
+      /* large allocations get a block of their own, placed after the current
+         block so the space left in that can still be used */
+      ArenaBlock *largeBlock = createBlock(arena, required);
+      if (largeBlock == NULL)
+        return NULL;
+      largeBlock->next = block->next;
+      block->next = largeBlock;
+      block = largeBlock;
+    } else {
+      ArenaBlock *newBlock
+          = createBlock(arena, required > arena->blockSize ? required : arena->blockSize);
+      if (newBlock == NULL)
+        return NULL;
+      newBlock->next = block;
+      arena->blocks = newBlock;
+      block = newBlock;
+    }
+  }
+  allocation = BLOCK_DATA(block) + block->used;
+  block->used += required;
+  *(size_t *)allocation = size;
+  return allocation + ALLOCATION_HEADER_SIZE;
+}
+
+/* find block allocation was carved out of, and the block before it in the list */
+static ArenaBlock *
+findBlock(Soto_XML_Arena *arena, const char *allocation, ArenaBlock **previous) {
+  ArenaBlock *block = arena->blocks;
+
+  *previous = NULL;
+  while (block != NULL) {
+    const char *data = BLOCK_DATA(block);
+    if (allocation >= data && allocation < data + block->size)
+      return block;
+    *previous = block;
+    block = block->next;
+  }
+  return NULL;
+}
+
+static void *
+arenaRealloc(void *ptr, size_t size) {
+  Soto_XML_Arena *arena = currentArena;
+  ArenaBlock *block;
+  ArenaBlock *previous;
+  char *allocation;
+  size_t oldSize;
+  size_t oldRequired;
+  size_t required;
+  void *newPtr;
+
+  if (ptr == NULL)
+    return arenaMalloc(size);
+  if (arena == NULL)
+    return NULL;
+  allocation = (char *)ptr - ALLOCATION_HEADER_SIZE;
+  oldSize = *(size_t *)allocation;
+  if (size <= oldSize)
+    return ptr;
+  oldRequired = ALLOCATION_HEADER_SIZE + alignSize(oldSize);
+  required = ALLOCATION_HEADER_SIZE + alignSize(size);
+  block = findBlock(arena, allocation, &previous);
+  if (block != NULL && allocation + oldRequired == BLOCK_DATA(block) + block->used) {
+    /* last allocation in its block, grow it in place if there is room */
+    if (block->size - (block->used - oldRequired) >= required) {
+      block->used += required - oldRequired;
+      *(size_t *)allocation = size;
+      return ptr;
+    }
+    /* only allocation in its block, resize the whole block */
+    if (allocation == BLOCK_DATA(block)) {
+      ArenaBlock *newBlock = realloc(block, BLOCK_HEADER_SIZE + required);
+      if (newBlock == NULL)
+        return NULL;
+      arena->capacity += required - newBlock->size;
+      newBlock->size = required;
+      newBlock->used = required;
+      if (previous != NULL)
+        previous->next = newBlock;
+      else
+        arena->blocks = newBlock;
+      allocation = BLOCK_DATA(newBlock);
+      *(size_t *)allocation = size;
+      return allocation + ALLOCATION_HEADER_SIZE;
+    }
+  }
+  newPtr = arenaMalloc(size);
+  if (newPtr == NULL)
+    return NULL;
+  memcpy(newPtr, ptr, oldSize);
+  /* give the old space back to its block if nothing has been allocated after
+     it */
+  if (block != NULL && allocation + oldRequired == BLOCK_DATA(block) + block->used)
+    block->used -= oldRequired;
+  return newPtr;
+}
+
+static void
+arenaFree(void *ptr) {
+  /* memory is released when the arena is reset */
+  (void)ptr;
+}
+
+static const XML_Memory_Handling_Suite arenaMemorySuite
+    = {arenaMalloc, arenaRealloc, arenaFree};
+
+Soto_XML_Arena *
+Soto_XML_ArenaCreate(size_t blockSize) {
+  Soto_XML_Arena *arena = malloc(sizeof(Soto_XML_Arena));
+  if (arena == NULL)
+    return NULL;
+  arena->blocks = NULL;
+  arena->blockSize = alignSize(blockSize);
+  arena->capacity = 0;
+  return arena;
+}
+
+void
+Soto_XML_ArenaFree(Soto_XML_Arena *arena) {
+  ArenaBlock *block;
+
+  if (arena == NULL)
+    return;
+  block = arena->blocks;
+  while (block != NULL) {
+    ArenaBlock *next = block->next;
+    free(block);
+    block = next;
+  }
+  if (currentArena == arena)
+    currentArena = NULL;
+  free(arena);
+}
+
+void
+Soto_XML_ArenaReset(Soto_XML_Arena *arena) {
+  ArenaBlock *keep = NULL;
+  ArenaBlock *block = arena->blocks;
+
+  /* keep one standard sized block, release everything else */
+  while (block != NULL) {
+    ArenaBlock *next = block->next;
+    if (keep == NULL && block->size == arena->blockSize) {
+      keep = block;
+    } else {
+      arena->capacity -= block->size;
+      free(block);
+    }
+    block = next;
+  }
+  if (keep != NULL) {
+    keep->next = NULL;
+    keep->used = 0;
+  }
+  arena->blocks = keep;
+}
+
+size_t
+Soto_XML_ArenaCapacity(const Soto_XML_Arena *arena) {
+  return arena->capacity;
+}
+
+Soto_XML_Arena *
+Soto_XML_ArenaSetCurrent(Soto_XML_Arena *arena) {
+  Soto_XML_Arena *previous = currentArena;
+  currentArena = arena;
+  return previous;
+}
+
+XML_Parser
+Soto_XML_ParserCreateInArena(const XML_Char *encoding, Soto_XML_Arena *arena) {
+  Soto_XML_Arena *previous = Soto_XML_ArenaSetCurrent(arena);
+  XML_Parser parser = XML_ParserCreate_MM(encoding, &arenaMemorySuite, NULL);
+  Soto_XML_ArenaSetCurrent(previous);
+  return parser;
+}
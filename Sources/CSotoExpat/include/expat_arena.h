@@ -0,0 +1,59 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the Soto for AWS open source project
+//
+// Copyright (c) 2017-2020 the Soto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.txt for the list of Soto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _EXPAT_ARENA_H_
+#define _EXPAT_ARENA_H_
+
+#include <stddef.h>
+#include "expat.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Bump allocator used as an Expat memory handling suite. Allocations are
+   carved out of large blocks and individual frees do nothing, the memory is
+   returned all at once when the arena is reset or freed.
+
+   The memory suite functions Expat calls have no context argument, so the
+   arena used is the one made current on the calling thread with
+   Soto_XML_ArenaSetCurrent. It must be current around every Expat call that
+   can allocate or free memory, including XML_ParserFree. */
+typedef struct Soto_XML_Arena Soto_XML_Arena;
+
+/* Create arena that allocates blocks of blockSize bytes */
+Soto_XML_Arena *Soto_XML_ArenaCreate(size_t blockSize);
+
+/* Free arena and all its memory */
+void Soto_XML_ArenaFree(Soto_XML_Arena *arena);
+
+/* Release all memory allocated from the arena. One block is kept to serve
+   the next allocations. Anything allocated from the arena is invalid after
+   this */
+void Soto_XML_ArenaReset(Soto_XML_Arena *arena);
+
+/* Number of bytes of memory the arena has allocated from the system */
+size_t Soto_XML_ArenaCapacity(const Soto_XML_Arena *arena);
+
+/* Make arena current for this thread. Returns previous current arena */
+Soto_XML_Arena *Soto_XML_ArenaSetCurrent(Soto_XML_Arena *arena);
+
+/* Create parser that allocates all of its memory from arena */
+XML_Parser Soto_XML_ParserCreateInArena(const XML_Char *encoding, Soto_XML_Arena *arena);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _EXPAT_ARENA_H_ */
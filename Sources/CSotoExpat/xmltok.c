@@ -229,6 +229,7 @@ struct normal_encoding {
 static int FASTCALL checkCharRefNumber(int);
 
 #include "xmltok_impl.h"
+#include "xmltok_simd.h"
 #include "ascii.h"
 
 #ifdef XML_MIN_SIZE
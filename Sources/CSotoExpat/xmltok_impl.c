@@ -860,6 +860,14 @@ PREFIX(contentTok)(const ENCODING *enc, const char *ptr, const char *end,
     break;
   }
   while (HAS_CHAR(enc, ptr, end)) {
+#  ifdef XML_SIMD_DATA_SCAN
+    /* skip ASCII bytes that cannot end the run of data several at a time */
+    if (MINBPC(enc) == 1 && enc->isUtf8) {
+      ptr = XmlSkipDataChars(ptr, end);
+      if (! HAS_CHAR(enc, ptr, end))
+        break;
+    }
+#  endif
     switch (BYTE_TYPE(enc, ptr)) {
 #  define LEAD_CASE(n)                                                         \
   case BT_LEAD##n:                                                             \
@@ -0,0 +1,94 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the Soto for AWS open source project
+//
+// Copyright (c) 2017-2020 the Soto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.txt for the list of Soto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef XMLTOK_SIMD_H
+#define XMLTOK_SIMD_H
+
+/* Use SIMD instructions to skip over runs of UTF-8 character data in the
+   content tokenizer when the compiler targets SSE2 or NEON. This is decided
+   here rather than in expat_config.h, which xmltok.c only includes when
+   HAVE_EXPAT_CONFIG_H is defined */
+#if ! defined(XML_SIMD_DATA_SCAN) && defined(__GNUC__)                        \
+    && (defined(__SSE2__) || defined(__aarch64__))
+#  define XML_SIMD_DATA_SCAN 1
+#endif
+
+#ifdef XML_SIMD_DATA_SCAN
+
+#  include <stdint.h>
+#  if defined(__SSE2__)
+#    include <emmintrin.h>
+#  elif defined(__aarch64__)
+#    include <arm_neon.h>
+#  endif
+
+/* Return pointer to the first byte at or after ptr that might end a run of
+   UTF-8 character data, checking 16 bytes at a time. The bytes skipped are
+   tab and 0x20-0x7F except '<', '&' and ']'. These all have a byte type the
+   content tokenizer passes over. Everything else, including CR, LF, other
+   control characters and the bytes of multi-byte characters, is left for the
+   byte type tables to classify. Fewer than 16 remaining bytes are left to the
+   scalar loop as well. */
+static inline const char *
+XmlSkipDataChars(const char *ptr, const char *end) {
+#  if defined(__SSE2__)
+  const __m128i controlMax = _mm_set1_epi8(0x1F);
+  const __m128i tab = _mm_set1_epi8(0x09);
+  const __m128i lt = _mm_set1_epi8('<');
+  const __m128i amp = _mm_set1_epi8('&');
+  const __m128i rsqb = _mm_set1_epi8(']');
+  while (end - ptr >= 16) {
+    const __m128i chars = _mm_loadu_si128((const __m128i *)ptr);
+    /* signed compare, bytes 0x80 and above are negative so fail this */
+    __m128i skip = _mm_cmpgt_epi8(chars, controlMax);
+    const __m128i markup = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(chars, lt), _mm_cmpeq_epi8(chars, amp)),
+        _mm_cmpeq_epi8(chars, rsqb));
+    skip = _mm_or_si128(_mm_andnot_si128(markup, skip),
+                        _mm_cmpeq_epi8(chars, tab));
+    const unsigned int mask = (unsigned int)_mm_movemask_epi8(skip);
+    if (mask != 0xFFFF)
+      return ptr + __builtin_ctz(~mask);
+    ptr += 16;
+  }
+#  elif defined(__aarch64__)
+  const uint8x16_t space = vdupq_n_u8(0x20);
+  const uint8x16_t nonAscii = vdupq_n_u8(0x80);
+  const uint8x16_t tab = vdupq_n_u8(0x09);
+  const uint8x16_t lt = vdupq_n_u8('<');
+  const uint8x16_t amp = vdupq_n_u8('&');
+  const uint8x16_t rsqb = vdupq_n_u8(']');
+  while (end - ptr >= 16) {
+    const uint8x16_t chars = vld1q_u8((const uint8_t *)ptr);
+    uint8x16_t skip = vandq_u8(vcgeq_u8(chars, space), vcltq_u8(chars, nonAscii));
+    const uint8x16_t markup = vorrq_u8(
+        vorrq_u8(vceqq_u8(chars, lt), vceqq_u8(chars, amp)),
+        vceqq_u8(chars, rsqb));
+    skip = vorrq_u8(vbicq_u8(skip, markup), vceqq_u8(chars, tab));
+    if (vminvq_u8(skip) != 0xFF) {
+      /* narrow each byte of the comparison to a nibble to find the first
+         byte that wasn't skipped */
+      const uint64_t mask = vget_lane_u64(
+          vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(skip), 4)), 0);
+      return ptr + (__builtin_ctzll(~mask) >> 2);
+    }
+    ptr += 16;
+  }
+#  endif
+  return ptr;
+}
+
+#endif /* XML_SIMD_DATA_SCAN */
+
+#endif /* XMLTOK_SIMD_H */
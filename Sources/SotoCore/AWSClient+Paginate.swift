@@ -36,6 +36,8 @@ extension AWSClient {
     ///   - command: Command to be paginated
     ///   - inputKey: The name of token in the request object to continue pagination
     ///   - outputKey: The name of token in the response object to continue pagination
+    ///   - prefetch: Maximum number of pages to request ahead of the page being processed by `onPage`. A value of zero requests
+    ///         each page once `onPage` has finished with the previous one. Pages prefetched after `onPage` ends pagination are discarded
     ///   - eventLoop: EventLoop to run this process on
     ///   - logger: Logger used for logging
     ///   - onPage: closure called with each block of entries. It combines an accumulating result with the contents of response from the call to AWS. This combined result is then returned
@@ -46,36 +48,27 @@ extension AWSClient {
         command: @escaping (Input, Logger, EventLoop?) -> EventLoopFuture<Output>,
         inputKey: KeyPath<Input, Input.Token?>,
         outputKey: KeyPath<Output, Input.Token?>,
+        prefetch: Int = 0,
         logger: Logger = AWSClient.loggingDisabled,
         on eventLoop: EventLoop? = nil,
         onPage: @escaping (Result, Output, EventLoop) -> EventLoopFuture<(Bool, Result)>
     ) -> EventLoopFuture<Result> where Input.Token: Equatable {
-        let eventLoop = eventLoop ?? eventLoopGroup.next()
-        let promise = eventLoop.makePromise(of: Result.self)
-
-        func paginatePart(input: Input, currentValue: Result) {
-            let responseFuture = command(input, logger, eventLoop)
-                .flatMap { response in
-                    return onPage(currentValue, response, eventLoop)
-                        .map { continuePaginate, result -> Void in
-                            guard continuePaginate == true else { return promise.succeed(result) }
-                            // get next block token and construct a new input with this token
-                            guard let outputToken = response[keyPath: outputKey] else { return promise.succeed(result) }
-                            // if output token is still the same as the input token then exit with success
-                            guard outputToken != input[keyPath: inputKey] else { return promise.succeed(result) }
-
-                            let input = input.usingPaginationToken(outputToken)
-                            paginatePart(input: input, currentValue: result)
-                        }
-                }
-            responseFuture.whenFailure { error in
-                promise.fail(error)
-            }
-        }
-
-        paginatePart(input: input, currentValue: initialValue)
-
-        return promise.futureResult
+        return self.paginate(
+            input: input,
+            initialValue: initialValue,
+            command: command,
+            nextInput: { input, response in
+                // get next block token and construct a new input with this token
+                guard let outputToken = response[keyPath: outputKey] else { return nil }
+                // if output token is still the same as the input token then exit with success
+                guard outputToken != input[keyPath: inputKey] else { return nil }
+                return input.usingPaginationToken(outputToken)
+            },
+            prefetch: prefetch,
+            logger: logger,
+            on: eventLoop,
+            onPage: onPage
+        )
     }
 
     /// If an AWS command is returning an arbituary sized array sometimes it adds support for paginating this array
@@ -87,6 +80,8 @@ extension AWSClient {
     ///   - command: Command to be paginated
     ///   - inputKey: The name of token in the request object to continue pagination
     ///   - outputKey: The name of token in the response object to continue pagination
+    ///   - prefetch: Maximum number of pages to request ahead of the page being processed by `onPage`. A value of zero requests
+    ///         each page once `onPage` has finished with the previous one. Pages prefetched after `onPage` ends pagination are discarded
     ///   - eventLoop: EventLoop to run this process on
     ///   - logger: Logger used for logging
     ///   - onPage: closure called with each block of entries. Returns boolean indicating whether we should continue.
@@ -95,11 +90,12 @@ extension AWSClient {
         command: @escaping (Input, Logger, EventLoop?) -> EventLoopFuture<Output>,
         inputKey: KeyPath<Input, Input.Token?>,
         outputKey: KeyPath<Output, Input.Token?>,
+        prefetch: Int = 0,
         logger: Logger = AWSClient.loggingDisabled,
         on eventLoop: EventLoop? = nil,
         onPage: @escaping (Output, EventLoop) -> EventLoopFuture<Bool>
     ) -> EventLoopFuture<Void> where Input.Token: Equatable {
-        self.paginate(input: input, initialValue: (), command: command, inputKey: inputKey, outputKey: outputKey, logger: logger, on: eventLoop) { _, output, eventLoop in
+        self.paginate(input: input, initialValue: (), command: command, inputKey: inputKey, outputKey: outputKey, prefetch: prefetch, logger: logger, on: eventLoop) { _, output, eventLoop in
             return onPage(output, eventLoop).map { rt in (rt, ()) }
         }
     }
@@ -114,6 +110,8 @@ extension AWSClient {
     ///   - initialValue: The value to use as the initial accumulating value. `initialValue` is passed to `onPage` the first time it is called.
     ///   - command: Command to be paginated
     ///   - tokenKey: The name of token in the response object to continue pagination
+    ///   - prefetch: Maximum number of pages to request ahead of the page being processed by `onPage`. A value of zero requests
+    ///         each page once `onPage` has finished with the previous one. Pages prefetched after `onPage` ends pagination are discarded
     ///   - eventLoop: EventLoop to run this process on
     ///   - logger: Logger used for logging
     ///   - onPage: closure called with each block of entries. It combines an accumulating result with the contents of response from the call to AWS. This combined result is then returned
@@ -123,34 +121,25 @@ extension AWSClient {
         initialValue: Result,
         command: @escaping (Input, Logger, EventLoop?) -> EventLoopFuture<Output>,
         tokenKey: KeyPath<Output, Input.Token?>,
+        prefetch: Int = 0,
         logger: Logger = AWSClient.loggingDisabled,
         on eventLoop: EventLoop? = nil,
         onPage: @escaping (Result, Output, EventLoop) -> EventLoopFuture<(Bool, Result)>
     ) -> EventLoopFuture<Result> {
-        let eventLoop = eventLoop ?? eventLoopGroup.next()
-        let promise = eventLoop.makePromise(of: Result.self)
-
-        func paginatePart(input: Input, currentValue: Result) {
-            let responseFuture = command(input, logger, eventLoop)
-                .flatMap { response in
-                    return onPage(currentValue, response, eventLoop)
-                        .map { continuePaginate, result -> Void in
-                            guard continuePaginate == true else { return promise.succeed(result) }
-                            // get next block token and construct a new input with this token
-                            guard let token = response[keyPath: tokenKey] else { return promise.succeed(result) }
-
-                            let input = input.usingPaginationToken(token)
-                            paginatePart(input: input, currentValue: result)
-                        }
-                }
-            responseFuture.whenFailure { error in
-                promise.fail(error)
-            }
-        }
-
-        paginatePart(input: input, currentValue: initialValue)
-
-        return promise.futureResult
+        return self.paginate(
+            input: input,
+            initialValue: initialValue,
+            command: command,
+            nextInput: { input, response in
+                // get next block token and construct a new input with this token
+                guard let token = response[keyPath: tokenKey] else { return nil }
+                return input.usingPaginationToken(token)
+            },
+            prefetch: prefetch,
+            logger: logger,
+            on: eventLoop,
+            onPage: onPage
+        )
     }
 
     /// If an AWS command is returning an arbituary sized array sometimes it adds support for paginating this array
@@ -161,6 +150,8 @@ extension AWSClient {
     ///   - input: Input for request
     ///   - command: Command to be paginated
     ///   - tokenKey: The name of token in the response object to continue pagination
+    ///   - prefetch: Maximum number of pages to request ahead of the page being processed by `onPage`. A value of zero requests
+    ///         each page once `onPage` has finished with the previous one. Pages prefetched after `onPage` ends pagination are discarded
     ///   - eventLoop: EventLoop to run this process on
     ///   - logger: Logger used for logging
     ///   - onPage: closure called with each block of entries. Returns boolean indicating whether we should continue.
@@ -168,11 +159,12 @@ extension AWSClient {
         input: Input,
         command: @escaping (Input, Logger, EventLoop?) -> EventLoopFuture<Output>,
         tokenKey: KeyPath<Output, Input.Token?>,
+        prefetch: Int = 0,
         logger: Logger = AWSClient.loggingDisabled,
         on eventLoop: EventLoop? = nil,
         onPage: @escaping (Output, EventLoop) -> EventLoopFuture<Bool>
     ) -> EventLoopFuture<Void> {
-        self.paginate(input: input, initialValue: (), command: command, tokenKey: tokenKey, logger: logger, on: eventLoop) { _, output, eventLoop in
+        self.paginate(input: input, initialValue: (), command: command, tokenKey: tokenKey, prefetch: prefetch, logger: logger, on: eventLoop) { _, output, eventLoop in
             return onPage(output, eventLoop).map { rt in (rt, ()) }
         }
     }
@@ -188,6 +180,8 @@ extension AWSClient {
     ///   - command: Command to be paginated
     ///   - tokenKey: The name of token in the response object to continue pagination
     ///   - moreResultsKey: The KeyPath for the member of the output that indicates whether we should ask for more data
+    ///   - prefetch: Maximum number of pages to request ahead of the page being processed by `onPage`. A value of zero requests
+    ///         each page once `onPage` has finished with the previous one. Pages prefetched after `onPage` ends pagination are discarded
     ///   - eventLoop: EventLoop to run this process on
     ///   - logger: Logger used for logging
     ///   - onPage: closure called with each block of entries. It combines an accumulating result with the contents of response from the call to AWS. This combined result is then returned
@@ -198,35 +192,26 @@ extension AWSClient {
         command: @escaping (Input, Logger, EventLoop?) -> EventLoopFuture<Output>,
         tokenKey: KeyPath<Output, Input.Token?>,
         moreResultsKey: KeyPath<Output, Bool?>,
+        prefetch: Int = 0,
         logger: Logger = AWSClient.loggingDisabled,
         on eventLoop: EventLoop? = nil,
         onPage: @escaping (Result, Output, EventLoop) -> EventLoopFuture<(Bool, Result)>
     ) -> EventLoopFuture<Result> {
-        let eventLoop = eventLoop ?? eventLoopGroup.next()
-        let promise = eventLoop.makePromise(of: Result.self)
-
-        func paginatePart(input: Input, currentValue: Result) {
-            let responseFuture = command(input, logger, eventLoop)
-                .flatMap { response in
-                    return onPage(currentValue, response, eventLoop)
-                        .map { continuePaginate, result -> Void in
-                            guard continuePaginate == true else { return promise.succeed(result) }
-                            // get next block token and construct a new input with this token
-                            guard let token = response[keyPath: tokenKey],
-                                  response[keyPath: moreResultsKey] == true else { return promise.succeed(result) }
-
-                            let input = input.usingPaginationToken(token)
-                            paginatePart(input: input, currentValue: result)
-                        }
-                }
-            responseFuture.whenFailure { error in
-                promise.fail(error)
-            }
-        }
-
-        paginatePart(input: input, currentValue: initialValue)
-
-        return promise.futureResult
+        return self.paginate(
+            input: input,
+            initialValue: initialValue,
+            command: command,
+            nextInput: { input, response in
+                // get next block token and construct a new input with this token
+                guard let token = response[keyPath: tokenKey],
+                      response[keyPath: moreResultsKey] == true else { return nil }
+                return input.usingPaginationToken(token)
+            },
+            prefetch: prefetch,
+            logger: logger,
+            on: eventLoop,
+            onPage: onPage
+        )
     }
 
     /// If an AWS command is returning an arbituary sized array sometimes it adds support for paginating this array
@@ -238,6 +223,8 @@ extension AWSClient {
     ///   - command: Command to be paginated
     ///   - tokenKey: The name of token in the response object to continue pagination
     ///   - moreResultsKey: The KeyPath for the member of the output that indicates whether we should ask for more data
+    ///   - prefetch: Maximum number of pages to request ahead of the page being processed by `onPage`. A value of zero requests
+    ///         each page once `onPage` has finished with the previous one. Pages prefetched after `onPage` ends pagination are discarded
     ///   - eventLoop: EventLoop to run this process on
     ///   - logger: Logger used for logging
     ///   - onPage: closure called with each block of entries. Returns boolean indicating whether we should continue.
@@ -246,11 +233,12 @@ extension AWSClient {
         command: @escaping (Input, Logger, EventLoop?) -> EventLoopFuture<Output>,
         tokenKey: KeyPath<Output, Input.Token?>,
         moreResultsKey: KeyPath<Output, Bool?>,
+        prefetch: Int = 0,
         logger: Logger = AWSClient.loggingDisabled,
         on eventLoop: EventLoop? = nil,
         onPage: @escaping (Output, EventLoop) -> EventLoopFuture<Bool>
     ) -> EventLoopFuture<Void> {
-        self.paginate(input: input, initialValue: (), command: command, tokenKey: tokenKey, moreResultsKey: moreResultsKey, logger: logger, on: eventLoop) { _, output, eventLoop in
+        self.paginate(input: input, initialValue: (), command: command, tokenKey: tokenKey, moreResultsKey: moreResultsKey, prefetch: prefetch, logger: logger, on: eventLoop) { _, output, eventLoop in
             return onPage(output, eventLoop).map { rt in (rt, ()) }
         }
     }
@@ -281,31 +269,21 @@ extension AWSClient {
         on eventLoop: EventLoop? = nil,
         onPage: @escaping (Result, Output, EventLoop) -> EventLoopFuture<(Bool, Result)>
     ) -> EventLoopFuture<Result> {
-        let eventLoop = eventLoop ?? eventLoopGroup.next()
-        let promise = eventLoop.makePromise(of: Result.self)
-
-        func paginatePart(input: Input, currentValue: Result) {
-            let responseFuture = command(input, logger, eventLoop)
-                .flatMap { response in
-                    return onPage(currentValue, response, eventLoop)
-                        .map { continuePaginate, result -> Void in
-                            guard continuePaginate == true else { return promise.succeed(result) }
-                            // get next block token and construct a new input with this token
-                            guard let token = response[keyPath: tokenKey],
-                                  response[keyPath: moreResultsKey] else { return promise.succeed(result) }
-
-                            let input = input.usingPaginationToken(token)
-                            paginatePart(input: input, currentValue: result)
-                        }
-                }
-            responseFuture.whenFailure { error in
-                promise.fail(error)
-            }
-        }
-
-        paginatePart(input: input, currentValue: initialValue)
-
-        return promise.futureResult
+        return self.paginate(
+            input: input,
+            initialValue: initialValue,
+            command: command,
+            nextInput: { input, response in
+                // get next block token and construct a new input with this token
+                guard let token = response[keyPath: tokenKey],
+                      response[keyPath: moreResultsKey] else { return nil }
+                return input.usingPaginationToken(token)
+            },
+            prefetch: 0,
+            logger: logger,
+            on: eventLoop,
+            onPage: onPage
+        )
     }
 
     /// If an AWS command is returning an arbituary sized array sometimes it adds support for paginating this array
@@ -334,4 +312,433 @@ extension AWSClient {
             return onPage(output, eventLoop).map { rt in (rt, ()) }
         }
     }
+
+    /// Paginate using a closure to construct the input for the next page from a response. The request for the next page is
+    /// sent as soon as the previous response has been received, while `onPage` is processing pages already loaded, as long
+    /// as no more than `prefetch` pages are waiting for `onPage`.
+    func paginate<Input, Output, Result>(
+        input: Input,
+        initialValue: Result,
+        command: @escaping (Input, Logger, EventLoop?) -> EventLoopFuture<Output>,
+        nextInput: @escaping (Input, Output) -> Input?,
+        prefetch: Int,
+        logger: Logger,
+        on eventLoop: EventLoop?,
+        onPage: @escaping (Result, Output, EventLoop) -> EventLoopFuture<(Bool, Result)>
+    ) -> EventLoopFuture<Result> {
+        precondition(prefetch >= 0, "Cannot prefetch a negative number of pages")
+        let eventLoop = eventLoop ?? eventLoopGroup.next()
+        let paginator = Paginator(
+            initialValue: initialValue,
+            command: { input in command(input, logger, eventLoop) },
+            nextInput: nextInput,
+            prefetch: prefetch,
+            eventLoop: eventLoop,
+            onPage: onPage
+        )
+        return paginator.start(input: input)
+    }
+}
+
+// MARK: Partitioned pagination
+
+extension AWSClient {
+    /// Paginate a set of independent partitions of an enumeration, eg DynamoDB Scan segments or S3 listings split by prefix.
+    /// Each partition is paginated on its own EventLoop from the client `EventLoopGroup`, with up to `maxConcurrentPartitions`
+    /// partitions running at the same time. Every page from every partition is passed to `onPage`, one at a time, to combine
+    /// into one result. Pages from different partitions are interleaved in the order they arrive.
+    ///
+    /// - Parameters:
+    ///   - partitions: Inputs for the first request of each partition
+    ///   - initialValue: The value to use as the initial accumulating value. `initialValue` is passed to `onPage` the first time it is called.
+    ///   - command: Command to be paginated
+    ///   - inputKey: The name of token in the request object to continue pagination
+    ///   - outputKey: The name of token in the response object to continue pagination
+    ///   - maxConcurrentPartitions: Maximum number of partitions to paginate at the same time
+    ///   - eventLoop: EventLoop to run `onPage` on
+    ///   - logger: Logger used for logging
+    ///   - onPage: closure called with each block of entries. It combines an accumulating result with the contents of response from the call to AWS. This combined result is then returned
+    ///         along with a boolean indicating if the paginate operation should continue. Returning false stops all the partitions.
+    public func paginate<Input: AWSPaginateToken, Output: AWSShape, Result>(
+        partitions: [Input],
+        initialValue: Result,
+        command: @escaping (Input, Logger, EventLoop?) -> EventLoopFuture<Output>,
+        inputKey: KeyPath<Input, Input.Token?>,
+        outputKey: KeyPath<Output, Input.Token?>,
+        maxConcurrentPartitions: Int,
+        logger: Logger = AWSClient.loggingDisabled,
+        on eventLoop: EventLoop? = nil,
+        onPage: @escaping (Result, Output, EventLoop) -> EventLoopFuture<(Bool, Result)>
+    ) -> EventLoopFuture<Result> where Input.Token: Equatable {
+        return self.paginate(
+            partitions: partitions,
+            initialValue: initialValue,
+            command: command,
+            nextInput: { input, response in
+                guard let outputToken = response[keyPath: outputKey] else { return nil }
+                guard outputToken != input[keyPath: inputKey] else { return nil }
+                return input.usingPaginationToken(outputToken)
+            },
+            maxConcurrentPartitions: maxConcurrentPartitions,
+            logger: logger,
+            on: eventLoop,
+            onPage: onPage
+        )
+    }
+
+    /// Paginate a set of independent partitions of an enumeration, eg DynamoDB Scan segments or S3 listings split by prefix.
+    /// Each partition is paginated on its own EventLoop from the client `EventLoopGroup`, with up to `maxConcurrentPartitions`
+    /// partitions running at the same time. `onPage` is called with one page at a time.
+    ///
+    /// - Parameters:
+    ///   - partitions: Inputs for the first request of each partition
+    ///   - command: Command to be paginated
+    ///   - inputKey: The name of token in the request object to continue pagination
+    ///   - outputKey: The name of token in the response object to continue pagination
+    ///   - maxConcurrentPartitions: Maximum number of partitions to paginate at the same time
+    ///   - eventLoop: EventLoop to run `onPage` on
+    ///   - logger: Logger used for logging
+    ///   - onPage: closure called with each block of entries. Returns boolean indicating whether we should continue.
+    public func paginate<Input: AWSPaginateToken, Output: AWSShape>(
+        partitions: [Input],
+        command: @escaping (Input, Logger, EventLoop?) -> EventLoopFuture<Output>,
+        inputKey: KeyPath<Input, Input.Token?>,
+        outputKey: KeyPath<Output, Input.Token?>,
+        maxConcurrentPartitions: Int,
+        logger: Logger = AWSClient.loggingDisabled,
+        on eventLoop: EventLoop? = nil,
+        onPage: @escaping (Output, EventLoop) -> EventLoopFuture<Bool>
+    ) -> EventLoopFuture<Void> where Input.Token: Equatable {
+        self.paginate(partitions: partitions, initialValue: (), command: command, inputKey: inputKey, outputKey: outputKey, maxConcurrentPartitions: maxConcurrentPartitions, logger: logger, on: eventLoop) { _, output, eventLoop in
+            return onPage(output, eventLoop).map { rt in (rt, ()) }
+        }
+    }
+
+    /// Paginate a set of independent partitions of an enumeration, eg DynamoDB Scan segments or S3 listings split by prefix.
+    /// Each partition is paginated on its own EventLoop from the client `EventLoopGroup`, with up to `maxConcurrentPartitions`
+    /// partitions running at the same time. Every page from every partition is passed to `onPage`, one at a time, to combine
+    /// into one result. Pages from different partitions are interleaved in the order they arrive.
+    ///
+    /// - Parameters:
+    ///   - partitions: Inputs for the first request of each partition
+    ///   - initialValue: The value to use as the initial accumulating value. `initialValue` is passed to `onPage` the first time it is called.
+    ///   - command: Command to be paginated
+    ///   - tokenKey: The name of token in the response object to continue pagination
+    ///   - maxConcurrentPartitions: Maximum number of partitions to paginate at the same time
+    ///   - eventLoop: EventLoop to run `onPage` on
+    ///   - logger: Logger used for logging
+    ///   - onPage: closure called with each block of entries. It combines an accumulating result with the contents of response from the call to AWS. This combined result is then returned
+    ///         along with a boolean indicating if the paginate operation should continue. Returning false stops all the partitions.
+    public func paginate<Input: AWSPaginateToken, Output: AWSShape, Result>(
+        partitions: [Input],
+        initialValue: Result,
+        command: @escaping (Input, Logger, EventLoop?) -> EventLoopFuture<Output>,
+        tokenKey: KeyPath<Output, Input.Token?>,
+        maxConcurrentPartitions: Int,
+        logger: Logger = AWSClient.loggingDisabled,
+        on eventLoop: EventLoop? = nil,
+        onPage: @escaping (Result, Output, EventLoop) -> EventLoopFuture<(Bool, Result)>
+    ) -> EventLoopFuture<Result> {
+        return self.paginate(
+            partitions: partitions,
+            initialValue: initialValue,
+            command: command,
+            nextInput: { input, response in
+                guard let token = response[keyPath: tokenKey] else { return nil }
+                return input.usingPaginationToken(token)
+            },
+            maxConcurrentPartitions: maxConcurrentPartitions,
+            logger: logger,
+            on: eventLoop,
+            onPage: onPage
+        )
+    }
+
+    /// Paginate a set of independent partitions of an enumeration, eg DynamoDB Scan segments or S3 listings split by prefix.
+    /// Each partition is paginated on its own EventLoop from the client `EventLoopGroup`, with up to `maxConcurrentPartitions`
+    /// partitions running at the same time. `onPage` is called with one page at a time.
+    ///
+    /// - Parameters:
+    ///   - partitions: Inputs for the first request of each partition
+    ///   - command: Command to be paginated
+    ///   - tokenKey: The name of token in the response object to continue pagination
+    ///   - maxConcurrentPartitions: Maximum number of partitions to paginate at the same time
+    ///   - eventLoop: EventLoop to run `onPage` on
+    ///   - logger: Logger used for logging
+    ///   - onPage: closure called with each block of entries. Returns boolean indicating whether we should continue.
+    public func paginate<Input: AWSPaginateToken, Output: AWSShape>(
+        partitions: [Input],
+        command: @escaping (Input, Logger, EventLoop?) -> EventLoopFuture<Output>,
+        tokenKey: KeyPath<Output, Input.Token?>,
+        maxConcurrentPartitions: Int,
+        logger: Logger = AWSClient.loggingDisabled,
+        on eventLoop: EventLoop? = nil,
+        onPage: @escaping (Output, EventLoop) -> EventLoopFuture<Bool>
+    ) -> EventLoopFuture<Void> {
+        self.paginate(partitions: partitions, initialValue: (), command: command, tokenKey: tokenKey, maxConcurrentPartitions: maxConcurrentPartitions, logger: logger, on: eventLoop) { _, output, eventLoop in
+            return onPage(output, eventLoop).map { rt in (rt, ()) }
+        }
+    }
+
+    /// Paginate partitions, each on an EventLoop of their own, and combine their pages with `onPage`
+    func paginate<Input, Output, Result>(
+        partitions: [Input],
+        initialValue: Result,
+        command: @escaping (Input, Logger, EventLoop?) -> EventLoopFuture<Output>,
+        nextInput: @escaping (Input, Output) -> Input?,
+        maxConcurrentPartitions: Int,
+        logger: Logger,
+        on eventLoop: EventLoop?,
+        onPage: @escaping (Result, Output, EventLoop) -> EventLoopFuture<(Bool, Result)>
+    ) -> EventLoopFuture<Result> {
+        precondition(maxConcurrentPartitions > 0, "Must be able to paginate at least one partition at a time")
+        let eventLoop = eventLoop ?? eventLoopGroup.next()
+        let paginator = PartitionedPaginator(
+            partitions: partitions,
+            initialValue: initialValue,
+            paginatePartition: { input, partitionEventLoop, onPartitionPage in
+                self.paginate(
+                    input: input,
+                    initialValue: (),
+                    command: command,
+                    nextInput: nextInput,
+                    prefetch: 0,
+                    logger: logger,
+                    on: partitionEventLoop
+                ) { _, output, eventLoop in
+                    onPartitionPage(output, eventLoop).map { rt in (rt, ()) }
+                }
+            },
+            maxConcurrentPartitions: maxConcurrentPartitions,
+            eventLoopGroup: self.eventLoopGroup,
+            eventLoop: eventLoop,
+            onPage: onPage
+        )
+        return paginator.start()
+    }
+}
+
+/// State of a paginate operation.
+///
+/// Pages are requested in order, because each request needs the token from the previous response, but a request doesn't
+/// need to wait for `onPage` to finish with the previous page. Responses are held in a buffer until `onPage` is ready for
+/// them, and no new request is sent while `prefetch` pages are waiting, so a slow `onPage` applies backpressure to the
+/// requests. All state is only accessed on `eventLoop`.
+private final class Paginator<Input, Output, Result> {
+    let command: (Input) -> EventLoopFuture<Output>
+    let nextInput: (Input, Output) -> Input?
+    let onPage: (Result, Output, EventLoop) -> EventLoopFuture<(Bool, Result)>
+    let prefetch: Int
+    let eventLoop: EventLoop
+    let promise: EventLoopPromise<Result>
+
+    /// input for the next request. Nil once the last page has been requested
+    var pendingInput: Input?
+    var requestInFlight: Bool
+    /// pages received, waiting for `onPage`
+    var pages: CircularBuffer<Output>
+    var processingPage: Bool
+    var currentValue: Result
+    var finished: Bool
+
+    init(
+        initialValue: Result,
+        command: @escaping (Input) -> EventLoopFuture<Output>,
+        nextInput: @escaping (Input, Output) -> Input?,
+        prefetch: Int,
+        eventLoop: EventLoop,
+        onPage: @escaping (Result, Output, EventLoop) -> EventLoopFuture<(Bool, Result)>
+    ) {
+        self.command = command
+        self.nextInput = nextInput
+        self.onPage = onPage
+        self.prefetch = prefetch
+        self.eventLoop = eventLoop
+        self.promise = eventLoop.makePromise()
+        self.pendingInput = nil
+        self.requestInFlight = false
+        self.pages = .init(initialCapacity: prefetch + 1)
+        self.processingPage = false
+        self.currentValue = initialValue
+        self.finished = false
+    }
+
+    func start(input: Input) -> EventLoopFuture<Result> {
+        self.eventLoop.execute {
+            self.pendingInput = input
+            self.requestPage()
+        }
+        return self.promise.futureResult
+    }
+
+    /// Send request for the next page if there is one and there is room for it in the buffer
+    private func requestPage() {
+        guard !self.finished, !self.requestInFlight, let input = self.pendingInput else { return }
+        if self.processingPage {
+            guard self.pages.count < self.prefetch else { return }
+        }
+        self.pendingInput = nil
+        self.requestInFlight = true
+        self.command(input).hop(to: self.eventLoop).whenComplete { result in
+            self.requestInFlight = false
+            switch result {
+            case .success(let response):
+                // extract the next token before the page is processed so the next request can be sent straight away
+                self.pendingInput = self.nextInput(input, response)
+                self.pages.append(response)
+                self.processPage()
+                self.requestPage()
+            case .failure(let error):
+                self.fail(error)
+            }
+        }
+    }
+
+    /// Pass the next page in the buffer to `onPage` if it isn't already processing a page
+    private func processPage() {
+        guard !self.finished, !self.processingPage, !self.pages.isEmpty else { return }
+        let page = self.pages.removeFirst()
+        self.processingPage = true
+        self.onPage(self.currentValue, page, self.eventLoop).hop(to: self.eventLoop).whenComplete { result in
+            self.processingPage = false
+            switch result {
+            case .success(let (continuePaginate, value)):
+                self.currentValue = value
+                guard continuePaginate,
+                      self.pendingInput != nil || self.requestInFlight || !self.pages.isEmpty
+                else {
+                    self.finished = true
+                    self.promise.succeed(value)
+                    return
+                }
+                self.processPage()
+                self.requestPage()
+            case .failure(let error):
+                self.fail(error)
+            }
+        }
+    }
+
+    private func fail(_ error: Error) {
+        guard !self.finished else { return }
+        self.finished = true
+        self.promise.fail(error)
+    }
+}
+
+/// State of a partitioned paginate operation.
+///
+/// Each partition is paginated on the next EventLoop from the group, so they are spread across all the loops. Pages hop
+/// back to `eventLoop` and are chained onto the previous call to `onPage`, which serialises access to the combined result.
+/// A partition doesn't request its next page until its current page has been combined. All state is only accessed on
+/// `eventLoop`.
+private final class PartitionedPaginator<Input, Output, Result> {
+    typealias PaginatePartition = (Input, EventLoop, @escaping (Output, EventLoop) -> EventLoopFuture<Bool>) -> EventLoopFuture<Void>
+
+    let partitions: [Input]
+    let paginatePartition: PaginatePartition
+    let onPage: (Result, Output, EventLoop) -> EventLoopFuture<(Bool, Result)>
+    let maxConcurrentPartitions: Int
+    let eventLoopGroup: EventLoopGroup
+    let eventLoop: EventLoop
+    let promise: EventLoopPromise<Result>
+
+    /// index of next partition to start
+    var nextPartition: Int
+    var runningPartitions: Int
+    /// future for the last call to `onPage`
+    var lastPage: EventLoopFuture<Void>
+    var currentValue: Result
+    /// set when `onPage` returns false
+    var stopped: Bool
+    var finished: Bool
+
+    init(
+        partitions: [Input],
+        initialValue: Result,
+        paginatePartition: @escaping PaginatePartition,
+        maxConcurrentPartitions: Int,
+        eventLoopGroup: EventLoopGroup,
+        eventLoop: EventLoop,
+        onPage: @escaping (Result, Output, EventLoop) -> EventLoopFuture<(Bool, Result)>
+    ) {
+        self.partitions = partitions
+        self.paginatePartition = paginatePartition
+        self.onPage = onPage
+        self.maxConcurrentPartitions = maxConcurrentPartitions
+        self.eventLoopGroup = eventLoopGroup
+        self.eventLoop = eventLoop
+        self.promise = eventLoop.makePromise()
+        self.nextPartition = 0
+        self.runningPartitions = 0
+        self.lastPage = eventLoop.makeSucceededFuture(())
+        self.currentValue = initialValue
+        self.stopped = false
+        self.finished = false
+    }
+
+    func start() -> EventLoopFuture<Result> {
+        self.eventLoop.execute {
+            for _ in 0..<min(self.maxConcurrentPartitions, self.partitions.count) {
+                self.startPartition()
+            }
+            self.succeedIfComplete()
+        }
+        return self.promise.futureResult
+    }
+
+    /// Start paginating the next partition on an EventLoop of its own
+    private func startPartition() {
+        guard !self.finished, !self.stopped, self.nextPartition < self.partitions.count else { return }
+        let input = self.partitions[self.nextPartition]
+        self.nextPartition += 1
+        self.runningPartitions += 1
+        self.paginatePartition(input, self.eventLoopGroup.next()) { output, partitionEventLoop in
+            return self.eventLoop.flatSubmit {
+                self.combine(output)
+            }.hop(to: partitionEventLoop)
+        }
+        .hop(to: self.eventLoop)
+        .whenComplete { result in
+            self.runningPartitions -= 1
+            switch result {
+            case .success:
+                self.startPartition()
+                self.succeedIfComplete()
+            case .failure(let error):
+                self.fail(error)
+            }
+        }
+    }
+
+    /// Pass page to `onPage` once the previous page has been combined. Returns whether the partition should continue
+    private func combine(_ output: Output) -> EventLoopFuture<Bool> {
+        let future = self.lastPage.flatMap { () -> EventLoopFuture<Bool> in
+            guard !self.stopped, !self.finished else { return self.eventLoop.makeSucceededFuture(false) }
+            return self.onPage(self.currentValue, output, self.eventLoop)
+                .hop(to: self.eventLoop)
+                .map { continuePaginate, value in
+                    self.currentValue = value
+                    if !continuePaginate {
+                        self.stopped = true
+                    }
+                    return continuePaginate
+                }
+        }
+        self.lastPage = future.map { _ in }
+        return future
+    }
+
+    private func succeedIfComplete() {
+        guard !self.finished, self.runningPartitions == 0 else { return }
+        guard self.stopped || self.nextPartition == self.partitions.count else { return }
+        self.finished = true
+        self.promise.succeed(self.currentValue)
+    }
+
+    private func fail(_ error: Error) {
+        guard !self.finished else { return }
+        self.finished = true
+        self.promise.fail(error)
+    }
 }
@@ -16,6 +16,7 @@ import AsyncHTTPClient
 import Dispatch
 import struct Foundation.URL
 import struct Foundation.URLQueryItem
+import struct Foundation.UUID
 import Logging
 import Metrics
 import NIO
@@ -52,6 +53,18 @@ public final class AWSClient {
     let clientLogger: Logger
     /// client options
     let options: Options
+    /// Signing keys derived from the credentials, shared by all requests made by this client
+    let signingKeyCache = SigningKeyCache()
+    /// Pool of working buffers for S3 chunked uploads
+    let s3ChunkedUploadBufferPool: ByteBufferPool?
+    /// Requests in flight for operations that can be coalesced
+    let singleFlight = SingleFlight()
+    /// Identifies outputs this client has added to response caches. Caches belong to service configs, which can be
+    /// shared between clients and outlive them
+    let responseCacheID = UUID()
+    /// Response caches this client has added outputs to, so they can be removed on shutdown
+    private var responseCaches: [ObjectIdentifier: AWSResponseCache] = [:]
+    private let responseCachesLock = Lock()
 
     private let isShutdown = NIOAtomic<Bool>.makeAtomic(value: false)
 
@@ -94,6 +107,7 @@ public final class AWSClient {
         self.retryPolicy = retryPolicyFactory.retryPolicy
         self.clientLogger = clientLogger
         self.options = options
+        self.s3ChunkedUploadBufferPool = options.s3ChunkedUpload.bufferPoolSize.map { ByteBufferPool(maximumBytes: $0) }
     }
 
     /// Initialize an AWSClient struct
@@ -164,6 +178,10 @@ public final class AWSClient {
             callback(ClientError.alreadyShutdown)
             return
         }
+        let responseCaches = self.responseCachesLock.withLock { self.responseCaches.values }
+        for responseCache in responseCaches {
+            responseCache.removeAll(client: self.responseCacheID)
+        }
         let eventLoop = eventLoopGroup.next()
         // ignore errors from credential provider. Don't need shutdown erroring because no providers were available
         credentialProvider.shutdown(on: eventLoop).whenComplete { _ in
@@ -232,15 +250,61 @@ public final class AWSClient {
         let requestLogLevel: Logger.Level
         /// log level used for error logging
         let errorLogLevel: Logger.Level
+        /// options for S3 uploads streamed with aws-chunked content encoding
+        let s3ChunkedUpload: S3ChunkedUpload
+        /// operations, indexed by service name, whose identical in-flight requests are shared
+        let coalescedOperations: [String: Set<String>]
+        /// record how long each stage of a request takes
+        let recordStageMetrics: Bool
 
         /// Initialize AWSClient.Options
         /// - Parameter requestLogLevel:Log level used for request logging
+        /// - Parameter errorLogLevel:Log level used for error logging
+        /// - Parameter s3ChunkedUpload: Options for S3 streamed uploads
+        /// - Parameter coalescedOperations: Operation names, indexed by service name (eg `["ssm": ["GetParameter"]]`), that
+        ///     are safe to coalesce. A request for one of these operations, that is identical to one already in flight, waits
+        ///     for the result of that request instead of being sent. Only include idempotent reads.
+        /// - Parameter recordStageMetrics: Record how long getting credentials, signing, sending the request, waiting for
+        ///     the first byte of the response, receiving the response body and decoding the output each take, along with
+        ///     the size of response bodies and the number of attempts each request takes. Timings of the HTTP response are
+        ///     only recorded when using an AsyncHTTPClient.
         public init(
             requestLogLevel: Logger.Level = .debug,
-            errorLogLevel: Logger.Level = .debug
+            errorLogLevel: Logger.Level = .debug,
+            s3ChunkedUpload: S3ChunkedUpload = .init(),
+            coalescedOperations: [String: Set<String>] = [:],
+            recordStageMetrics: Bool = false
         ) {
             self.requestLogLevel = requestLogLevel
             self.errorLogLevel = errorLogLevel
+            self.s3ChunkedUpload = s3ChunkedUpload
+            self.coalescedOperations = coalescedOperations
+            self.recordStageMetrics = recordStageMetrics
+        }
+
+        /// Options for S3 uploads streamed with aws-chunked content encoding
+        public struct S3ChunkedUpload {
+            /// thread pool chunk payloads are hashed on
+            let threadPool: NIOThreadPool?
+            /// number of chunks to read and hash ahead of them being uploaded
+            let readAhead: Int
+            /// maximum memory used by working buffers of all the uploads in progress
+            let bufferPoolSize: Int?
+
+            /// Initialize AWSClient.Options.S3ChunkedUpload
+            /// - Parameters:
+            ///   - threadPool: Thread pool to hash chunk payloads on. If this is nil each chunk is hashed on the EventLoop as it is
+            ///         uploaded. The thread pool is not owned by the `AWSClient` so you are responsible for shutting it down.
+            ///   - readAhead: Number of chunks to read and hash ahead of them being uploaded, when hashing on a thread pool
+            ///   - bufferPoolSize: If set, uploads borrow their working buffers from a pool shared by the `AWSClient` that never
+            ///         holds more than this many bytes. Chunks read ahead each hold a buffer from the pool until they are uploaded.
+            ///         Uploads wait for a buffer when the pool is exhausted. If nil every upload allocates its own working buffers.
+            public init(threadPool: NIOThreadPool? = nil, readAhead: Int = 4, bufferPoolSize: Int? = nil) {
+                precondition(readAhead > 0, "Read ahead must be at least one chunk")
+                self.threadPool = threadPool
+                self.readAhead = readAhead
+                self.bufferPoolSize = bufferPoolSize
+            }
         }
     }
 }
@@ -279,13 +343,14 @@ extension AWSClient {
                     configuration: serviceConfig
                 )
             },
-            execute: { request, eventLoop, logger in
-                return self.httpClient.execute(request: request, timeout: serviceConfig.timeout, on: eventLoop, logger: logger)
+            execute: { request, eventLoop, logger, metrics in
+                return self.execute(request: request, serviceConfig: serviceConfig, on: eventLoop, logger: logger, metrics: metrics)
             },
             processResponse: { _ in
                 return
             },
             config: serviceConfig,
+            coalesce: true,
             logger: logger,
             on: eventLoop
         )
@@ -318,13 +383,14 @@ extension AWSClient {
                     configuration: serviceConfig
                 )
             },
-            execute: { request, eventLoop, logger in
-                return self.httpClient.execute(request: request, timeout: serviceConfig.timeout, on: eventLoop, logger: logger)
+            execute: { request, eventLoop, logger, metrics in
+                return self.execute(request: request, serviceConfig: serviceConfig, on: eventLoop, logger: logger, metrics: metrics)
             },
             processResponse: { _ in
                 return
             },
             config: serviceConfig,
+            coalesce: true,
             logger: logger,
             on: eventLoop
         )
@@ -357,13 +423,14 @@ extension AWSClient {
                     configuration: serviceConfig
                 )
             },
-            execute: { request, eventLoop, logger in
-                return self.httpClient.execute(request: request, timeout: serviceConfig.timeout, on: eventLoop, logger: logger)
+            execute: { request, eventLoop, logger, metrics in
+                return self.execute(request: request, expecting: Output.self, serviceConfig: serviceConfig, on: eventLoop, logger: logger, metrics: metrics)
             },
             processResponse: { response in
                 return try self.validate(operation: operationName, response: response, serviceConfig: serviceConfig)
             },
             config: serviceConfig,
+            coalesce: true,
             logger: logger,
             on: eventLoop
         )
@@ -399,13 +466,14 @@ extension AWSClient {
                     configuration: serviceConfig
                 )
             },
-            execute: { request, eventLoop, logger in
-                return self.httpClient.execute(request: request, timeout: serviceConfig.timeout, on: eventLoop, logger: logger)
+            execute: { request, eventLoop, logger, metrics in
+                return self.execute(request: request, expecting: Output.self, serviceConfig: serviceConfig, on: eventLoop, logger: logger, metrics: metrics)
             },
             processResponse: { response in
                 return try self.validate(operation: operationName, response: response, serviceConfig: serviceConfig)
             },
             config: serviceConfig,
+            coalesce: true,
             logger: logger,
             on: eventLoop
         )
@@ -442,8 +510,8 @@ extension AWSClient {
                     configuration: serviceConfig
                 )
             },
-            execute: { request, eventLoop, logger in
-                return self.httpClient.execute(request: request, timeout: serviceConfig.timeout, on: eventLoop, logger: logger, stream: stream)
+            execute: { request, eventLoop, logger, metrics in
+                return self.execute(request: request, serviceConfig: serviceConfig, on: eventLoop, logger: logger, metrics: metrics, stream: stream)
             },
             processResponse: { response in
                 return try self.validate(operation: operationName, response: response, serviceConfig: serviceConfig)
@@ -458,30 +526,130 @@ extension AWSClient {
     internal func execute<Output>(
         operation operationName: String,
         createRequest: @escaping () throws -> AWSRequest,
-        execute: @escaping (AWSHTTPRequest, EventLoop, Logger) -> EventLoopFuture<AWSHTTPResponse>,
+        execute: @escaping (AWSHTTPRequest, EventLoop, Logger, RequestStageMetrics?) -> EventLoopFuture<AWSHTTPResponse>,
         processResponse: @escaping (AWSHTTPResponse) throws -> Output,
         config: AWSServiceConfig,
+        coalesce: Bool = false,
         logger: Logger = AWSClient.loggingDisabled,
         on eventLoop: EventLoop? = nil
     ) -> EventLoopFuture<Output> {
         let eventLoop = eventLoop ?? eventLoopGroup.next()
         let logger = logger.attachingRequestId(Self.globalRequestID.add(1), operation: operationName, service: config.service)
+        let coalesceRequest = coalesce && self.options.coalescedOperations[config.service]?.contains(operationName) == true
+        var responseCache: AWSResponseCache?
+        if coalesce, let cache = config.responseCache, cache.timeToLive[operationName] != nil {
+            responseCache = cache
+        }
+        guard coalesceRequest || responseCache != nil else {
+            return self.sendRequest(
+                operation: operationName,
+                createRequest: createRequest,
+                execute: execute,
+                processResponse: processResponse,
+                config: config,
+                logger: logger,
+                on: eventLoop
+            )
+        }
+        // create request up front so identical requests can be found
+        let awsRequest: AWSRequest
+        do {
+            awsRequest = try createRequest()
+        } catch {
+            return eventLoop.makeFailedFuture(error)
+        }
+        let send = {
+            return self.sendRequest(
+                operation: operationName,
+                createRequest: { awsRequest },
+                execute: execute,
+                processResponse: processResponse,
+                config: config,
+                logger: logger,
+                on: eventLoop
+            )
+        }
+        guard let key = SingleFlight.Key(request: awsRequest, outputType: Output.self, byteBufferAllocator: config.byteBufferAllocator) else {
+            return send()
+        }
+        guard let responseCache = responseCache else {
+            guard coalesceRequest else { return send() }
+            return self.singleFlight.execute(key: key, on: eventLoop, send)
+        }
+        self.responseCachesLock.withLockVoid {
+            self.responseCaches[ObjectIdentifier(responseCache)] = responseCache
+        }
+        // outputs are only shared by requests made with the same credentials
+        return self.credentialProvider.getCredential(on: eventLoop, logger: logger).flatMap { credential in
+            let dimensions: [(String, String)] = [("aws-service", config.service), ("aws-operation", operationName)]
+            let cacheKey = AWSResponseCache.Key(client: self.responseCacheID, credential: credential.accessKeyId, request: key)
+            if let output = responseCache.output(for: cacheKey, type: Output.self) {
+                Counter(label: "aws_response_cache_hits", dimensions: dimensions).increment()
+                logger.trace("AWS Response cache hit")
+                return eventLoop.makeSucceededFuture(output)
+            }
+            Counter(label: "aws_response_cache_misses", dimensions: dimensions).increment()
+            let sendCaching = {
+                return send().map { output -> Output in
+                    responseCache.set(output, for: cacheKey, operation: operationName)
+                    return output
+                }
+            }
+            guard coalesceRequest else { return sendCaching() }
+            return self.singleFlight.execute(key: key, on: eventLoop, sendCaching)
+        }
+    }
+
+    /// Sign and send request, and process the response
+    private func sendRequest<Output>(
+        operation operationName: String,
+        createRequest: @escaping () throws -> AWSRequest,
+        execute: @escaping (AWSHTTPRequest, EventLoop, Logger, RequestStageMetrics?) -> EventLoopFuture<AWSHTTPResponse>,
+        processResponse: @escaping (AWSHTTPResponse) throws -> Output,
+        config: AWSServiceConfig,
+        logger: Logger,
+        on eventLoop: EventLoop
+    ) -> EventLoopFuture<Output> {
+        let metrics = self.options.recordStageMetrics ? RequestStageMetrics(service: config.service, operation: operationName) : nil
         // get credentials
-        let future: EventLoopFuture<Output> = credentialProvider.getCredential(on: eventLoop, logger: logger)
+        func getCredential() -> EventLoopFuture<Credential> {
+            let credentialStartTime = RequestStageMetrics.now()
+            return self.credentialProvider.getCredential(on: eventLoop, logger: logger).map { credential in
+                metrics?.record(.credential, since: credentialStartTime)
+                return credential
+            }
+        }
+        // if the retry policy limits the rate requests are sent then wait before signing, so the signature is fresh
+        let credential: EventLoopFuture<Credential>
+        if let retryPolicy = self.retryPolicy as? RetryQuotaPolicy {
+            credential = retryPolicy.waitToSend(service: config.service, on: eventLoop).flatMap { getCredential() }
+        } else {
+            credential = getCredential()
+        }
+        let future: EventLoopFuture<Output> = credential
             .flatMapThrowing { credential -> AWSHTTPRequest in
                 // construct signer
-                let signer = AWSSigner(credentials: credential, name: config.signingName, region: config.region.rawValue)
+                let signer = AWSSigner(credentials: credential, name: config.signingName, region: config.region.rawValue, signingKeyCache: self.signingKeyCache)
                 // create request and sign with signer
                 let awsRequest = try createRequest()
-                return try awsRequest
                     .applyMiddlewares(config.middlewares + self.middlewares, config: config)
-                    .createHTTPRequest(signer: signer, byteBufferAllocator: config.byteBufferAllocator)
+                let signingStartTime = RequestStageMetrics.now()
+                let request = try awsRequest.createHTTPRequest(
+                    signer: signer,
+                    serviceOptions: config.options,
+                    s3ChunkedUpload: self.options.s3ChunkedUpload,
+                    bufferPool: self.s3ChunkedUploadBufferPool,
+                    byteBufferAllocator: config.byteBufferAllocator
+                )
+                metrics?.record(.signing, since: signingStartTime)
+                return request
             }.flatMap { request -> EventLoopFuture<Output> in
                 // send request to AWS and process result
                 let streaming: Bool
                 switch request.body.payload {
-                case .stream:
-                    streaming = true
+                case .stream(let reader):
+                    // readers that can restart from the beginning can be retried
+                    streaming = !(reader is RestartableStreamReader)
                 default:
                     streaming = false
                 }
@@ -489,7 +657,8 @@ extension AWSClient {
                     with: config,
                     eventLoop: eventLoop,
                     logger: logger,
-                    request: { eventLoop in execute(request, eventLoop, logger) },
+                    metrics: metrics,
+                    request: { eventLoop in execute(request, eventLoop, logger, metrics) },
                     processResponse: processResponse,
                     streaming: streaming
                 )
@@ -497,6 +666,65 @@ extension AWSClient {
         return recordRequest(future, service: config.service, operation: operationName, logger: logger)
     }
 
+    /// Execute HTTP request for an operation that returns an output shape. If the output shape is decoded from an XML body,
+    /// the HTTP client is asked to parse the XML while the response is being received
+    func execute<Output: AWSDecodableShape>(
+        request: AWSHTTPRequest,
+        expecting: Output.Type,
+        serviceConfig: AWSServiceConfig,
+        on eventLoop: EventLoop,
+        logger: Logger,
+        metrics: RequestStageMetrics? = nil
+    ) -> EventLoopFuture<AWSHTTPResponse> {
+        let raw = (Output.self as? AWSShapeWithPayload.Type)?._payloadOptions.contains(.raw) == true
+        switch serviceConfig.serviceProtocol {
+        case .restxml, .query, .ec2:
+            if let httpClient = self.httpClient as? AsyncHTTPClient.HTTPClient {
+                if self.canDecodeXMLDocument(Output.self, serviceConfig: serviceConfig) {
+                    return httpClient.executeWithXMLResponse(request: request, output: .document, timeout: serviceConfig.timeout, on: eventLoop, logger: logger, metrics: metrics)
+                }
+                if !raw {
+                    return httpClient.executeWithXMLResponse(request: request, output: .element, timeout: serviceConfig.timeout, on: eventLoop, logger: logger, metrics: metrics)
+                }
+            } else if !raw {
+                return self.httpClient.executeWithXMLResponse(request: request, timeout: serviceConfig.timeout, on: eventLoop, logger: logger)
+            }
+        case .json, .restjson:
+            break
+        }
+        return self.execute(request: request, serviceConfig: serviceConfig, on: eventLoop, logger: logger, metrics: metrics)
+    }
+
+    /// Execute HTTP request. Metrics for the response are only recorded if the HTTP client is an AsyncHTTPClient
+    func execute(
+        request: AWSHTTPRequest,
+        serviceConfig: AWSServiceConfig,
+        on eventLoop: EventLoop,
+        logger: Logger,
+        metrics: RequestStageMetrics?,
+        stream: AWSHTTPClient.ResponseStream? = nil
+    ) -> EventLoopFuture<AWSHTTPResponse> {
+        if let metrics = metrics, let httpClient = self.httpClient as? AsyncHTTPClient.HTTPClient {
+            if let stream = stream {
+                return httpClient.execute(request: request, timeout: serviceConfig.timeout, on: eventLoop, logger: logger, stream: stream, metrics: metrics)
+            }
+            return httpClient.execute(request: request, timeout: serviceConfig.timeout, on: eventLoop, logger: logger, metrics: metrics)
+        }
+        if let stream = stream {
+            return self.httpClient.execute(request: request, timeout: serviceConfig.timeout, on: eventLoop, logger: logger, stream: stream)
+        }
+        return self.httpClient.execute(request: request, timeout: serviceConfig.timeout, on: eventLoop, logger: logger)
+    }
+
+    /// Can output shape be decoded straight from the parsed XML with `XMLStreamingDecoder`. This requires everything
+    /// in the output shape to come from the XML body and no middleware that might want to edit the response
+    func canDecodeXMLDocument<Output: AWSDecodableShape>(_ type: Output.Type, serviceConfig: AWSServiceConfig) -> Bool {
+        return !(Output.self is AWSShapeWithPayload.Type)
+            && Output._encoding.isEmpty
+            && serviceConfig.middlewares.isEmpty
+            && self.middlewares.isEmpty
+    }
+
     /// Generate a signed URL
     /// - parameters:
     ///     - url : URL to sign
@@ -554,7 +782,7 @@ extension AWSClient {
 
     func createSigner(serviceConfig: AWSServiceConfig, logger: Logger) -> EventLoopFuture<AWSSigner> {
         return credentialProvider.getCredential(on: eventLoopGroup.next(), logger: logger).map { credential in
-            return AWSSigner(credentials: credential, name: serviceConfig.signingName, region: serviceConfig.region.rawValue)
+            return AWSSigner(credentials: credential, name: serviceConfig.signingName, region: serviceConfig.region.rawValue, signingKeyCache: self.signingKeyCache)
         }
     }
 }
@@ -565,6 +793,11 @@ extension AWSClient {
     internal func validate<Output: AWSDecodableShape>(operation operationName: String, response: AWSHTTPResponse, serviceConfig: AWSServiceConfig) throws -> Output {
         assert((200..<300).contains(response.status.code), "Shouldn't get here if error was returned")
 
+        // body may have already been parsed for decoding with XMLStreamingDecoder
+        if let parsedResponse = response as? AWSParsedXMLHTTPResponse, let document = parsedResponse.document {
+            return try AWSResponse.generateOutputShape(operation: operationName, from: document)
+        }
+
         let raw = (Output.self as? AWSShapeWithPayload.Type)?._payloadOptions.contains(.raw) == true
         let awsResponse = try AWSResponse(from: response, serviceProtocol: serviceConfig.serviceProtocol, raw: raw)
             .applyMiddlewares(serviceConfig.middlewares + middlewares, config: serviceConfig)
@@ -602,21 +835,35 @@ extension AWSClient {
         with serviceConfig: AWSServiceConfig,
         eventLoop: EventLoop,
         logger: Logger,
+        metrics: RequestStageMetrics?,
         request: @escaping (EventLoop) -> EventLoopFuture<AWSHTTPResponse>,
         processResponse: @escaping (AWSHTTPResponse) throws -> Output,
         streaming: Bool
     ) -> EventLoopFuture<Output> {
         let promise = eventLoop.makePromise(of: Output.self)
+        let retryQuotaPolicy = self.retryPolicy as? RetryQuotaPolicy
 
-        func execute(attempt: Int) {
+        func execute(attempt: Int, retryTokens: Int?) {
             // execute HTTP request
             _ = request(eventLoop)
+                .flatMapErrorThrowing { (error) -> AWSHTTPResponse in
+                    // attempts that fail without a response, eg connection errors and timeouts, are completed too
+                    retryQuotaPolicy?.attemptCompleted(service: serviceConfig.service, error: error)
+                    throw error
+                }
                 .flatMapThrowing { (response) throws -> Void in
                     // if it returns an HTTP status code outside 2xx then throw an error
                     guard (200..<300).contains(response.status.code) else {
-                        throw self.createError(for: response, serviceConfig: serviceConfig, logger: logger)
+                        let error = self.createError(for: response, serviceConfig: serviceConfig, logger: logger)
+                        retryQuotaPolicy?.attemptCompleted(service: serviceConfig.service, error: error)
+                        throw error
                     }
+                    retryQuotaPolicy?.attemptCompleted(service: serviceConfig.service, error: nil)
+                    retryQuotaPolicy?.releaseRetryTokens(retryTokens)
+                    let decodeStartTime = RequestStageMetrics.now()
                     let output = try processResponse(response)
+                    metrics?.record(.decode, since: decodeStartTime)
+                    metrics?.recordAttempts(attempt + 1)
                     promise.succeed(output)
                 }
                 .flatMapErrorThrowing { (error) -> Void in
@@ -625,25 +872,50 @@ extension AWSClient {
                     if streaming,
                        error is AWSErrorType || error is AWSRawError
                     {
+                        metrics?.recordAttempts(attempt + 1)
                         promise.fail(error)
                         return
                     }
                     // If I get a retry wait time for this error then attempt to retry request
                     if case .retry(let retryTime) = self.retryPolicy.getRetryWaitTime(error: error, attempt: attempt) {
+                        // retry policies with a retry quota only retry if there are tokens left in the quota
+                        var retryTokens: Int?
+                        if let retryQuotaPolicy = retryQuotaPolicy {
+                            guard let tokens = retryQuotaPolicy.acquireRetryTokens(error: error) else {
+                                logger.trace("Retry quota exhausted")
+                                metrics?.recordAttempts(attempt + 1)
+                                promise.fail(error)
+                                return
+                            }
+                            retryTokens = tokens
+                        }
                         logger.trace("Retrying request", metadata: [
                             "aws-retry-time": "\(Double(retryTime.nanoseconds) / 1_000_000_000)",
                         ])
                         // schedule task for retrying AWS request
                         eventLoop.scheduleTask(in: retryTime) {
-                            execute(attempt: attempt + 1)
+                            if let retryQuotaPolicy = retryQuotaPolicy {
+                                retryQuotaPolicy.waitToSend(service: serviceConfig.service, on: eventLoop).whenComplete { result in
+                                    switch result {
+                                    case .success:
+                                        execute(attempt: attempt + 1, retryTokens: retryTokens)
+                                    case .failure(let error):
+                                        metrics?.recordAttempts(attempt + 1)
+                                        promise.fail(error)
+                                    }
+                                }
+                            } else {
+                                execute(attempt: attempt + 1, retryTokens: retryTokens)
+                            }
                         }
                     } else {
+                        metrics?.recordAttempts(attempt + 1)
                         promise.fail(error)
                     }
                 }
         }
 
-        execute(attempt: 0)
+        execute(attempt: 0, retryTokens: nil)
 
         return promise.futureResult
     }
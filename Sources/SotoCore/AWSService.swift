@@ -77,19 +77,22 @@ extension AWSService {
     ///   - timeout: Time out value for HTTP requests
     ///   - byteBufferAllocator: byte buffer allocator used throughout AWSClient
     ///   - options: options used by client when processing requests
+    ///   - responseCache: cache of decoded outputs for read-mostly operations
     /// - Returns: New version of the service
     public func with(
         middlewares: [AWSServiceMiddleware] = [],
         timeout: TimeAmount? = nil,
         byteBufferAllocator: ByteBufferAllocator? = nil,
-        options: AWSServiceConfig.Options? = nil
+        options: AWSServiceConfig.Options? = nil,
+        responseCache: AWSResponseCache? = nil
     ) -> Self {
         return Self(from: self, patch: .init(
             region: region,
             middlewares: middlewares,
             timeout: timeout,
             byteBufferAllocator: byteBufferAllocator,
-            options: options
+            options: options,
+            responseCache: responseCache
         ))
     }
 
@@ -100,20 +103,23 @@ extension AWSService {
     ///   - timeout: Time out value for HTTP requests
     ///   - byteBufferAllocator: byte buffer allocator used throughout AWSClient
     ///   - options: options used by client when processing requests
+    ///   - responseCache: cache of decoded outputs for read-mostly operations
     /// - Returns: New version of the service
     public func with(
         region: Region,
         middlewares: [AWSServiceMiddleware] = [],
         timeout: TimeAmount? = nil,
         byteBufferAllocator: ByteBufferAllocator? = nil,
-        options: AWSServiceConfig.Options? = nil
+        options: AWSServiceConfig.Options? = nil,
+        responseCache: AWSResponseCache? = nil
     ) -> Self {
         return Self(from: self, patch: .init(
             region: region,
             middlewares: middlewares,
             timeout: timeout,
             byteBufferAllocator: byteBufferAllocator,
-            options: options
+            options: options,
+            responseCache: responseCache
         ))
     }
 }
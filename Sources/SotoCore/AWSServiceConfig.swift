@@ -40,6 +40,8 @@ public final class AWSServiceConfig {
     public let byteBufferAllocator: ByteBufferAllocator
     /// options
     public let options: Options
+    /// cache of decoded outputs for read-mostly operations
+    public let responseCache: AWSResponseCache?
     /// values used to create endpoint
     private let providedEndpoint: String?
     private let serviceEndpoints: [String: String]
@@ -63,6 +65,7 @@ public final class AWSServiceConfig {
     ///   - timeout: Time out value for HTTP requests
     ///   - byteBufferAllocator: byte buffer allocator used throughout AWSClient
     ///   - options: options used by client when processing requests
+    ///   - responseCache: cache of decoded outputs for read-mostly operations
     public init(
         region: Region?,
         partition: AWSPartition,
@@ -78,7 +81,8 @@ public final class AWSServiceConfig {
         middlewares: [AWSServiceMiddleware] = [],
         timeout: TimeAmount? = nil,
         byteBufferAllocator: ByteBufferAllocator = ByteBufferAllocator(),
-        options: Options = []
+        options: Options = [],
+        responseCache: AWSResponseCache? = nil
     ) {
         var partition = partition
         if let region = region {
@@ -102,6 +106,7 @@ public final class AWSServiceConfig {
         self.timeout = timeout ?? .seconds(20)
         self.byteBufferAllocator = byteBufferAllocator
         self.options = options
+        self.responseCache = responseCache
 
         self.providedEndpoint = endpoint
         self.serviceEndpoints = serviceEndpoints
@@ -156,19 +161,22 @@ public final class AWSServiceConfig {
         let timeout: TimeAmount?
         let byteBufferAllocator: ByteBufferAllocator?
         let options: Options?
+        let responseCache: AWSResponseCache?
 
         init(
             region: Region? = nil,
             middlewares: [AWSServiceMiddleware] = [],
             timeout: TimeAmount? = nil,
             byteBufferAllocator: ByteBufferAllocator? = nil,
-            options: AWSServiceConfig.Options? = nil
+            options: AWSServiceConfig.Options? = nil,
+            responseCache: AWSResponseCache? = nil
         ) {
             self.region = region
             self.middlewares = middlewares
             self.timeout = timeout
             self.byteBufferAllocator = byteBufferAllocator
             self.options = options
+            self.responseCache = responseCache
         }
     }
 
@@ -190,6 +198,15 @@ public final class AWSServiceConfig {
 
         /// Use S3 transfer accelerated endpoint. You need to enable transfer acceleration on the bucket for this to work
         public static let s3UseTransferAcceleratedEndpoint = Options(rawValue: 1 << 2)
+
+        /// Don't calculate a SHA256 hash of S3 request bodies. The body is signed as "UNSIGNED-PAYLOAD". This is only used when
+        /// connecting over HTTPS, where TLS already protects the integrity of the body
+        public static let s3UnsignedPayload = Options(rawValue: 1 << 3)
+
+        /// Upload S3 request bodies using aws-chunked encoding with unsigned chunks and a CRC32 checksum sent as a trailing
+        /// header. The checksum is calculated as the body is written instead of before the request is sent. This is only
+        /// used when connecting over HTTPS and takes precedence over `s3UnsignedPayload`
+        public static let s3TrailingChecksum = Options(rawValue: 1 << 4)
     }
 
     private init(
@@ -222,5 +239,6 @@ public final class AWSServiceConfig {
         self.timeout = patch.timeout ?? service.timeout
         self.byteBufferAllocator = patch.byteBufferAllocator ?? service.byteBufferAllocator
         self.options = patch.options ?? service.options
+        self.responseCache = patch.responseCache ?? service.responseCache
     }
 }
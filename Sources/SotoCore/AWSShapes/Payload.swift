@@ -35,12 +35,16 @@ public struct AWSPayload {
 
     /// construct a payload from a stream function. If you supply a size the stream function will be called repeated until you supply the number of bytes specified. If you
     /// don't supply a size the stream function will be called repeatedly until you supply an empty `ByteBuffer`
+    ///
+    /// When uploading to S3 the stream is split into signed chunks. `chunkSize` sets the size of these chunks, it defaults to 64K and sizes smaller
+    /// than the S3 minimum of 8K are rounded up to 8K. Larger chunks reduce the signing and chunk header overhead on fast connections.
     public static func stream(
         size: Int? = nil,
+        chunkSize: Int? = nil,
         byteBufferAllocator: ByteBufferAllocator = ByteBufferAllocator(),
         stream: @escaping (EventLoop) -> EventLoopFuture<StreamReaderResult>
     ) -> Self {
-        return AWSPayload(payload: .stream(ChunkedStreamReader(size: size, read: stream, byteBufferAllocator: byteBufferAllocator)))
+        return AWSPayload(payload: .stream(ChunkedStreamReader(size: size, chunkSize: chunkSize, read: stream, byteBufferAllocator: byteBufferAllocator)))
     }
 
     /// construct an empty payload
@@ -68,6 +72,7 @@ public struct AWSPayload {
     ///   - offset: optional offset into file. If not set it will use the current position in the file
     ///   - size: size of block to load from file
     ///   - fileIO: NonBlockingFileIO object
+    ///   - chunkSize: Size of blocks loaded from file, and size of chunks used by S3 chunked uploads
     ///   - byteBufferAllocator: ByteBufferAllocator used during request upload
     ///   - callback: Progress callback called during upload
     public static func fileHandle(
@@ -75,11 +80,12 @@ public struct AWSPayload {
         offset: Int? = nil,
         size: Int? = nil,
         fileIO: NonBlockingFileIO,
+        chunkSize: Int? = nil,
         byteBufferAllocator: ByteBufferAllocator = ByteBufferAllocator(),
         callback: @escaping (Int) throws -> Void = { _ in }
     ) -> Self {
         // use chunked reader buffer size to avoid allocating additional buffers when streaming data
-        let blockSize = S3ChunkedStreamReader.bufferSize
+        let blockSize = chunkSize ?? S3ChunkedStreamReader.bufferSize
         var leftToRead = size
         var readSoFar: Int = 0
         func stream(_ eventLoop: EventLoop) -> EventLoopFuture<StreamReaderResult> {
@@ -126,7 +132,7 @@ public struct AWSPayload {
             }
         }
 
-        return AWSPayload(payload: .stream(ChunkedStreamReader(size: size.map { Int($0) }, read: stream, byteBufferAllocator: byteBufferAllocator)))
+        return AWSPayload(payload: .stream(ChunkedStreamReader(size: size.map { Int($0) }, chunkSize: chunkSize, read: stream, byteBufferAllocator: byteBufferAllocator)))
     }
 
     /// construct a payload from a stream reader object.
@@ -0,0 +1,89 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the Soto for AWS open source project
+//
+// Copyright (c) 2017-2020 the Soto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.txt for the list of Soto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import NIO
+import NIOConcurrencyHelpers
+#if os(Linux)
+import Glibc
+#else
+import Darwin.C
+#endif
+
+/// Process wide cache of the AWS config and credentials files, so every `AWSClient` created in a process shares one read
+/// and parse of each file. Entries are keyed by path, and are replaced when the file's modification time, size or inode
+/// changes.
+final class ConfigFileCache {
+    static let shared = ConfigFileCache()
+
+    /// File status that has to match for a cached file to be used
+    struct FileStatus: Equatable {
+        let modificationSeconds: Int
+        let modificationNanoseconds: Int
+        let size: Int
+        let inode: UInt64
+    }
+
+    private var files: [String: (status: FileStatus, file: INIFile)] = [:]
+    private let lock = Lock()
+
+    /// Return the cached file if its status is unchanged, otherwise load and cache it
+    /// - Parameters:
+    ///   - path: file path
+    ///   - eventLoop: event loop to run everything on
+    ///   - threadPool: thread pool to get the file status on
+    ///   - fileIO: non-blocking file IO to load the file with
+    func file(
+        path: String,
+        on eventLoop: EventLoop,
+        threadPool: NIOThreadPool,
+        using fileIO: NonBlockingFileIO
+    ) -> EventLoopFuture<INIFile> {
+        let path = ConfigFileLoader.expandTildeInFilePath(path)
+        return threadPool.runIfActive(eventLoop: eventLoop) { try Self.status(of: path) }
+            .flatMap { status in
+                if let cached = self.lock.withLock({ self.files[path] }), cached.status == status {
+                    return eventLoop.makeSucceededFuture(cached.file)
+                }
+                return ConfigFileLoader.loadFile(path: path, on: eventLoop, using: fileIO).map { buffer in
+                    let file = INIFile(buffer)
+                    self.lock.withLockVoid { self.files[path] = (status: status, file: file) }
+                    return file
+                }
+            }
+    }
+
+    /// Remove all cached files
+    func removeAll() {
+        self.lock.withLockVoid { self.files = [:] }
+    }
+
+    /// Get status of file. Throws an `IOError` if the file cannot be found
+    static func status(of path: String) throws -> FileStatus {
+        var fileStat = stat()
+        guard stat(path, &fileStat) == 0 else {
+            throw IOError(errnoCode: errno, reason: "stat")
+        }
+        #if os(Linux)
+        let modificationTime = fileStat.st_mtim
+        #else
+        let modificationTime = fileStat.st_mtimespec
+        #endif
+        return FileStatus(
+            modificationSeconds: Int(modificationTime.tv_sec),
+            modificationNanoseconds: Int(modificationTime.tv_nsec),
+            size: Int(fileStat.st_size),
+            inode: UInt64(fileStat.st_ino)
+        )
+    }
+}
@@ -13,7 +13,6 @@
 //===----------------------------------------------------------------------===//
 
 import struct Foundation.UUID
-import INIParser
 import Logging
 import NIO
 #if os(Linux)
@@ -84,7 +83,8 @@ enum ConfigFileLoader {
 
     // MARK: - File IO
 
-    /// Load credentials from disk
+    /// Load credentials from disk. Files are loaded through `ConfigFileCache.shared`, so they are only read and parsed
+    /// again if they have changed
     /// - Parameters:
     ///   - credentialsFilePath: file path for AWS credentials file
     ///   - configFilePath: file path for AWS config file
@@ -101,25 +101,27 @@ enum ConfigFileLoader {
         threadPool.start()
         let fileIO = NonBlockingFileIO(threadPool: threadPool)
 
+        let cache = ConfigFileCache.shared
+
         // Load credentials file
-        return self.loadFile(path: credentialsFilePath, on: context.eventLoop, using: fileIO)
-            .flatMap { credentialsByteBuffer in
+        return cache.file(path: credentialsFilePath, on: context.eventLoop, threadPool: threadPool, using: fileIO)
+            .flatMap { credentialsFile in
                 // Load profile config file
-                return loadFile(path: configFilePath, on: context.eventLoop, using: fileIO)
+                return cache.file(path: configFilePath, on: context.eventLoop, threadPool: threadPool, using: fileIO)
                     .map {
-                        (credentialsByteBuffer, $0)
+                        (credentialsFile, $0)
                     }
                     .flatMapError { _ in
                         // Recover from error if profile config file does not exist
-                        context.eventLoop.makeSucceededFuture((credentialsByteBuffer, nil))
+                        context.eventLoop.makeSucceededFuture((credentialsFile, nil))
                     }
             }
             .flatMapErrorThrowing { _ in
                 // Throw `.noProvider` error if credential file cannot be loaded
                 throw CredentialProviderError.noProvider
             }
-            .flatMapThrowing { credentialsByteBuffer, configByteBuffer in
-                return try parseSharedCredentials(from: credentialsByteBuffer, configByteBuffer: configByteBuffer, for: profile)
+            .flatMapThrowing { credentialsFile, configFile in
+                return try parseSharedCredentials(from: credentialsFile, configFile: configFile, for: profile)
             }
             .always { _ in
                 // shutdown the threadpool async
@@ -149,7 +151,7 @@ enum ConfigFileLoader {
             }
     }
 
-    // MARK: - Byte Buffer parsing (INIParser)
+    // MARK: - Byte Buffer parsing (INIFile)
 
     /// Parse credentials from files (passed in as byte-buffers).
     /// This method ensures credentials are valid according to AWS documentation.
@@ -163,8 +165,13 @@ enum ConfigFileLoader {
     ///   - profile: named profile to load (optional)
     /// - Returns: Parsed SharedCredentials
     static func parseSharedCredentials(from credentialsByteBuffer: ByteBuffer, configByteBuffer: ByteBuffer?, for profile: String) throws -> SharedCredentials {
-        let config = try configByteBuffer.flatMap { try parseProfileConfig(from: $0, for: profile) }
-        let credentials = try parseCredentials(from: credentialsByteBuffer, for: profile, sourceProfile: config?.sourceProfile)
+        return try self.parseSharedCredentials(from: INIFile(credentialsByteBuffer), configFile: configByteBuffer.map { INIFile($0) }, for: profile)
+    }
+
+    /// Parse credentials from files. See `parseSharedCredentials(from:configByteBuffer:for:)`
+    static func parseSharedCredentials(from credentialsFile: INIFile, configFile: INIFile?, for profile: String) throws -> SharedCredentials {
+        let config = try configFile.flatMap { try parseProfileConfig(from: $0, for: profile) }
+        let credentials = try parseCredentials(from: credentialsFile, for: profile, sourceProfile: config?.sourceProfile)
 
         // If `role_arn` is defined, check for source profile or credential source
         if let roleArn = credentials.roleArn ?? config?.roleArn {
@@ -217,20 +224,25 @@ enum ConfigFileLoader {
     ///   - profile: AWS named profile to load (usually `default`)
     /// - Returns: Combined profile settings
     static func parseProfileConfig(from byteBuffer: ByteBuffer, for profile: String) throws -> ProfileConfig? {
-        guard let content = byteBuffer.getString(at: 0, length: byteBuffer.readableBytes),
-              let parser = try? INIParser(content)
-        else {
-            throw ConfigFileError.invalidCredentialFile
-        }
+        return try self.parseProfileConfig(from: INIFile(byteBuffer), for: profile)
+    }
 
+    /// Parse profile configuration from a file. See `parseProfileConfig(from:for:)`
+    static func parseProfileConfig(from file: INIFile, for profile: String) throws -> ProfileConfig? {
         // The credentials file uses a different naming format than the CLI config file for named profiles. Include
         // the prefix word "profile" only when configuring a named profile in the config file. Do not use the word
         // profile when creating an entry in the credentials file.
         // https://docs.aws.amazon.com/cli/latest/userguide/cli-configure-profiles.html
         let loadedProfile = profile == ConfigFile.defaultProfile ? profile : "profile \(profile)"
 
+        let section: [String: String]?
+        do {
+            section = try file.section(loadedProfile)
+        } catch {
+            throw ConfigFileError.invalidCredentialFile
+        }
         // Gracefully fail if there is no configuration for the given profile
-        guard let settings = parser.sections[loadedProfile] else {
+        guard let settings = section else {
             return nil
         }
 
@@ -252,13 +264,20 @@ enum ConfigFileLoader {
     ///   - sourceProfile: specifies a named profile with long-term credentials that the AWS CLI can use to assume a role that you specified with the `role_arn` parameter.
     /// - Returns: Combined profile credentials
     static func parseCredentials(from byteBuffer: ByteBuffer, for profile: String, sourceProfile: String?) throws -> ProfileCredentials {
-        guard let content = byteBuffer.getString(at: 0, length: byteBuffer.readableBytes),
-              let parser = try? INIParser(content)
-        else {
+        return try self.parseCredentials(from: INIFile(byteBuffer), for: profile, sourceProfile: sourceProfile)
+    }
+
+    /// Parse profile credentials from a file. See `parseCredentials(from:for:sourceProfile:)`
+    static func parseCredentials(from file: INIFile, for profile: String, sourceProfile: String?) throws -> ProfileCredentials {
+        // only scan the file for the profile and the source profile
+        let sections: [String: [String: String]]
+        do {
+            sections = try file.sections([profile] + (sourceProfile.map { [$0] } ?? []))
+        } catch {
             throw ConfigFileError.invalidCredentialFile
         }
 
-        guard let settings = parser.sections[profile] else {
+        guard let settings = sections[profile] else {
             throw ConfigFileError.missingProfile(profile)
         }
 
@@ -269,7 +288,7 @@ enum ConfigFileLoader {
         // If a source profile is indicated, load credentials for STS Assume Role operation.
         // Credentials file settings have precedence over profile configuration settings.
         if let sourceProfile = settings["source_profile"] ?? sourceProfile {
-            guard let sourceSettings = parser.sections[sourceProfile] else {
+            guard let sourceSettings = try sections[sourceProfile] ?? file.section(sourceProfile) else {
                 throw ConfigFileError.missingProfile(sourceProfile)
             }
             accessKey = sourceSettings["aws_access_key_id"]
@@ -19,9 +19,16 @@ import SotoSignerV4
 public protocol ExpiringCredential: Credential {
     /// Will credential expire within a certain time
     func isExpiring(within: TimeInterval) -> Bool
+    /// Date credential expires, if known. `RotatingCredentialProvider` uses this to refresh credentials in the background
+    var expirationDate: Date? { get }
 }
 
 public extension ExpiringCredential {
+    /// Expiration date is unknown
+    var expirationDate: Date? {
+        return nil
+    }
+
     /// Has credential expired
     var isExpired: Bool {
         isExpiring(within: 0)
@@ -42,6 +49,11 @@ public struct RotatingCredential: ExpiringCredential {
         return self.expiration.timeIntervalSinceNow < interval
     }
 
+    /// Date credential expires
+    public var expirationDate: Date? {
+        return self.expiration
+    }
+
     public let accessKeyId: String
     public let secretAccessKey: String
     public let sessionToken: String?
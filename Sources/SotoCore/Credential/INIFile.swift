@@ -0,0 +1,183 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the Soto for AWS open source project
+//
+// Copyright (c) 2017-2020 the Soto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.txt for the list of Soto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import NIO
+import NIOConcurrencyHelpers
+
+/// Contents of an INI file, with the settings of the sections that have been looked up.
+///
+/// Sections are found by scanning the bytes of the file, following the same syntax rules as `INIParser`. Every line is
+/// checked, so a file is rejected if `INIParser` would reject it, but strings are only created for the settings of
+/// the sections asked for. Lines may end in "\r\n".
+final class INIFile {
+    enum Error: Swift.Error {
+        case invalidSyntax
+    }
+
+    let contents: ByteBuffer
+    /// sections already looked up. nil if the section has no settings
+    private var sections: [String: [String: String]?] = [:]
+    private let lock = Lock()
+
+    init(_ contents: ByteBuffer) {
+        self.contents = contents
+    }
+
+    /// Return settings of section, nil if it doesn't exist. Throws `INIFile.Error.invalidSyntax` if the file is invalid
+    func section(_ name: String) throws -> [String: String]? {
+        return try self.sections([name])[name]
+    }
+
+    /// Return settings of the named sections that exist. Throws `INIFile.Error.invalidSyntax` if the file is invalid
+    func sections(_ names: [String]) throws -> [String: [String: String]] {
+        return try self.lock.withLock {
+            let missingNames = names.filter { self.sections[$0] == nil }
+            if !missingNames.isEmpty {
+                let scanned = try Self.scan(self.contents, for: missingNames)
+                for name in missingNames {
+                    self.sections[name] = .some(scanned[name])
+                }
+            }
+            var result: [String: [String: String]] = [:]
+            for name in names {
+                if case .some(.some(let settings)) = self.sections[name] {
+                    result[name] = settings
+                }
+            }
+            return result
+        }
+    }
+
+    // MARK: Scanner
+
+    private enum State {
+        case title, variable, value, singleQuotation, doubleQuotation
+    }
+
+    private enum Line {
+        case none, section, assignment
+    }
+
+    private static let newline = UInt8(ascii: "\n")
+    private static let carriageReturn = UInt8(ascii: "\r")
+
+    /// Scan file for the settings of the named sections. As with `INIParser`, sections without settings are not returned
+    static func scan(_ buffer: ByteBuffer, for names: [String]) throws -> [String: [String: String]] {
+        return try buffer.withUnsafeReadableBytes { bytes in
+            var result: [String: [String: String]] = [:]
+            var cache: [UInt8] = []
+            var variable: [UInt8] = []
+            var stack: [State] = []
+            var currentSection: String?
+
+            var lineStart = bytes.startIndex
+            while lineStart < bytes.endIndex {
+                let lineEnd = bytes[lineStart...].firstIndex(of: Self.newline) ?? bytes.endIndex
+                var contentEnd = lineEnd
+                if contentEnd > lineStart, bytes[contentEnd - 1] == Self.carriageReturn {
+                    contentEnd -= 1
+                }
+                // empty lines are skipped
+                if contentEnd > lineStart {
+                    switch try self.parse(line: bytes[lineStart..<contentEnd], cache: &cache, variable: &variable, stack: &stack) {
+                    case .section:
+                        currentSection = names.first { $0.utf8.elementsEqual(cache) }
+                    case .assignment:
+                        if let section = currentSection {
+                            result[section, default: [:]][String(decoding: variable, as: UTF8.self)] = String(decoding: cache, as: UTF8.self)
+                        }
+                    case .none:
+                        break
+                    }
+                }
+                lineStart = lineEnd + 1
+            }
+            return result
+        }
+    }
+
+    /// Parse one line, following the rules of `INIParser.parse(line:)`. A section title or setting value is left in
+    /// `cache` and the setting name in `variable`
+    private static func parse(
+        line: Slice<UnsafeRawBufferPointer>,
+        cache: inout [UInt8],
+        variable: inout [UInt8],
+        stack: inout [State]
+    ) throws -> Line {
+        cache.removeAll(keepingCapacity: true)
+        variable.removeAll(keepingCapacity: true)
+        stack.removeAll(keepingCapacity: true)
+        var hasVariable = false
+        var state = State.variable
+
+        for c in line {
+            switch c {
+            case UInt8(ascii: " "), UInt8(ascii: "\t"):
+                if state == .singleQuotation || state == .doubleQuotation || state == .title {
+                    cache.append(c)
+                }
+            case UInt8(ascii: "["):
+                if state == .variable {
+                    cache.removeAll(keepingCapacity: true)
+                    stack.append(state)
+                    state = .title
+                }
+            case UInt8(ascii: "]"):
+                if state == .title {
+                    guard let last = stack.popLast() else { throw Error.invalidSyntax }
+                    state = last
+                    return .section
+                }
+            case UInt8(ascii: "="):
+                if state == .variable {
+                    swap(&variable, &cache)
+                    cache.removeAll(keepingCapacity: true)
+                    hasVariable = true
+                    state = .value
+                } else {
+                    cache.append(c)
+                }
+            case UInt8(ascii: "#"), UInt8(ascii: ";"):
+                if state == .value {
+                    guard hasVariable else { throw Error.invalidSyntax }
+                    return .assignment
+                } else {
+                    return .none
+                }
+            case UInt8(ascii: "\""):
+                if state == .doubleQuotation {
+                    guard let last = stack.popLast() else { throw Error.invalidSyntax }
+                    state = last
+                } else {
+                    stack.append(state)
+                    state = .doubleQuotation
+                }
+                cache.append(c)
+            case UInt8(ascii: "'"):
+                if state == .singleQuotation {
+                    guard let last = stack.popLast() else { throw Error.invalidSyntax }
+                    state = last
+                } else {
+                    stack.append(state)
+                    state = .singleQuotation
+                }
+                cache.append(c)
+            default:
+                cache.append(c)
+            }
+        }
+        guard state == .value, hasVariable else { throw Error.invalidSyntax }
+        return .assignment
+    }
+}
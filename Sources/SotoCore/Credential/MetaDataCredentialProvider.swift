@@ -13,11 +13,8 @@
 //===----------------------------------------------------------------------===//
 
 import struct Foundation.Date
-import class Foundation.DateFormatter
 import class Foundation.JSONDecoder
-import struct Foundation.Locale
 import struct Foundation.TimeInterval
-import struct Foundation.TimeZone
 import struct Foundation.URL
 
 import Logging
@@ -54,11 +51,14 @@ extension MetaDataClient {
     static func createJSONDecoder() -> JSONDecoder {
         let decoder = JSONDecoder()
         // set JSON decoding strategy for dates
-        let dateFormatter = DateFormatter()
-        dateFormatter.locale = Locale(identifier: "en_US_POSIX")
-        dateFormatter.dateFormat = "yyyy-MM-dd'T'HH:mm:ss'Z'"
-        dateFormatter.timeZone = TimeZone(secondsFromGMT: 0)
-        decoder.dateDecodingStrategy = .formatted(dateFormatter)
+        decoder.dateDecodingStrategy = .custom { decoder in
+            let container = try decoder.singleValueContainer()
+            let value = try container.decode(String.self)
+            guard let date = TimestampFormat.iso8601.date(from: value) else {
+                throw DecodingError.dataCorruptedError(in: container, debugDescription: "Expected date format yyyy-MM-dd'T'HH:mm:ss'Z' but found \"\(value)\"")
+            }
+            return date
+        }
 
         return decoder
     }
@@ -85,6 +85,10 @@ struct ECSMetaDataClient: MetaDataClient {
             return self.expiration.timeIntervalSinceNow < interval
         }
 
+        var expirationDate: Date? {
+            return self.expiration
+        }
+
         enum CodingKeys: String, CodingKey {
             case accessKeyId = "AccessKeyId"
             case secretAccessKey = "SecretAccessKey"
@@ -152,6 +156,10 @@ struct InstanceMetaDataClient: MetaDataClient {
             return self.expiration.timeIntervalSinceNow < interval
         }
 
+        var expirationDate: Date? {
+            return self.expiration
+        }
+
         enum CodingKeys: String, CodingKey {
             case accessKeyId = "AccessKeyId"
             case secretAccessKey = "SecretAccessKey"
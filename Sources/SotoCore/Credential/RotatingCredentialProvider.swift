@@ -12,33 +12,62 @@
 //
 //===----------------------------------------------------------------------===//
 
+import struct Foundation.Date
 import struct Foundation.TimeInterval
 import Logging
 import NIO
 import NIOConcurrencyHelpers
 import SotoSignerV4
+#if os(Linux)
+import Glibc
+#else
+import Darwin.C
+#endif
 
 /// Used for wrapping another credential provider whose `getCredential` method returns an `ExpiringCredential`.
 /// If no credential is available, or the current credentials are going to expire in the near future  the wrapped credential provider
 /// `getCredential` is called. If current credentials have not expired they are returned otherwise we wait on new
 /// credentials being provided.
+///
+/// If `backgroundRefreshMargin` is set, credentials are also refreshed on the provider's `EventLoop` that long before they
+/// expire, while the current credentials continue to be returned. Failed background refreshes are retried with a jittered
+/// exponential backoff, so requests only wait on a refresh if the background refreshes have failed until the credentials
+/// are about to expire. The margin should be longer than `remainingTokenLifetimeForUse`.
 public final class RotatingCredentialProvider: CredentialProvider {
     let remainingTokenLifetimeForUse: TimeInterval
+    let backgroundRefreshMargin: TimeInterval?
 
     public let provider: CredentialProvider
     private let lock = NIOConcurrencyHelpers.Lock()
     private var credential: Credential?
     private var credentialFuture: EventLoopFuture<Credential>?
+    private let eventLoop: EventLoop
+    private let logger: Logger
+    private var backgroundRefresh: Scheduled<Void>?
+    /// number of background refreshes in a row that returned a credential already inside the refresh margin
+    private var staleRefreshCount = 0
+    private var isShutdown = false
 
-    public init(context: CredentialProviderFactory.Context, provider: CredentialProvider, remainingTokenLifetimeForUse: TimeInterval? = nil) {
+    public init(
+        context: CredentialProviderFactory.Context,
+        provider: CredentialProvider,
+        remainingTokenLifetimeForUse: TimeInterval? = nil,
+        backgroundRefreshMargin: TimeInterval? = nil
+    ) {
         self.provider = provider
         self.remainingTokenLifetimeForUse = remainingTokenLifetimeForUse ?? 3 * 60
+        self.backgroundRefreshMargin = backgroundRefreshMargin
+        self.eventLoop = context.eventLoop
+        self.logger = context.logger
         _ = refreshCredentials(on: context.eventLoop, logger: context.logger)
     }
 
     /// Shutdown credential provider
     public func shutdown(on eventLoop: EventLoop) -> EventLoopFuture<Void> {
         return self.lock.withLock {
+            self.isShutdown = true
+            self.backgroundRefresh?.cancel()
+            self.backgroundRefresh = nil
             if let future = credentialFuture {
                 return future.and(provider.shutdown(on: eventLoop)).map { _ in }.hop(to: eventLoop)
             }
@@ -69,9 +98,9 @@ public final class RotatingCredentialProvider: CredentialProvider {
 
     private func refreshCredentials(on eventLoop: EventLoop, logger: Logger) -> EventLoopFuture<Credential> {
         self.lock.lock()
-        defer { self.lock.unlock() }
 
         if let future = credentialFuture {
+            self.lock.unlock()
             // a refresh is already running
             if future.eventLoop !== eventLoop {
                 // We want to hop back to the event loop we came in case
@@ -83,18 +112,74 @@ public final class RotatingCredentialProvider: CredentialProvider {
 
         logger.debug("Refeshing AWS credentials", metadata: ["aws-credential-provider": .string("\(self)")])
 
-        credentialFuture = self.provider.getCredential(on: eventLoop, logger: logger)
-            .map { (credential) -> (Credential) in
-                // update the internal credential locked
-                self.lock.withLock {
+        let future = self.provider.getCredential(on: eventLoop, logger: logger)
+        self.credentialFuture = future
+        self.lock.unlock()
+
+        // The future may already be complete, in which case this runs straight away, so it must be added outside the lock.
+        // It is added before the future is returned so the credential is stored before anyone else sees the result.
+        future.whenComplete { result in
+            // update the internal credential locked
+            self.lock.withLockVoid {
+                // forget the refresh, whether it succeeded or failed, so the next call starts a new one
+                if self.credentialFuture === future {
                     self.credentialFuture = nil
-                    self.credential = credential
-                    logger.debug("AWS credentials ready", metadata: ["aws-credential-provider": .string("\(self)")])
                 }
-                return credential
+                guard case .success(let credential) = result else { return }
+                self.credential = credential
+                logger.debug("AWS credentials ready", metadata: ["aws-credential-provider": .string("\(self)")])
+                if let delay = self.backgroundRefreshDelay(for: credential) {
+                    self.scheduleBackgroundRefresh(in: delay, attempt: 0)
+                }
             }
+        }
+        return future
+    }
+
+    /// Return how long to wait before refreshing credential in the background, or nil if it shouldn't be. Must be
+    /// called inside the lock
+    private func backgroundRefreshDelay(for credential: Credential) -> TimeAmount? {
+        guard let margin = self.backgroundRefreshMargin,
+              let expiration = (credential as? ExpiringCredential)?.expirationDate
+        else {
+            return nil
+        }
+        let remaining = expiration.timeIntervalSinceNow
+        guard remaining <= margin else {
+            self.staleRefreshCount = 0
+            return .nanoseconds(Int64((remaining - margin) * 1_000_000_000))
+        }
+        // The credential doesn't last longer than the margin, so refresh half way through its lifetime. If refreshes
+        // keep returning credentials like this, eg the provider returns a cached credential that is about to expire,
+        // back off as if they had failed so the provider isn't called every second until the credential expires
+        let backoff = Self.backoff(attempt: self.staleRefreshCount)
+        self.staleRefreshCount += 1
+        return max(.nanoseconds(Int64(remaining / 2 * 1_000_000_000)), backoff)
+    }
+
+    /// Return jittered exponential backoff before retrying a refresh: 1, 2, 4 ... seconds up to a minute
+    private static func backoff(attempt: Int) -> TimeAmount {
+        let maxWait = Int64(min(exp2(Double(attempt)), 60) * 1_000_000_000)
+        return .nanoseconds(Int64.random(in: (maxWait / 2)..<maxWait))
+    }
 
-        return credentialFuture!
+    /// Schedule a refresh of the credentials on the provider's `EventLoop`. If it fails it is retried with jittered
+    /// exponential backoff. Must be called inside the lock
+    private func scheduleBackgroundRefresh(in delay: TimeAmount, attempt: Int) {
+        guard !self.isShutdown else { return }
+        self.backgroundRefresh?.cancel()
+        self.backgroundRefresh = self.eventLoop.scheduleTask(in: delay) {
+            self.logger.trace("Refreshing AWS credentials in background", metadata: ["aws-credential-provider": .string("\(self)")])
+            self.refreshCredentials(on: self.eventLoop, logger: self.logger).whenFailure { error in
+                self.logger.debug("Background AWS credential refresh failed", metadata: [
+                    "aws-credential-provider": .string("\(self)"),
+                    "aws-error": .string("\(error)"),
+                ])
+                self.lock.withLockVoid {
+                    self.scheduleBackgroundRefresh(in: Self.backoff(attempt: attempt), attempt: attempt + 1)
+                }
+            }
+        }
     }
 }
 
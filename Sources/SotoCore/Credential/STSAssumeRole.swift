@@ -69,6 +69,10 @@ struct STSCredentials: AWSDecodableShape, ExpiringCredential {
         return self.expiration.timeIntervalSinceNow < interval
     }
 
+    var expirationDate: Date? {
+        return self.expiration
+    }
+
     private enum CodingKeys: String, CodingKey {
         case accessKeyId = "AccessKeyId"
         case expiration = "Expiration"
@@ -35,6 +35,10 @@ extension ArrayCoder: CustomDecoder where Element: Decodable {
         guard topLevelContainer.contains(memberKey) else { return values }
 
         var container = try topLevelContainer.nestedUnkeyedContainer(forKey: memberKey)
+        // The XML decoder's unkeyed container iterates the members collected by one indexed lookup, so all that is
+        // left to do here is allocate storage for them up front. The coders only see the generic `Decoder` API, so a
+        // separate iterator would have to special case the XML decoder
+        values.reserveCapacity(container.count ?? 0)
         while !container.isAtEnd {
             values.append(try container.decode(Element.self))
         }
@@ -77,6 +81,7 @@ extension DictionaryCoder: CustomDecoder where Key: Decodable, Value: Decodable
             guard topLevelContainer.contains(entryKey) else { return values }
 
             var container = try topLevelContainer.nestedUnkeyedContainer(forKey: entryKey)
+            values.reserveCapacity(container.count ?? 0)
             while !container.isAtEnd {
                 let container2 = try container.nestedContainer(keyedBy: EncodingWrapperKey.self)
                 let key = try container2.decode(Key.self, forKey: EncodingWrapperKey(stringValue: Properties.key, intValue: nil))
@@ -85,6 +90,7 @@ extension DictionaryCoder: CustomDecoder where Key: Decodable, Value: Decodable
             }
         } else {
             var container = try decoder.unkeyedContainer()
+            values.reserveCapacity(container.count ?? 0)
             while !container.isAtEnd {
                 let container2 = try container.nestedContainer(keyedBy: EncodingWrapperKey.self)
                 let key = try container2.decode(Key.self, forKey: EncodingWrapperKey(stringValue: Properties.key, intValue: nil))
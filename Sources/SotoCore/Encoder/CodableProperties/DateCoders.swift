@@ -25,29 +25,44 @@ protocol DateFormatCoder: CustomDecoder, CustomEncoder where CodableValue == Dat
     static var formats: [String] { get }
     /// Date formatter
     static var dateFormatters: [DateFormatter] { get }
+    /// fixed formats matching `formats`. These are used in preference to the date formatters, which are only used to
+    /// decode strings none of these can parse
+    static var timestampFormats: [TimestampFormat] { get }
 }
 
 extension DateFormatCoder {
-    /// decode Date using DateFormatter
+    /// decode Date using TimestampFormat, falling back to DateFormatter
     public static func decode(from decoder: Decoder) throws -> CodableValue {
         let container = try decoder.singleValueContainer()
         let value = try container.decode(String.self)
-        for dateFormatter in dateFormatters {
-            if let date = dateFormatter.date(from: value) {
-                return date
-            }
+        if let date = self.date(from: value) {
+            return date
         }
         throw DecodingError.dataCorruptedError(in: container, debugDescription: "String is not the correct date format")
     }
 
-    /// encode Date using DateFormatter
+    /// encode Date using TimestampFormat
     public static func encode(value: CodableValue, to encoder: Encoder) throws {
         var container = encoder.singleValueContainer()
-        try container.encode(dateFormatters[0].string(from: value))
+        try container.encode(timestampFormats[0].string(from: value))
     }
 
     public static func string(from value: Date) -> String? {
-        dateFormatters[0].string(from: value)
+        timestampFormats[0].string(from: value)
+    }
+
+    static func date(from string: String) -> Date? {
+        for format in timestampFormats {
+            if let date = format.date(from: string) {
+                return date
+            }
+        }
+        for dateFormatter in dateFormatters {
+            if let date = dateFormatter.date(from: string) {
+                return date
+            }
+        }
+        return nil
     }
 
     /// create DateFormatter
@@ -69,12 +84,14 @@ extension DateFormatCoder {
 public struct ISO8601DateCoder: DateFormatCoder {
     public static let formats = ["yyyy-MM-dd'T'HH:mm:ss.SSS'Z'", "yyyy-MM-dd'T'HH:mm:ss'Z'"]
     public static let dateFormatters = createDateFormatters()
+    static let timestampFormats: [TimestampFormat] = [.iso8601WithFractionalSeconds, .iso8601]
 }
 
 /// Date coder for HTTP header format
 public struct HTTPHeaderDateCoder: DateFormatCoder {
     public static let formats = ["EEE, d MMM yyy HH:mm:ss z"]
     public static let dateFormatters = createDateFormatters()
+    static let timestampFormats: [TimestampFormat] = [.httpDate]
 }
 
 /// Unix Epoch Date coder
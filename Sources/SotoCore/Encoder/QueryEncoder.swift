@@ -12,12 +12,9 @@
 //
 //===----------------------------------------------------------------------===//
 
-import struct Foundation.CharacterSet
 import struct Foundation.Data
 import struct Foundation.Date
-import class Foundation.DateFormatter
-import struct Foundation.Locale
-import struct Foundation.TimeZone
+import NIO
 
 /// The wrapper struct for encoding Codable classes to Query dictionary
 public struct QueryEncoder {
@@ -44,130 +41,59 @@ public struct QueryEncoder {
     public init() {}
 
     public func encode<T: Encodable>(_ value: T, name: String? = nil) throws -> String? {
-        let encoder = _QueryEncoder(options: options)
-        try value.encode(to: encoder)
-
-        // encode generates a tree of dictionaries and arrays. We need to flatten this into a single dictionary with keys joined together
-        let result = flatten(encoder.result)
-        return Self.urlEncodeQueryParams(dictionary: result)
+        let encoder = try self.encodePairs(value)
+        guard encoder.pairs.count > 0 else { return nil }
+        var bytes: [UInt8] = []
+        bytes.reserveCapacity(encoder.outputSize)
+        encoder.writeSortedPairs { bytes.append(contentsOf: $0) }
+        return String(decoding: bytes, as: UTF8.self)
     }
 
-    // this list of query allowed characters comes from https://docs.aws.amazon.com/AmazonS3/latest/API/sig-v4-header-based-auth.html
-    static let queryAllowedCharacters = CharacterSet(charactersIn: "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-._~")
-
-    private static func urlEncodeQueryParam(_ value: String) -> String {
-        return value.addingPercentEncoding(withAllowedCharacters: AWSRequest.queryAllowedCharacters) ?? value
+    /// Encode value as query string straight into a `ByteBuffer`. Returns nil if there is nothing to encode
+    public func encode<T: Encodable>(_ value: T, byteBufferAllocator: ByteBufferAllocator) throws -> ByteBuffer? {
+        let encoder = try self.encodePairs(value)
+        guard encoder.pairs.count > 0 else { return nil }
+        var buffer = byteBufferAllocator.buffer(capacity: encoder.outputSize)
+        encoder.writeSortedPairs { buffer.writeBytes($0) }
+        return buffer
     }
 
-    // generate string from
-    private static func urlEncodeQueryParams(dictionary: [(key: String, value: String)]) -> String? {
-        guard dictionary.count > 0 else { return nil }
-        return dictionary
-            .sorted { $0.key < $1.key }
-            .map { "\($0.key)=\(urlEncodeQueryParam(String(describing: $0.value)))" }
-            .joined(separator: "&")
-    }
-
-    /// Flatten dictionary and array tree into one dictionary
-    /// - Parameter container: The root container
-    private func flatten(_ container: _QueryEncoderKeyedContainer?) -> [(key: String, value: String)] {
-        var result: [(key: String, value: String)] = additionalKeys.map { return $0 }
-
-        func flatten(dictionary: [String: Any], path: String) {
-            for (key, value) in dictionary {
-                switch value {
-                case let keyed as _QueryEncoderKeyedContainer:
-                    flatten(dictionary: keyed.values, path: "\(path)\(key).")
-                case let unkeyed as _QueryEncoderUnkeyedContainer:
-                    flatten(array: unkeyed.values, path: "\(path)\(key).")
-                default:
-                    result.append((key: "\(path)\(key)", value: String(describing: value)))
-                }
-            }
-        }
-        func flatten(array: [Any], path: String) {
-            for iterator in array.enumerated() {
-                switch iterator.element {
-                case let keyed as _QueryEncoderKeyedContainer:
-                    flatten(dictionary: keyed.values, path: "\(path)\(iterator.offset + 1).")
-                case let unkeyed as _QueryEncoderUnkeyedContainer:
-                    flatten(array: unkeyed.values, path: "\(path)\(iterator.offset + 1)")
-                default:
-                    result.append((key: "\(path)\(iterator.offset + 1)", value: String(describing: iterator.element)))
-                }
-            }
-        }
-        if let container = container {
-            flatten(dictionary: container.values, path: "")
+    /// Encode value and additional keys as a list of percent encoded key value pairs
+    private func encodePairs<T: Encodable>(_ value: T) throws -> _QueryEncoder {
+        let encoder = _QueryEncoder(options: options)
+        for (key, value) in self.additionalKeys {
+            encoder.writePair(prefix: [], key: key, value: value)
         }
-        return result
-    }
-}
-
-/// class for holding a keyed container (dictionary). Need to encapsulate dictionary in class so we can be sure we are
-/// editing the dictionary we push onto the stack
-private class _QueryEncoderKeyedContainer {
-    private(set) var values: [String: Any] = [:]
-
-    func addChild(path: String, child: Any) {
-        values[path] = child
-    }
-}
-
-/// class for holding unkeyed container (array). Need to encapsulate array in class so we can be sure we are
-/// editing the array we push onto the stack
-private class _QueryEncoderUnkeyedContainer {
-    private(set) var values: [Any] = []
-
-    func addChild(_ child: Any) {
-        values.append(child)
+        try value.encode(to: encoder)
+        return encoder
     }
 }
 
-/// storage for Query Encoder. Stores a stack of QueryEncoder containers, plus leaf objects
-private struct _QueryEncoderStorage {
-    /// the container stack
-    private var containers: [Any] = []
-
-    /// initializes self with no containers
-    init() {}
-
-    /// push a new container onto the storage
-    mutating func pushKeyedContainer() -> _QueryEncoderKeyedContainer {
-        let container = _QueryEncoderKeyedContainer()
-        containers.append(container)
-        return container
-    }
-
-    /// push a new container onto the storage
-    mutating func pushUnkeyedContainer() -> _QueryEncoderUnkeyedContainer {
-        let container = _QueryEncoderUnkeyedContainer()
-        containers.append(container)
-        return container
+/// Internal QueryEncoder class. Rather than building a tree of containers and flattening it, each value is written
+/// out as soon as it is encoded, along with its full key. Containers hold the key path to them as a prefix for the keys
+/// of their children.
+private final class _QueryEncoder: Encoder {
+    /// key value pair. Ranges are into `_QueryEncoder.storage`
+    struct Pair {
+        let key: Range<Int>
+        let value: Range<Int>
     }
 
-    mutating func push(container: Any) {
-        containers.append(container)
-    }
-
-    /// pop a container from the storage
-    @discardableResult mutating func popContainer() -> Any {
-        return containers.removeLast()
-    }
-}
-
-/// Internal QueryEncoder class. Does all the heavy lifting
-private class _QueryEncoder: Encoder {
     var codingPath: [CodingKey]
 
-    /// the encoder's storage
-    var storage: _QueryEncoderStorage
-
     /// options
-    var options: QueryEncoder._Options
+    let options: QueryEncoder._Options
 
-    /// resultant query array
-    var result: _QueryEncoderKeyedContainer?
+    /// Full key of the value being encoded by a call to `Encodable.encode(to:)`. Containers created for that value use
+    /// this as the prefix for their keys
+    var key: [UInt8]
+    /// Is `key` an array index. Arrays inside arrays don't add a "." between their key and their children's keys
+    var keyIsIndex: Bool
+
+    /// keys and percent encoded values of all the pairs, one after the other
+    var storage: [UInt8]
+    /// key value pairs in the order they were encoded
+    var pairs: [Pair]
 
     /// Contextual user-provided information for use during encoding.
     public var userInfo: [CodingUserInfoKey: Any] {
@@ -177,81 +103,116 @@ private class _QueryEncoder: Encoder {
     /// Initialization
     /// - Parameters:
     ///   - options: options
-    ///   - containerCodingMapType: Container encoding for the top level object
     init(options: QueryEncoder._Options) {
-        self.storage = _QueryEncoderStorage()
         self.options = options
         self.codingPath = []
-        self.result = nil
+        self.key = []
+        self.keyIsIndex = false
+        self.storage = []
+        self.storage.reserveCapacity(256)
+        self.pairs = []
     }
 
-    func container<Key>(keyedBy type: Key.Type) -> KeyedEncodingContainer<Key> where Key: CodingKey {
-        let newContainer = storage.pushKeyedContainer()
-        if self.result == nil {
-            self.result = newContainer
+    /// size of query string generated by `writeSortedPairs`
+    var outputSize: Int {
+        return self.storage.count + self.pairs.count * 2 - 1
+    }
+
+    /// Write key and percent encoded value to storage
+    func writePair(prefix: [UInt8], key: String, value: String) {
+        let keyStart = self.storage.count
+        self.storage.append(contentsOf: prefix)
+        self.storage.append(contentsOf: key.utf8)
+        let valueStart = self.storage.count
+        for byte in value.utf8 {
+            if Self.isQueryAllowed(byte) {
+                self.storage.append(byte)
+            } else {
+                self.storage.append(UInt8(ascii: "%"))
+                self.storage.append(Self.hexDigits[Int(byte >> 4)])
+                self.storage.append(Self.hexDigits[Int(byte & 0xF)])
+            }
         }
-        return KeyedEncodingContainer(KEC(referencing: self, container: newContainer))
+        self.pairs.append(Pair(key: keyStart..<valueStart, value: valueStart..<self.storage.count))
+    }
+
+    /// Sort pairs by key and output them joined by "&"s
+    func writeSortedPairs(_ write: (UnsafeRawBufferPointer) -> Void) {
+        self.storage.withUnsafeBytes { bytes in
+            let sortedPairs = self.pairs.sorted { bytes[$0.key].lexicographicallyPrecedes(bytes[$1.key]) }
+            for index in sortedPairs.indices {
+                if index > 0 {
+                    Self.ampersand.withUnsafeBytes(write)
+                }
+                let pair = sortedPairs[index]
+                write(UnsafeRawBufferPointer(rebasing: bytes[pair.key]))
+                Self.equals.withUnsafeBytes(write)
+                write(UnsafeRawBufferPointer(rebasing: bytes[pair.value]))
+            }
+        }
+    }
+
+    /// Prefix for the keys of a container created for the value currently being encoded
+    func containerPrefix(unkeyed: Bool) -> [UInt8] {
+        // top level container
+        guard self.codingPath.count > 0 else { return [] }
+        if unkeyed, self.keyIsIndex {
+            return self.key
+        }
+        return self.key + [UInt8(ascii: ".")]
+    }
+
+    func container<Key>(keyedBy type: Key.Type) -> KeyedEncodingContainer<Key> where Key: CodingKey {
+        return KeyedEncodingContainer(KEC(referencing: self, prefix: self.containerPrefix(unkeyed: false)))
     }
 
     struct KEC<Key: CodingKey>: KeyedEncodingContainerProtocol {
         var codingPath: [CodingKey] { return encoder.codingPath }
-        let container: _QueryEncoderKeyedContainer
+        /// key path to this container
+        let prefix: [UInt8]
         let encoder: _QueryEncoder
 
         /// Initialization
         /// - Parameter referencing: encoder that created this
-        init(referencing: _QueryEncoder, container: _QueryEncoderKeyedContainer) {
+        init(referencing: _QueryEncoder, prefix: [UInt8]) {
             self.encoder = referencing
-            self.container = container
+            self.prefix = prefix
         }
 
-        mutating func encode(_ value: Any, key: String) {
-            container.addChild(path: ec2Encode(key), child: value)
+        mutating func encode<Value: LosslessStringConvertible>(_ value: Value, key: Key) {
+            encoder.writePair(prefix: prefix, key: ec2Encode(key.stringValue), value: value.description)
         }
 
-        mutating func encodeNil(forKey key: Key) throws { encode("", key: key.stringValue) }
-        mutating func encode(_ value: Bool, forKey key: Key) throws { encode(value, key: key.stringValue) }
-        mutating func encode(_ value: String, forKey key: Key) throws { encode(value, key: key.stringValue) }
-        mutating func encode(_ value: Double, forKey key: Key) throws { encode(value, key: key.stringValue) }
-        mutating func encode(_ value: Float, forKey key: Key) throws { encode(value, key: key.stringValue) }
-        mutating func encode(_ value: Int, forKey key: Key) throws { encode(value, key: key.stringValue) }
-        mutating func encode(_ value: Int8, forKey key: Key) throws { encode(value, key: key.stringValue) }
-        mutating func encode(_ value: Int16, forKey key: Key) throws { encode(value, key: key.stringValue) }
-        mutating func encode(_ value: Int32, forKey key: Key) throws { encode(value, key: key.stringValue) }
-        mutating func encode(_ value: Int64, forKey key: Key) throws { encode(value, key: key.stringValue) }
-        mutating func encode(_ value: UInt, forKey key: Key) throws { encode(value, key: key.stringValue) }
-        mutating func encode(_ value: UInt8, forKey key: Key) throws { encode(value, key: key.stringValue) }
-        mutating func encode(_ value: UInt16, forKey key: Key) throws { encode(value, key: key.stringValue) }
-        mutating func encode(_ value: UInt32, forKey key: Key) throws { encode(value, key: key.stringValue) }
-        mutating func encode(_ value: UInt64, forKey key: Key) throws { encode(value, key: key.stringValue) }
+        mutating func encodeNil(forKey key: Key) throws { encode("", key: key) }
+        mutating func encode(_ value: Bool, forKey key: Key) throws { encode(value, key: key) }
+        mutating func encode(_ value: String, forKey key: Key) throws { encode(value, key: key) }
+        mutating func encode(_ value: Double, forKey key: Key) throws { encode(value, key: key) }
+        mutating func encode(_ value: Float, forKey key: Key) throws { encode(value, key: key) }
+        mutating func encode(_ value: Int, forKey key: Key) throws { encode(value, key: key) }
+        mutating func encode(_ value: Int8, forKey key: Key) throws { encode(value, key: key) }
+        mutating func encode(_ value: Int16, forKey key: Key) throws { encode(value, key: key) }
+        mutating func encode(_ value: Int32, forKey key: Key) throws { encode(value, key: key) }
+        mutating func encode(_ value: Int64, forKey key: Key) throws { encode(value, key: key) }
+        mutating func encode(_ value: UInt, forKey key: Key) throws { encode(value, key: key) }
+        mutating func encode(_ value: UInt8, forKey key: Key) throws { encode(value, key: key) }
+        mutating func encode(_ value: UInt16, forKey key: Key) throws { encode(value, key: key) }
+        mutating func encode(_ value: UInt32, forKey key: Key) throws { encode(value, key: key) }
+        mutating func encode(_ value: UInt64, forKey key: Key) throws { encode(value, key: key) }
 
         mutating func encode<T: Encodable>(_ value: T, forKey key: Key) throws {
             self.encoder.codingPath.append(key)
             defer { self.encoder.codingPath.removeLast() }
 
-            let childContainer = try encoder.box(value)
-            container.addChild(path: ec2Encode(key.stringValue), child: childContainer)
+            try encoder.box(value, key: prefix + ec2Encode(key.stringValue).utf8, keyIsIndex: false)
         }
 
         mutating func nestedContainer<NestedKey>(keyedBy keyType: NestedKey.Type, forKey key: Key) -> KeyedEncodingContainer<NestedKey> where NestedKey: CodingKey {
-            self.encoder.codingPath.append(key)
-            defer { self.encoder.codingPath.removeLast() }
-
-            let keyedContainer = _QueryEncoderKeyedContainer()
-            container.addChild(path: ec2Encode(key.stringValue), child: keyedContainer)
-
-            let kec = KEC<NestedKey>(referencing: self.encoder, container: keyedContainer)
+            let kec = KEC<NestedKey>(referencing: self.encoder, prefix: prefix + ec2Encode(key.stringValue).utf8 + [UInt8(ascii: ".")])
             return KeyedEncodingContainer(kec)
         }
 
         mutating func nestedUnkeyedContainer(forKey key: Key) -> UnkeyedEncodingContainer {
-            self.encoder.codingPath.append(key)
-            defer { self.encoder.codingPath.removeLast() }
-
-            let unkeyedContainer = _QueryEncoderUnkeyedContainer()
-            container.addChild(path: ec2Encode(key.stringValue), child: unkeyedContainer)
-
-            return UKEC(referencing: self.encoder, container: unkeyedContainer)
+            return UKEC(referencing: self.encoder, prefix: prefix + ec2Encode(key.stringValue).utf8 + [UInt8(ascii: ".")])
         }
 
         mutating func superEncoder() -> Encoder {
@@ -271,25 +232,25 @@ private class _QueryEncoder: Encoder {
     }
 
     func unkeyedContainer() -> UnkeyedEncodingContainer {
-        let container = storage.pushUnkeyedContainer()
-        return UKEC(referencing: self, container: container)
+        return UKEC(referencing: self, prefix: self.containerPrefix(unkeyed: true))
     }
 
     struct UKEC: UnkeyedEncodingContainer {
         var codingPath: [CodingKey] { return encoder.codingPath }
-        let container: _QueryEncoderUnkeyedContainer
+        /// key path to this container
+        let prefix: [UInt8]
         let encoder: _QueryEncoder
         var count: Int
 
-        init(referencing: _QueryEncoder, container: _QueryEncoderUnkeyedContainer) {
+        init(referencing: _QueryEncoder, prefix: [UInt8]) {
             self.encoder = referencing
-            self.container = container
+            self.prefix = prefix
             self.count = 0
         }
 
-        mutating func encodeResult(_ value: Any) {
+        mutating func encodeResult<Value: LosslessStringConvertible>(_ value: Value) {
             count += 1
-            container.addChild(value)
+            encoder.writePair(prefix: prefix, key: count.description, value: value.description)
         }
 
         mutating func encodeNil() throws { encodeResult("") }
@@ -314,30 +275,20 @@ private class _QueryEncoder: Encoder {
             self.encoder.codingPath.append(_QueryKey(index: count))
             defer { self.encoder.codingPath.removeLast() }
 
-            let childContainer = try encoder.box(value)
-            container.addChild(childContainer)
+            try encoder.box(value, key: prefix + count.description.utf8, keyIsIndex: true)
         }
 
         mutating func nestedContainer<NestedKey>(keyedBy keyType: NestedKey.Type) -> KeyedEncodingContainer<NestedKey> where NestedKey: CodingKey {
             count += 1
 
-            self.encoder.codingPath.append(_QueryKey(index: count))
-            defer { self.encoder.codingPath.removeLast() }
-
-            let keyedContainer = _QueryEncoderKeyedContainer()
-            container.addChild(keyedContainer)
-
-            let kec = KEC<NestedKey>(referencing: self.encoder, container: keyedContainer)
+            let kec = KEC<NestedKey>(referencing: self.encoder, prefix: prefix + count.description.utf8 + [UInt8(ascii: ".")])
             return KeyedEncodingContainer(kec)
         }
 
         mutating func nestedUnkeyedContainer() -> UnkeyedEncodingContainer {
             count += 1
 
-            let unkeyedContainer = _QueryEncoderUnkeyedContainer()
-            container.addChild(unkeyedContainer)
-
-            return UKEC(referencing: self.encoder, container: unkeyedContainer)
+            return UKEC(referencing: self.encoder, prefix: prefix + count.description.utf8)
         }
 
         mutating func superEncoder() -> Encoder {
@@ -347,8 +298,10 @@ private class _QueryEncoder: Encoder {
 }
 
 extension _QueryEncoder: SingleValueEncodingContainer {
-    func encodeResult(_ value: Any) {
-        storage.push(container: value)
+    func encodeResult<Value: LosslessStringConvertible>(_ value: Value) {
+        // a value at the top level has no key so cannot be added to the query
+        guard self.codingPath.count > 0 else { return }
+        self.writePair(prefix: self.key, key: "", value: value.description)
     }
 
     func encodeNil() throws {
@@ -371,7 +324,7 @@ extension _QueryEncoder: SingleValueEncodingContainer {
     func encode(_ value: UInt64) throws { encodeResult(value) }
 
     func encode<T: Encodable>(_ value: T) throws {
-        try value.encode(to: self)
+        try self.box(value, key: self.key, keyIsIndex: self.keyIsIndex)
     }
 
     func singleValueContainer() -> SingleValueEncodingContainer {
@@ -380,35 +333,43 @@ extension _QueryEncoder: SingleValueEncodingContainer {
 }
 
 extension _QueryEncoder {
-    func box(_ date: Date) throws -> Any {
-        try encode(Self.dateFormatter.string(from: date))
-        return storage.popContainer()
-    }
-
-    func box(_ data: Data) throws -> Any {
-        try encode(data.base64EncodedString())
-        return storage.popContainer()
-    }
+    /// Encode value with key. `key` is pushed onto the key stack while the value is encoded
+    func box<T: Encodable>(_ value: T, key: [UInt8], keyIsIndex: Bool) throws {
+        let previousKey = self.key
+        let previousKeyIsIndex = self.keyIsIndex
+        self.key = key
+        self.keyIsIndex = keyIsIndex
+        defer {
+            self.key = previousKey
+            self.keyIsIndex = previousKeyIsIndex
+        }
 
-    func box(_ value: Encodable) throws -> Any {
-        let type = Swift.type(of: value)
-        if type == Data.self {
-            return try self.box(value as! Data)
-        } else if type == Date.self {
-            return try self.box(value as! Date)
+        if let date = value as? Date {
+            encodeResult(TimestampFormat.iso8601WithFractionalSeconds.string(from: date))
+        } else if let data = value as? Data {
+            encodeResult(data.base64EncodedString())
         } else {
             try value.encode(to: self)
-            return storage.popContainer()
         }
     }
 
-    static let dateFormatter: DateFormatter = {
-        let dateFormatter = DateFormatter()
-        dateFormatter.locale = Locale(identifier: "en_US_POSIX")
-        dateFormatter.dateFormat = "yyyy-MM-dd'T'HH:mm:ss.SSS'Z'"
-        dateFormatter.timeZone = TimeZone(secondsFromGMT: 0)
-        return dateFormatter
-    }()
+    /// unreserved characters in https://docs.aws.amazon.com/AmazonS3/latest/API/sig-v4-header-based-auth.html. These are
+    /// the same as `AWSRequest.queryAllowedCharacters`
+    static func isQueryAllowed(_ byte: UInt8) -> Bool {
+        switch byte {
+        case UInt8(ascii: "A")...UInt8(ascii: "Z"),
+             UInt8(ascii: "a")...UInt8(ascii: "z"),
+             UInt8(ascii: "0")...UInt8(ascii: "9"),
+             UInt8(ascii: "-"), UInt8(ascii: "."), UInt8(ascii: "_"), UInt8(ascii: "~"):
+            return true
+        default:
+            return false
+        }
+    }
+
+    static let hexDigits: [UInt8] = Array("0123456789ABCDEF".utf8)
+    static let ampersand: [UInt8] = [UInt8(ascii: "&")]
+    static let equals: [UInt8] = [UInt8(ascii: "=")]
 }
 
 //===----------------------------------------------------------------------===//
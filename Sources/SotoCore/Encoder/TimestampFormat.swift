@@ -0,0 +1,306 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the Soto for AWS open source project
+//
+// Copyright (c) 2017-2020 the Soto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.txt for the list of Soto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import struct Foundation.Date
+
+/// Fixed layout timestamp formats used by AWS. Parsing and writing is done directly on UTF8 bytes, which is a lot faster
+/// than using a `DateFormatter` and doesn't take any locks. All timestamps are in UTC.
+enum TimestampFormat {
+    /// yyyy-MM-dd'T'HH:mm:ss.SSS'Z'. When parsing, any number of fractional second digits is accepted
+    case iso8601WithFractionalSeconds
+    /// yyyy-MM-dd'T'HH:mm:ss'Z'
+    case iso8601
+    /// HTTP-date as used in headers eg "Tue, 3 Jun 2008 11:05:30 GMT". When parsing, "UTC" is also accepted as the timezone
+    case httpDate
+
+    /// Return Date parsed from string, or nil if the string isn't in this format
+    func date(from string: String) -> Date? {
+        var string = string
+        return string.withUTF8 { bytes in
+            var parser = Parser(bytes)
+            let date: Date?
+            switch self {
+            case .iso8601WithFractionalSeconds:
+                date = parser.parseISO8601(fractionalSeconds: true)
+            case .iso8601:
+                date = parser.parseISO8601(fractionalSeconds: false)
+            case .httpDate:
+                date = parser.parseHTTPDate()
+            }
+            // the whole string must be used
+            guard parser.isEmpty else { return nil }
+            return date
+        }
+    }
+
+    /// Return date formatted as a string
+    func string(from date: Date) -> String {
+        let time = Time(date)
+        var bytes: [UInt8] = []
+        bytes.reserveCapacity(29)
+        switch self {
+        case .iso8601WithFractionalSeconds, .iso8601:
+            Self.write(time.year, digits: 4, to: &bytes)
+            bytes.append(UInt8(ascii: "-"))
+            Self.write(time.month, digits: 2, to: &bytes)
+            bytes.append(UInt8(ascii: "-"))
+            Self.write(time.day, digits: 2, to: &bytes)
+            bytes.append(UInt8(ascii: "T"))
+            Self.write(time.hour, digits: 2, to: &bytes)
+            bytes.append(UInt8(ascii: ":"))
+            Self.write(time.minute, digits: 2, to: &bytes)
+            bytes.append(UInt8(ascii: ":"))
+            Self.write(time.second, digits: 2, to: &bytes)
+            if case .iso8601WithFractionalSeconds = self {
+                bytes.append(UInt8(ascii: "."))
+                Self.write(time.millisecond, digits: 3, to: &bytes)
+            }
+            bytes.append(UInt8(ascii: "Z"))
+
+        case .httpDate:
+            bytes.append(contentsOf: Self.weekdays[time.weekday])
+            bytes.append(contentsOf: [UInt8(ascii: ","), UInt8(ascii: " ")])
+            Self.write(time.day, digits: 1, to: &bytes)
+            bytes.append(UInt8(ascii: " "))
+            bytes.append(contentsOf: Self.months[time.month - 1])
+            bytes.append(UInt8(ascii: " "))
+            Self.write(time.year, digits: 4, to: &bytes)
+            bytes.append(UInt8(ascii: " "))
+            Self.write(time.hour, digits: 2, to: &bytes)
+            bytes.append(UInt8(ascii: ":"))
+            Self.write(time.minute, digits: 2, to: &bytes)
+            bytes.append(UInt8(ascii: ":"))
+            Self.write(time.second, digits: 2, to: &bytes)
+            bytes.append(contentsOf: Self.gmt)
+        }
+        return String(decoding: bytes, as: UTF8.self)
+    }
+
+    /// write positive integer padded with zeros to at least `digits` digits
+    private static func write(_ value: Int, digits: Int, to bytes: inout [UInt8]) {
+        var divisor = 1
+        var count = 1
+        while divisor <= value / 10 || count < digits {
+            divisor *= 10
+            count += 1
+        }
+        var value = value
+        while divisor > 0 {
+            bytes.append(UInt8(ascii: "0") + UInt8(value / divisor))
+            value %= divisor
+            divisor /= 10
+        }
+    }
+
+    fileprivate static let weekdays: [[UInt8]] = ["Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"].map { Array($0.utf8) }
+    fileprivate static let months: [[UInt8]] = ["Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"].map { Array($0.utf8) }
+    private static let gmt: [UInt8] = Array(" GMT".utf8)
+}
+
+extension TimestampFormat {
+    /// Date split into its UTC calendar components
+    struct Time {
+        let year: Int
+        let month: Int
+        let day: Int
+        let hour: Int
+        let minute: Int
+        let second: Int
+        let millisecond: Int
+        /// day of week, 0 is Sunday
+        let weekday: Int
+
+        init(_ date: Date) {
+            // round to microseconds to remove floating point error, then truncate to milliseconds in the same way as
+            // DateFormatter
+            let microseconds = Int((date.timeIntervalSince1970 * 1_000_000).rounded())
+            let (days, millisecondOfDay) = Self.floorDivide(Self.floorDivide(microseconds, 1000).quotient, 86_400_000)
+            let date = Self.civil(fromDays: days)
+            self.year = date.year
+            self.month = date.month
+            self.day = date.day
+            self.hour = millisecondOfDay / 3_600_000
+            self.minute = (millisecondOfDay / 60000) % 60
+            self.second = (millisecondOfDay / 1000) % 60
+            self.millisecond = millisecondOfDay % 1000
+            // 1 January 1970 was a Thursday
+            self.weekday = Self.floorDivide(days + 4, 7).remainder
+        }
+
+        /// division rounding towards negative infinity, so that times before 1970 work
+        static func floorDivide(_ value: Int, _ divisor: Int) -> (quotient: Int, remainder: Int) {
+            let remainder = value % divisor
+            if remainder < 0 {
+                return (value / divisor - 1, remainder + divisor)
+            }
+            return (value / divisor, remainder)
+        }
+
+        /// Convert days since 1970-01-01 to year, month and day. From http://howardhinnant.github.io/date_algorithms.html
+        static func civil(fromDays days: Int) -> (year: Int, month: Int, day: Int) {
+            let days = days + 719_468
+            let era = (days >= 0 ? days : days - 146_096) / 146_097
+            let dayOfEra = days - era * 146_097
+            let yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146_096) / 365
+            let dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100)
+            let shiftedMonth = (5 * dayOfYear + 2) / 153
+            let day = dayOfYear - (153 * shiftedMonth + 2) / 5 + 1
+            let month = shiftedMonth < 10 ? shiftedMonth + 3 : shiftedMonth - 9
+            let year = yearOfEra + era * 400 + (month <= 2 ? 1 : 0)
+            return (year, month, day)
+        }
+
+        /// Convert year, month and day to days since 1970-01-01. From http://howardhinnant.github.io/date_algorithms.html
+        static func days(fromCivil year: Int, month: Int, day: Int) -> Int {
+            let year = month <= 2 ? year - 1 : year
+            let era = (year >= 0 ? year : year - 399) / 400
+            let yearOfEra = year - era * 400
+            let dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1
+            let dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear
+            return era * 146_097 + dayOfEra - 719_468
+        }
+
+        static func daysInMonth(_ month: Int, year: Int) -> Int {
+            switch month {
+            case 2:
+                let isLeapYear = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0
+                return isLeapYear ? 29 : 28
+            case 4, 6, 9, 11:
+                return 30
+            default:
+                return 31
+            }
+        }
+    }
+
+    /// Parser reading timestamp components from UTF8 bytes
+    struct Parser {
+        let bytes: UnsafeBufferPointer<UInt8>
+        var index: Int
+
+        init(_ bytes: UnsafeBufferPointer<UInt8>) {
+            self.bytes = bytes
+            self.index = 0
+        }
+
+        var isEmpty: Bool { return self.index == self.bytes.count }
+
+        /// parse yyyy-MM-dd'T'HH:mm:ss'Z', with optional fractional seconds
+        mutating func parseISO8601(fractionalSeconds: Bool) -> Date? {
+            guard let year = self.readNumber(digits: 4),
+                  self.read("-"),
+                  let month = self.readNumber(digits: 2),
+                  self.read("-"),
+                  let day = self.readNumber(digits: 2),
+                  self.read("T"),
+                  let hour = self.readNumber(digits: 2),
+                  self.read(":"),
+                  let minute = self.readNumber(digits: 2),
+                  self.read(":"),
+                  let second = self.readNumber(digits: 2) else { return nil }
+            var fraction = 0.0
+            if fractionalSeconds {
+                guard self.read("."), let value = self.readFraction() else { return nil }
+                fraction = value
+            }
+            guard self.read("Z") else { return nil }
+            return Self.date(year: year, month: month, day: day, hour: hour, minute: minute, second: second, fraction: fraction)
+        }
+
+        /// parse HTTP-date eg "Tue, 3 Jun 2008 11:05:30 GMT"
+        mutating func parseHTTPDate() -> Date? {
+            guard self.readName(TimestampFormat.weekdays) != nil,
+                  self.read(","),
+                  self.read(" "),
+                  let day = self.readNumber(minDigits: 1, maxDigits: 2),
+                  self.read(" "),
+                  let month = self.readName(TimestampFormat.months),
+                  self.read(" "),
+                  let year = self.readNumber(digits: 4),
+                  self.read(" "),
+                  let hour = self.readNumber(digits: 2),
+                  self.read(":"),
+                  let minute = self.readNumber(digits: 2),
+                  self.read(":"),
+                  let second = self.readNumber(digits: 2),
+                  self.read(" "),
+                  self.readName([Array("GMT".utf8), Array("UTC".utf8)]) != nil else { return nil }
+            return Self.date(year: year, month: month + 1, day: day, hour: hour, minute: minute, second: second, fraction: 0)
+        }
+
+        static func date(year: Int, month: Int, day: Int, hour: Int, minute: Int, second: Int, fraction: Double) -> Date? {
+            guard (1...12).contains(month),
+                  (1...Time.daysInMonth(month, year: year)).contains(day),
+                  hour < 24, minute < 60, second < 60 else { return nil }
+            let days = Time.days(fromCivil: year, month: month, day: day)
+            let seconds = ((days * 24 + hour) * 60 + minute) * 60 + second
+            return Date(timeIntervalSince1970: Double(seconds) + fraction)
+        }
+
+        mutating func read(_ character: Unicode.Scalar) -> Bool {
+            guard self.index < self.bytes.count, self.bytes[self.index] == UInt8(ascii: character) else { return false }
+            self.index += 1
+            return true
+        }
+
+        mutating func readNumber(digits: Int) -> Int? {
+            return self.readNumber(minDigits: digits, maxDigits: digits)
+        }
+
+        mutating func readNumber(minDigits: Int, maxDigits: Int) -> Int? {
+            var value = 0
+            var count = 0
+            while count < maxDigits, self.index < self.bytes.count {
+                let digit = self.bytes[self.index] &- UInt8(ascii: "0")
+                guard digit < 10 else { break }
+                value = value * 10 + Int(digit)
+                count += 1
+                self.index += 1
+            }
+            guard count >= minDigits else { return nil }
+            return value
+        }
+
+        /// read digits after a decimal point. Digits after the first nine are ignored
+        mutating func readFraction() -> Double? {
+            var value = 0
+            var scale = 1
+            var count = 0
+            while self.index < self.bytes.count {
+                let digit = self.bytes[self.index] &- UInt8(ascii: "0")
+                guard digit < 10 else { break }
+                if count < 9 {
+                    value = value * 10 + Int(digit)
+                    scale *= 10
+                }
+                count += 1
+                self.index += 1
+            }
+            guard count > 0 else { return nil }
+            return Double(value) / Double(scale)
+        }
+
+        /// read one of a list of names, returning its index in the list
+        mutating func readName(_ names: [[UInt8]]) -> Int? {
+            for (nameIndex, name) in names.enumerated() {
+                guard self.index + name.count <= self.bytes.count else { continue }
+                if name.elementsEqual(self.bytes[self.index..<self.index + name.count]) {
+                    self.index += name.count
+                    return nameIndex
+                }
+            }
+            return nil
+        }
+    }
+}
@@ -53,6 +53,10 @@ public protocol AWSHTTPClient {
     /// Execute an HTTP request with a streamed response
     func execute(request: AWSHTTPRequest, timeout: TimeAmount, on eventLoop: EventLoop, logger: Logger, stream: @escaping ResponseStream) -> EventLoopFuture<AWSHTTPResponse>
 
+    /// Execute an HTTP request where a successful response is expected to have an XML body. Clients that can, should
+    /// parse the XML as it is received and return it in the response
+    func executeWithXMLResponse(request: AWSHTTPRequest, timeout: TimeAmount, on eventLoop: EventLoop, logger: Logger) -> EventLoopFuture<AWSHTTPResponse>
+
     /// This should be called before an HTTP Client can be de-initialised
     func shutdown(queue: DispatchQueue, _ callback: @escaping (Error?) -> Void)
 
@@ -65,4 +69,10 @@ extension AWSHTTPClient {
     public func execute(request: AWSHTTPRequest, timeout: TimeAmount, on eventLoop: EventLoop, logger: Logger, stream: @escaping ResponseStream) -> EventLoopFuture<AWSHTTPResponse> {
         preconditionFailure("\(type(of: self)) does not support response streaming")
     }
+
+    /// Execute an HTTP request where a successful response is expected to have an XML body. By default the body is
+    /// returned unparsed and is parsed once the full response has been received
+    public func executeWithXMLResponse(request: AWSHTTPRequest, timeout: TimeAmount, on eventLoop: EventLoop, logger: Logger) -> EventLoopFuture<AWSHTTPResponse> {
+        return self.execute(request: request, timeout: timeout, on: eventLoop, logger: logger)
+    }
 }
@@ -26,39 +26,62 @@ extension AsyncHTTPClient.HTTPClient: AWSHTTPClient {
     ///   - eventLoop: eventLoop to run request on
     /// - Returns: EventLoopFuture that will be fulfilled with request response
     public func execute(request: AWSHTTPRequest, timeout: TimeAmount, on eventLoop: EventLoop, logger: Logger) -> EventLoopFuture<AWSHTTPResponse> {
-        let requestBody: AsyncHTTPClient.HTTPClient.Body?
-        var requestHeaders = request.headers
+        return self.execute(request: request, timeout: timeout, on: eventLoop, logger: logger, metrics: nil)
+    }
 
-        switch request.body.payload {
-        case .byteBuffer(let byteBuffer):
-            requestBody = .byteBuffer(byteBuffer)
-        case .stream(let reader):
-            requestHeaders = reader.updateHeaders(headers: requestHeaders)
-            requestBody = .stream(length: reader.contentSize) { writer in
-                return writer.write(reader: reader, on: eventLoop)
-            }
-        case .empty:
-            requestBody = nil
+    /// Execute HTTP request, recording the time to first byte and transfer time of the response if `metrics` is set
+    func execute(request: AWSHTTPRequest, timeout: TimeAmount, on eventLoop: EventLoop, logger: Logger, metrics: RequestStageMetrics?) -> EventLoopFuture<AWSHTTPResponse> {
+        do {
+            let asyncRequest = try self.createRequest(from: request, on: eventLoop)
+            let delegate = ResponseAccumulator(request: asyncRequest)
+            return self.execute(request: asyncRequest, delegate: delegate, timeout: timeout, on: eventLoop, logger: logger, metrics: metrics).map { $0 }
+        } catch {
+            return eventLoopGroup.next().makeFailedFuture(error)
         }
+    }
+
+    /// Execute HTTP request expecting an XML response. The body of a successful response is parsed as it is received
+    /// - Parameters:
+    ///   - request: HTTP request
+    ///   - timeout: If execution is idle for longer than timeout then throw error
+    ///   - eventLoop: eventLoop to run request on
+    /// - Returns: EventLoopFuture that will be fulfilled with request response
+    public func executeWithXMLResponse(request: AWSHTTPRequest, timeout: TimeAmount, on eventLoop: EventLoop, logger: Logger) -> EventLoopFuture<AWSHTTPResponse> {
+        return self.executeWithXMLResponse(request: request, output: .element, timeout: timeout, on: eventLoop, logger: logger)
+    }
+
+    /// Execute HTTP request expecting an XML response, choosing what the body of a successful response is parsed into
+    func executeWithXMLResponse(
+        request: AWSHTTPRequest,
+        output: AWSHTTPClientXMLResponseDelegate.Output,
+        timeout: TimeAmount,
+        on eventLoop: EventLoop,
+        logger: Logger,
+        metrics: RequestStageMetrics? = nil
+    ) -> EventLoopFuture<AWSHTTPResponse> {
         do {
-            let asyncRequest = try AsyncHTTPClient.HTTPClient.Request(
-                url: request.url,
-                method: request.method,
-                headers: requestHeaders,
-                body: requestBody
-            )
-            return self.execute(
-                request: asyncRequest,
-                eventLoop: .delegate(on: eventLoop),
-                deadline: .now() + timeout,
-                logger: logger
-            ).map { $0 }
+            let asyncRequest = try self.createRequest(from: request, on: eventLoop)
+            let delegate = AWSHTTPClientXMLResponseDelegate(host: asyncRequest.host, output: output)
+            return self.execute(request: asyncRequest, delegate: delegate, timeout: timeout, on: eventLoop, logger: logger, metrics: metrics)
         } catch {
             return eventLoopGroup.next().makeFailedFuture(error)
         }
     }
 
     public func execute(request: AWSHTTPRequest, timeout: TimeAmount, on eventLoop: EventLoop, logger: Logger, stream: @escaping ResponseStream) -> EventLoopFuture<AWSHTTPResponse> {
+        return self.execute(request: request, timeout: timeout, on: eventLoop, logger: logger, stream: stream, metrics: nil)
+    }
+
+    /// Execute an HTTP request with a streamed response, recording the time to first byte and transfer time of the
+    /// response if `metrics` is set
+    func execute(
+        request: AWSHTTPRequest,
+        timeout: TimeAmount,
+        on eventLoop: EventLoop,
+        logger: Logger,
+        stream: @escaping ResponseStream,
+        metrics: RequestStageMetrics?
+    ) -> EventLoopFuture<AWSHTTPResponse> {
         let requestBody: AsyncHTTPClient.HTTPClient.Body?
         if case .byteBuffer(let body) = request.body.payload {
             requestBody = .byteBuffer(body)
@@ -73,17 +96,56 @@ extension AsyncHTTPClient.HTTPClient: AWSHTTPClient {
                 body: requestBody
             )
             let delegate = AWSHTTPClientResponseDelegate(host: asyncRequest.host, stream: stream)
-            return self.execute(
-                request: asyncRequest,
-                delegate: delegate,
-                eventLoop: .delegate(on: eventLoop),
-                deadline: .now() + timeout,
-                logger: logger
-            ).futureResult
+            return self.execute(request: asyncRequest, delegate: delegate, timeout: timeout, on: eventLoop, logger: logger, metrics: metrics)
         } catch {
             return eventLoopGroup.next().makeFailedFuture(error)
         }
     }
+
+    /// Execute request with delegate, wrapping the delegate to record response metrics if `metrics` is set
+    private func execute<Delegate: HTTPClientResponseDelegate>(
+        request: AsyncHTTPClient.HTTPClient.Request,
+        delegate: Delegate,
+        timeout: TimeAmount,
+        on eventLoop: EventLoop,
+        logger: Logger,
+        metrics: RequestStageMetrics?
+    ) -> EventLoopFuture<Delegate.Response> {
+        guard let metrics = metrics else {
+            return self.execute(request: request, delegate: delegate, eventLoop: .delegate(on: eventLoop), deadline: .now() + timeout, logger: logger).futureResult
+        }
+        return self.execute(
+            request: request,
+            delegate: AWSHTTPClientTimedResponseDelegate(delegate, metrics: metrics),
+            eventLoop: .delegate(on: eventLoop),
+            deadline: .now() + timeout,
+            logger: logger
+        ).futureResult
+    }
+
+    /// Create AsyncHTTPClient request from AWSHTTPRequest
+    private func createRequest(from request: AWSHTTPRequest, on eventLoop: EventLoop) throws -> AsyncHTTPClient.HTTPClient.Request {
+        let requestBody: AsyncHTTPClient.HTTPClient.Body?
+        var requestHeaders = request.headers
+
+        switch request.body.payload {
+        case .byteBuffer(let byteBuffer):
+            requestBody = .byteBuffer(byteBuffer)
+        case .stream(let reader):
+            requestHeaders = reader.updateHeaders(headers: requestHeaders)
+            requestBody = .stream(length: reader.contentSize) { writer in
+                return writer.write(reader: reader, on: eventLoop)
+            }
+        case .empty:
+            requestBody = nil
+        }
+        return try AsyncHTTPClient.HTTPClient.Request(
+            url: request.url,
+            method: request.method,
+            headers: requestHeaders,
+            body: requestBody
+        )
+    }
 }
 
 extension AsyncHTTPClient.HTTPClient.Response: AWSHTTPResponse {}
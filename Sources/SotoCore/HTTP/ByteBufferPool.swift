@@ -0,0 +1,150 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the Soto for AWS open source project
+//
+// Copyright (c) 2017-2020 the Soto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.txt for the list of Soto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import NIO
+import NIOConcurrencyHelpers
+
+/// Bounded pool of `ByteBuffer`s, used for the working buffers of S3 chunked uploads.
+///
+/// Every buffer the pool allocates is charged against `maximumBytes` until it is freed, whether it is borrowed or held by
+/// the pool, so the total capacity of these buffers never goes above `maximumBytes`. When that limit is reached `borrow`
+/// waits until another user gives a buffer back.
+final class ByteBufferPool {
+    /// Buffer borrowed from the pool
+    struct Loan {
+        var buffer: ByteBuffer
+        /// capacity charged against `maximumBytes` while the buffer is borrowed. This is zero for buffers allocated outside
+        /// of the pool
+        let charge: Int
+    }
+
+    /// A request for a buffer that couldn't be fulfilled straight away
+    struct Waiter {
+        let capacity: Int
+        let promise: EventLoopPromise<Loan>
+    }
+
+    /// maximum total capacity of all the buffers owned by the pool
+    let maximumBytes: Int
+    private var allocated: Int
+    private var borrowed: Int
+    private var available: [ByteBuffer]
+    private var waiters: CircularBuffer<Waiter>
+    /// capacity of the buffers the allocator returned when asked for a capacity
+    private var allocatedCapacities: [Int: Int]
+    private let allocator: ByteBufferAllocator
+    private let lock = Lock()
+
+    init(maximumBytes: Int, allocator: ByteBufferAllocator = ByteBufferAllocator()) {
+        self.maximumBytes = maximumBytes
+        self.allocated = 0
+        self.borrowed = 0
+        self.available = []
+        self.waiters = .init()
+        self.allocatedCapacities = [:]
+        self.allocator = allocator
+    }
+
+    /// Borrow a buffer of at least `capacity` bytes. Buffers that wouldn't fit in `maximumBytes` are allocated outside of
+    /// the pool. Every buffer borrowed has to be returned with `giveBack`
+    func borrow(capacity: Int, on eventLoop: EventLoop) -> EventLoopFuture<Loan> {
+        return self.lock.withLock { () -> EventLoopFuture<Loan> in
+            guard self.estimatedCapacity(capacity) <= self.maximumBytes else {
+                return eventLoop.makeSucceededFuture(Loan(buffer: self.allocateBuffer(capacity: capacity), charge: 0))
+            }
+            if let loan = self.lend(capacity: capacity) {
+                return eventLoop.makeSucceededFuture(loan)
+            }
+            let promise = eventLoop.makePromise(of: Loan.self)
+            self.waiters.append(Waiter(capacity: capacity, promise: promise))
+            return promise.futureResult
+        }
+    }
+
+    /// Return a borrowed buffer to the pool, passing it on to anyone waiting for a buffer. The buffer is freed if its capacity
+    /// has changed since it was borrowed
+    func giveBack(_ loan: Loan) {
+        guard loan.charge > 0 else { return }
+        var buffer = loan.buffer
+        buffer.clear()
+        let fulfilled = self.lock.withLock { () -> [(Waiter, Loan)] in
+            self.borrowed -= loan.charge
+            if buffer.capacity == loan.charge {
+                self.available.append(buffer)
+            } else {
+                self.allocated -= loan.charge
+            }
+            var fulfilled: [(Waiter, Loan)] = []
+            while let waiter = self.waiters.first, let loan = self.lend(capacity: waiter.capacity) {
+                fulfilled.append((self.waiters.removeFirst(), loan))
+            }
+            return fulfilled
+        }
+        // complete promises outside of the lock
+        for (waiter, loan) in fulfilled {
+            waiter.promise.succeed(loan)
+        }
+    }
+
+    /// total capacity of all the buffers owned by the pool, both borrowed and available
+    var allocatedBytes: Int {
+        return self.lock.withLock { self.allocated }
+    }
+
+    /// total capacity of the buffers currently borrowed from the pool
+    var borrowedBytes: Int {
+        return self.lock.withLock { self.borrowed }
+    }
+
+    /// number of buffers available to be borrowed
+    var availableCount: Int {
+        return self.lock.withLock { self.available.count }
+    }
+
+    /// Lend an available buffer or allocate a new one if it fits within the memory limit. Must be called inside the lock
+    private func lend(capacity: Int) -> Loan? {
+        let buffer: ByteBuffer
+        if let index = self.available.firstIndex(where: { $0.capacity >= capacity }) {
+            buffer = self.available.remove(at: index)
+        } else {
+            let estimatedCapacity = self.estimatedCapacity(capacity)
+            // free available buffers that are too small until there is room for a new buffer
+            while self.allocated + estimatedCapacity > self.maximumBytes, let buffer = self.available.popLast() {
+                self.allocated -= buffer.capacity
+            }
+            guard self.allocated + estimatedCapacity <= self.maximumBytes else { return nil }
+            buffer = self.allocateBuffer(capacity: capacity)
+            self.allocated += buffer.capacity
+        }
+        self.borrowed += buffer.capacity
+        return Loan(buffer: buffer, charge: buffer.capacity)
+    }
+
+    /// Capacity of buffer the allocator will return when asked for `capacity` bytes. Until a buffer of this size has been
+    /// allocated assume the allocator rounds up to a power of two. Must be called inside the lock
+    private func estimatedCapacity(_ capacity: Int) -> Int {
+        if let allocatedCapacity = self.allocatedCapacities[capacity] {
+            return allocatedCapacity
+        }
+        guard capacity > 1 else { return capacity }
+        return 1 << (Int.bitWidth - (capacity - 1).leadingZeroBitCount)
+    }
+
+    /// Allocate buffer and record the capacity the allocator returned for the requested capacity. Must be called inside the lock
+    private func allocateBuffer(capacity: Int) -> ByteBuffer {
+        let buffer = self.allocator.buffer(capacity: capacity)
+        self.allocatedCapacities[capacity] = buffer.capacity
+        return buffer
+    }
+}
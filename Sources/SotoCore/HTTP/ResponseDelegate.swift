@@ -16,6 +16,7 @@ import AsyncHTTPClient
 import Foundation
 import NIO
 import NIOHTTP1
+import SotoXML
 
 /// HTTP client delegate capturing the body parts received from AsyncHTTPClient.
 class AWSHTTPClientResponseDelegate: HTTPClientResponseDelegate {
@@ -93,3 +94,214 @@ class AWSHTTPClientResponseDelegate: HTTPClientResponseDelegate {
         }
     }
 }
+
+/// HTTP response whose XML body was parsed while it was being received
+struct AWSParsedXMLHTTPResponse: AWSHTTPResponse {
+    /// HTTP response status
+    let status: HTTPResponseStatus
+    /// HTTP response headers
+    let headers: HTTPHeaders
+    /// Payload of response. Only set if the response was unsuccessful and the body was not parsed
+    let body: ByteBuffer?
+    /// Root element of parsed XML body
+    let element: XML.Element?
+    /// Parsed XML body, if the response was parsed for `XMLStreamingDecoder`
+    let document: XMLStreamingDecoder.Document?
+}
+
+/// HTTP client delegate that feeds the body parts of a successful response to an XML parser as they are received. This
+/// means the XML tree is built while the rest of the response is still downloading and the full body is never held in
+/// memory. The body of unsuccessful responses is accumulated so errors can be extracted from it.
+class AWSHTTPClientXMLResponseDelegate: HTTPClientResponseDelegate {
+    typealias Response = AWSHTTPResponse
+
+    /// What the XML body is parsed into
+    enum Output {
+        /// XML.Element tree
+        case element
+        /// Document for decoding with `XMLStreamingDecoder`
+        case document
+    }
+
+    enum Parser {
+        case element(XML.IncrementalParser)
+        case document(XMLStreamingDecoder.Parser)
+    }
+
+    enum State {
+        case idle
+        case parsing(HTTPResponseHead, Parser)
+        case accumulating(HTTPResponseHead, ByteBuffer?)
+        case end
+        case error(Error)
+    }
+
+    let host: String
+    let output: Output
+    var state: State
+
+    init(host: String, output: Output = .element) {
+        self.host = host
+        self.output = output
+        self.state = .idle
+    }
+
+    func didReceiveHead(task: HTTPClient.Task<Response>, _ head: HTTPResponseHead) -> EventLoopFuture<Void> {
+        switch self.state {
+        case .idle:
+            if (200..<300).contains(head.status.code) {
+                do {
+                    switch self.output {
+                    case .element:
+                        self.state = .parsing(head, .element(try XML.IncrementalParser()))
+                    case .document:
+                        self.state = .parsing(head, .document(try XMLStreamingDecoder.Parser()))
+                    }
+                } catch {
+                    self.state = .error(error)
+                }
+            } else {
+                self.state = .accumulating(head, nil)
+            }
+        case .parsing, .accumulating:
+            preconditionFailure("head already set")
+        case .end:
+            preconditionFailure("request already processed")
+        case .error:
+            break
+        }
+        return task.eventLoop.makeSucceededFuture(())
+    }
+
+    func didReceiveBodyPart(task: HTTPClient.Task<Response>, _ part: ByteBuffer) -> EventLoopFuture<Void> {
+        switch self.state {
+        case .idle:
+            preconditionFailure("no head received before body")
+        case .parsing(_, let parser):
+            do {
+                switch parser {
+                case .element(let parser):
+                    try parser.feed(part)
+                case .document(let parser):
+                    try parser.feed(part)
+                }
+            } catch {
+                self.state = .error(error)
+            }
+        case .accumulating(let head, var body):
+            var part = part
+            if body == nil {
+                body = part
+            } else {
+                body!.writeBuffer(&part)
+            }
+            self.state = .accumulating(head, body)
+        case .end:
+            preconditionFailure("request already processed")
+        case .error:
+            break
+        }
+        return task.eventLoop.makeSucceededFuture(())
+    }
+
+    func didReceiveError(task: HTTPClient.Task<Response>, _ error: Error) {
+        self.state = .error(error)
+    }
+
+    func didFinishRequest(task: HTTPClient.Task<Response>) throws -> AWSHTTPResponse {
+        switch self.state {
+        case .idle:
+            preconditionFailure("no head received before end")
+        case .parsing(let head, let parser):
+            self.state = .end
+            switch parser {
+            case .element(let parser):
+                return AWSParsedXMLHTTPResponse(
+                    status: head.status,
+                    headers: head.headers,
+                    body: nil,
+                    element: try parser.finish(),
+                    document: nil
+                )
+            case .document(let parser):
+                return AWSParsedXMLHTTPResponse(
+                    status: head.status,
+                    headers: head.headers,
+                    body: nil,
+                    element: nil,
+                    document: try parser.finish()
+                )
+            }
+        case .accumulating(let head, let body):
+            self.state = .end
+            return AWSParsedXMLHTTPResponse(
+                status: head.status,
+                headers: head.headers,
+                body: body,
+                element: nil,
+                document: nil
+            )
+        case .end:
+            preconditionFailure("request already processed")
+        case .error(let error):
+            throw error
+        }
+    }
+}
+
+/// HTTP client delegate wrapping another delegate, that records the time to first byte, transfer time and size of the
+/// response in `RequestStageMetrics`
+final class AWSHTTPClientTimedResponseDelegate<Delegate: HTTPClientResponseDelegate>: HTTPClientResponseDelegate {
+    typealias Response = Delegate.Response
+
+    let delegate: Delegate
+    let metrics: RequestStageMetrics
+    /// time request was handed to the HTTP client
+    let startTime: UInt64
+    var headTime: UInt64?
+    var bodySize: Int
+
+    init(_ delegate: Delegate, metrics: RequestStageMetrics) {
+        self.delegate = delegate
+        self.metrics = metrics
+        self.startTime = RequestStageMetrics.now()
+        self.headTime = nil
+        self.bodySize = 0
+    }
+
+    func didSendRequestHead(task: HTTPClient.Task<Response>, _ head: HTTPRequestHead) {
+        self.delegate.didSendRequestHead(task: task, head)
+    }
+
+    func didSendRequestPart(task: HTTPClient.Task<Response>, _ part: IOData) {
+        self.delegate.didSendRequestPart(task: task, part)
+    }
+
+    func didSendRequest(task: HTTPClient.Task<Response>) {
+        self.metrics.record(.requestSend, since: self.startTime)
+        self.delegate.didSendRequest(task: task)
+    }
+
+    func didReceiveHead(task: HTTPClient.Task<Response>, _ head: HTTPResponseHead) -> EventLoopFuture<Void> {
+        self.metrics.record(.timeToFirstByte, since: self.startTime)
+        self.headTime = RequestStageMetrics.now()
+        return self.delegate.didReceiveHead(task: task, head)
+    }
+
+    func didReceiveBodyPart(task: HTTPClient.Task<Response>, _ part: ByteBuffer) -> EventLoopFuture<Void> {
+        self.bodySize += part.readableBytes
+        return self.delegate.didReceiveBodyPart(task: task, part)
+    }
+
+    func didReceiveError(task: HTTPClient.Task<Response>, _ error: Error) {
+        self.delegate.didReceiveError(task: task, error)
+    }
+
+    func didFinishRequest(task: HTTPClient.Task<Response>) throws -> Response {
+        if let headTime = self.headTime {
+            self.metrics.record(.bodyTransfer, since: headTime)
+            self.metrics.recordResponseBodySize(self.bodySize)
+        }
+        return try self.delegate.didFinishRequest(task: task)
+    }
+}
@@ -19,32 +19,62 @@ import SotoSignerV4
 /// S3 Chunked signed streamer. See https://docs.aws.amazon.com/AmazonS3/latest/API/sigv4-streaming.html
 /// for more details.
 class S3ChunkedStreamReader: StreamReader {
-    /// Working buffer size
+    /// Default working buffer size
     static let bufferSize: Int = 64 * 1024
-    static let bufferSizeInHex = String(bufferSize, radix: 16)
-    static let bufferSizeLength = bufferSizeInHex.count
+    /// Minimum chunk size. S3 rejects uploads where any chunk but the last is smaller than 8K
+    static let minimumChunkSize: Int = 8 * 1024
     static let chunkSignatureLength = 1 + 16 + 64 // ";" + "chunk-signature=" + hex(sha256)
     static let endOfLineLength = 2
-    /// Maximum size of chunk header
-    static let maxHeaderSize: Int = bufferSizeInHex.count + chunkSignatureLength + endOfLineLength
 
     /// Initialise a S3ChunkedStreamReader
+    /// - Parameters:
+    ///   - size: Size of data to be streamed
+    ///   - seedSigningData: Signing data returned by `AWSSigner.startSigningChunks`
+    ///   - signer: Signer used to sign chunks
+    ///   - options: Where chunk payloads are hashed
+    ///   - chunkSize: Size of each chunk, apart from the last. Defaults to `bufferSize`. Sizes smaller than `minimumChunkSize`
+    ///         are rounded up to `minimumChunkSize`
+    ///   - bufferPool: Pool to borrow working buffers from. If this is nil the reader allocates its own working buffers
+    ///   - byteBufferAllocator: Allocator for header and working buffers
+    ///   - read: Function providing data to be streamed
     init(
         size: Int,
         seedSigningData: AWSSigner.ChunkedSigningData,
         signer: AWSSigner,
+        options: AWSClient.Options.S3ChunkedUpload = .init(),
+        chunkSize: Int? = nil,
+        bufferPool: ByteBufferPool? = nil,
         byteBufferAllocator: ByteBufferAllocator,
         read: @escaping (EventLoop) -> EventLoopFuture<StreamReaderResult>
     ) {
+        let chunkSize = max(chunkSize ?? Self.bufferSize, Self.minimumChunkSize)
+        self.signedChunkSize = chunkSize
+        let maxHeaderSize = String(chunkSize, radix: 16).count + Self.chunkSignatureLength + Self.endOfLineLength
+        self.maxHeaderSize = maxHeaderSize
+        self.bufferPool = bufferPool
         self.size = size
         self.bytesLeftToRead = size
         self.read = read
         self.signer = signer
         self.signingData = seedSigningData
+        self.threadPool = options.threadPool
+        self.readAhead = options.readAhead
+        // number of full chunks, plus a partial chunk if there is one, plus the final empty chunk
+        self.chunksLeftToRead = size / chunkSize + (size % chunkSize > 0 ? 1 : 0) + 1
+        self.pendingChunks = .init(initialCapacity: options.readAhead)
         // have separate buffers so we aren't allocating 128k
         self.byteBufferAllocator = byteBufferAllocator
-        self.headerBuffer = byteBufferAllocator.buffer(capacity: Self.maxHeaderSize)
-        self.workingBuffer = byteBufferAllocator.buffer(capacity: Self.bufferSize)
+        self.headerBuffer = byteBufferAllocator.buffer(capacity: maxHeaderSize)
+        if bufferPool == nil {
+            self.workingBuffer = byteBufferAllocator.buffer(capacity: chunkSize)
+            self.hasWorkingBuffer = true
+        } else {
+            // working buffer is borrowed from the pool on the first call to `prepareWorkingBuffer`
+            self.workingBuffer = byteBufferAllocator.buffer(capacity: 0)
+            self.hasWorkingBuffer = false
+        }
+        self.workingBufferCharge = nil
+        self.writingChunkLoan = nil
         self.tailBuffer = byteBufferAllocator.buffer(capacity: Self.endOfLineLength)
         self.tailBuffer.writeString("\r\n")
         self.previouslyReadBuffer = nil
@@ -59,15 +89,66 @@ class S3ChunkedStreamReader: StreamReader {
         return headers
     }
 
+    /// Give any buffers still borrowed back to the pool, in case the stream didn't finish
+    deinit {
+        guard let bufferPool = self.bufferPool else { return }
+        self.giveBackWorkingBuffer()
+        if let loan = self.writingChunkLoan {
+            bufferPool.giveBack(loan)
+        }
+        for chunk in self.pendingChunks {
+            chunk.whenSuccess { chunk in
+                if let loan = chunk.loan {
+                    bufferPool.giveBack(loan)
+                }
+            }
+        }
+    }
+
+    /// Make sure there is a working buffer to fill. If there is a buffer pool the working buffer is borrowed from it, otherwise
+    /// it is allocated
+    /// - Parameter eventLoop: EventLoop to work off
+    func prepareWorkingBuffer(on eventLoop: EventLoop) -> EventLoopFuture<Void> {
+        guard !self.hasWorkingBuffer else { return eventLoop.makeSucceededFuture(()) }
+        guard let bufferPool = self.bufferPool else {
+            self.workingBuffer = self.byteBufferAllocator.buffer(capacity: self.signedChunkSize)
+            self.hasWorkingBuffer = true
+            return eventLoop.makeSucceededFuture(())
+        }
+        return bufferPool.borrow(capacity: self.signedChunkSize, on: eventLoop).map { loan in
+            self.workingBuffer = loan.buffer
+            self.workingBufferCharge = loan.charge
+            self.hasWorkingBuffer = true
+        }
+    }
+
+    /// Take the working buffer away from the reader, so the next call to `prepareWorkingBuffer` provides a new one
+    /// - Returns: Loan for the working buffer if it was borrowed from the pool
+    func takeWorkingBuffer() -> ByteBufferPool.Loan? {
+        let loan = self.workingBufferCharge.map { ByteBufferPool.Loan(buffer: self.workingBuffer, charge: $0) }
+        self.workingBuffer = self.emptyBuffer
+        self.workingBufferCharge = nil
+        self.hasWorkingBuffer = false
+        return loan
+    }
+
+    /// Give working buffer back to the pool it was borrowed from
+    func giveBackWorkingBuffer() {
+        if let loan = self.takeWorkingBuffer() {
+            self.bufferPool?.giveBack(loan)
+        }
+    }
+
     /// Fill working buffer with data supplied. First verify there isnt data left over from previous call, then keep calling `read`
-    /// until the working buffer is full
+    /// until the working buffer is full. `prepareWorkingBuffer` must have been called first
     /// - Parameter eventLoop: EventLoop to work off
     /// - Returns: Full working buffer
     func fillWorkingBuffer(on eventLoop: EventLoop) -> EventLoopFuture<ByteBuffer> {
+        assert(self.hasWorkingBuffer)
         self.workingBuffer.clear()
         // if there is still data available from the previously read buffer then use that
         if var readBuffer = previouslyReadBuffer, readBuffer.readableBytes > 0 {
-            let bytesToRead = min(Self.bufferSize, readBuffer.readableBytes)
+            let bytesToRead = min(self.signedChunkSize, readBuffer.readableBytes)
             var slice = readBuffer.readSlice(length: bytesToRead)!
             if readBuffer.readableBytes == 0 {
                 self.previouslyReadBuffer = nil
@@ -76,7 +157,7 @@ class S3ChunkedStreamReader: StreamReader {
             }
             self.workingBuffer.writeBuffer(&slice)
             // if working buffer is full return the buffer
-            if self.workingBuffer.readableBytes == Self.bufferSize {
+            if self.workingBuffer.readableBytes == self.signedChunkSize {
                 return eventLoop.makeSucceededFuture(self.workingBuffer)
             }
         }
@@ -106,17 +187,17 @@ class S3ChunkedStreamReader: StreamReader {
                 // left to read and this buffer is less than the size of the chunk buffer then just return
                 // this buffer. This allows us to avoid the buffer copy
                 if self.workingBuffer.readableBytes == 0 {
-                    if buffer.readableBytes == Self.bufferSize || (self.bytesLeftToRead == 0 && buffer.readableBytes < Self.bufferSize) {
+                    if buffer.readableBytes == self.signedChunkSize || (self.bytesLeftToRead == 0 && buffer.readableBytes < self.signedChunkSize) {
                         promise.succeed(buffer)
                         return
                     }
                 }
-                let bytesRequired = Self.bufferSize - self.workingBuffer.readableBytes
+                let bytesRequired = self.signedChunkSize - self.workingBuffer.readableBytes
                 let bytesToRead = min(buffer.readableBytes, bytesRequired)
                 var slice = buffer.readSlice(length: bytesToRead)!
                 self.workingBuffer.writeBuffer(&slice)
                 // if working buffer is full then call succeed on the promise
-                if self.workingBuffer.readableBytes == Self.bufferSize {
+                if self.workingBuffer.readableBytes == self.signedChunkSize {
                     // if the supplied buffer still has readable bytes then store this buffer so those bytes can
                     // be used in the next call to `fillWorkingBuffer`.
                     if buffer.readableBytes > 0 {
@@ -147,37 +228,115 @@ class S3ChunkedStreamReader: StreamReader {
     /// Given the content size that we have said are going to provide this will get called once after everything has been
     /// streamed. This last time we will return an empty chunk. If the `read` function returns a byte buffer with
     ///
+    /// `StreamWriter` only asks for the next chunk once the previous one has been written, so the working buffer can be
+    /// refilled. Borrowed buffers are given back to the pool when the final empty chunk is returned.
+    ///
     /// - Parameter eventLoop: EventLoop to run everythin off
     func streamChunks(on eventLoop: EventLoop) -> EventLoopFuture<[ByteBuffer]> {
-        return self.fillWorkingBuffer(on: eventLoop).map { buffer in
+        if let threadPool = self.threadPool {
+            return self.streamPipelinedChunks(threadPool: threadPool, on: eventLoop)
+        }
+        return self.prepareWorkingBuffer(on: eventLoop).flatMap {
+            self.fillWorkingBuffer(on: eventLoop)
+        }.map { buffer in
             // sign header etc
-            assert(buffer.readableBytes <= Self.bufferSize)
+            assert(buffer.readableBytes <= self.signedChunkSize)
             self.signingData = self.signer.signChunk(body: .byteBuffer(buffer), signingData: self.signingData)
-            let header = "\(String(buffer.readableBytes, radix: 16));chunk-signature=\(self.signingData.signature)\r\n"
-            self.headerBuffer.clear()
-            self.headerBuffer.writeString(header)
+            guard buffer.readableBytes > 0 else {
+                // stream is finished
+                self.giveBackWorkingBuffer()
+                return self.chunkBuffers(self.emptyBuffer)
+            }
+            return self.chunkBuffers(buffer)
+        }
+    }
+
+    /// Version of `streamChunks` that reads ahead `readAhead` chunks and hashes their payloads on a thread pool. The chunk
+    /// signatures form a chain so they are still calculated in order on the EventLoop, but the expensive SHA256 of each chunk
+    /// payload is done in parallel.
+    func streamPipelinedChunks(threadPool: NIOThreadPool, on eventLoop: EventLoop) -> EventLoopFuture<[ByteBuffer]> {
+        // the previous chunk has been written so its buffer can go back to the pool
+        if let loan = self.writingChunkLoan {
+            self.bufferPool?.giveBack(loan)
+            self.writingChunkLoan = nil
+        }
+        while self.pendingChunks.count < self.readAhead, self.chunksLeftToRead > 0 {
+            self.pendingChunks.append(self.readAndHashChunk(threadPool: threadPool, on: eventLoop))
+        }
+        guard let chunk = self.pendingChunks.popFirst() else {
+            return eventLoop.makeFailedFuture(AWSClient.ClientError.tooMuchData)
+        }
+        return chunk.map { chunk in
+            assert(chunk.buffer.readableBytes <= self.signedChunkSize)
+            self.signingData = self.signer.signChunk(hashedPayload: chunk.hashedPayload, signingData: self.signingData)
+            guard chunk.buffer.readableBytes > 0 else {
+                // stream is finished
+                if let loan = chunk.loan {
+                    self.bufferPool?.giveBack(loan)
+                }
+                return self.chunkBuffers(self.emptyBuffer)
+            }
+            self.writingChunkLoan = chunk.loan
+            return self.chunkBuffers(chunk.buffer)
+        }
+    }
 
-            return [self.headerBuffer, buffer, self.tailBuffer]
+    /// Read the next chunk once the previous read has finished and then hash it on the thread pool
+    func readAndHashChunk(threadPool: NIOThreadPool, on eventLoop: EventLoop) -> EventLoopFuture<HashedChunk> {
+        self.chunksLeftToRead -= 1
+        let previousRead = self.previousChunkRead ?? eventLoop.makeSucceededFuture(())
+        // `fillWorkingBuffer` uses the working buffer so reads have to run one after the other. Each chunk takes the working
+        // buffer with it, so the next read fills a new buffer instead of writing into one that is still waiting to be sent.
+        // Reading ahead is limited by the size of the buffer pool, if there is one.
+        let chunkRead = previousRead.flatMap {
+            self.prepareWorkingBuffer(on: eventLoop)
+        }.flatMap {
+            self.fillWorkingBuffer(on: eventLoop)
+        }.map { buffer -> (ByteBuffer, ByteBufferPool.Loan?) in
+            // `fillWorkingBuffer` returns the read buffer without copying it when it can, leaving the working buffer empty
+            // for the next read
+            guard buffer.readableBytes == self.workingBuffer.readableBytes else { return (buffer, nil) }
+            return (buffer, self.takeWorkingBuffer())
+        }
+        self.previousChunkRead = chunkRead.map { _ in }
+        return chunkRead.flatMap { buffer, loan in
+            threadPool.runIfActive(eventLoop: eventLoop) {
+                HashedChunk(buffer: buffer, hashedPayload: AWSSigner.hashedPayload(.byteBuffer(buffer)), loan: loan)
+            }
         }
     }
 
+    /// Return chunk header, chunk and tail buffers
+    func chunkBuffers(_ buffer: ByteBuffer) -> [ByteBuffer] {
+        let header = "\(String(buffer.readableBytes, radix: 16));chunk-signature=\(self.signingData.signature)\r\n"
+        self.headerBuffer.clear()
+        self.headerBuffer.writeString(header)
+
+        return [self.headerBuffer, buffer, self.tailBuffer]
+    }
+
     /// Calculate content size for aws chunked data.
     var contentSize: Int? {
         let size = self.size!
-        let numberOfChunks = size / Self.bufferSize
-        let remainingBytes = size - numberOfChunks * Self.bufferSize
+        let numberOfChunks = size / self.signedChunkSize
+        let remainingBytes = size - numberOfChunks * self.signedChunkSize
         let lastChunkSize: Int
         if remainingBytes > 0 {
             lastChunkSize = remainingBytes + String(remainingBytes, radix: 16).count + Self.chunkSignatureLength + Self.endOfLineLength * 2
         } else {
             lastChunkSize = 0
         }
-        let fullSize = numberOfChunks * (Self.bufferSize + Self.maxHeaderSize + Self.endOfLineLength) // number of chunks * chunk size
+        let fullSize = numberOfChunks * (self.signedChunkSize + self.maxHeaderSize + Self.endOfLineLength) // number of chunks * chunk size
             + lastChunkSize // last chunk size
             + 1 + Self.chunkSignatureLength + Self.endOfLineLength * 2 // tail chunk size "(0;chunk-signature=hash)\r\n\r\n"
         return fullSize
     }
 
+    /// size of each chunk, apart from the last
+    let signedChunkSize: Int
+    var chunkSize: Int? { return self.signedChunkSize }
+    /// Maximum size of chunk header
+    let maxHeaderSize: Int
     /// size of data to be streamed
     let size: Int?
     /// function providing data to be streamed
@@ -190,7 +349,36 @@ class S3ChunkedStreamReader: StreamReader {
     var previouslyReadBuffer: ByteBuffer?
     var headerBuffer: ByteBuffer
     var workingBuffer: ByteBuffer
+    /// has working buffer been allocated, or borrowed from `bufferPool`
+    var hasWorkingBuffer: Bool
+    /// capacity charged by `bufferPool` for the working buffer, nil if it wasn't borrowed from the pool
+    var workingBufferCharge: Int?
+    /// pool working buffers are borrowed from
+    let bufferPool: ByteBufferPool?
     var tailBuffer: ByteBuffer
+    /// empty buffer sent as the payload of the final chunk
+    var emptyBuffer: ByteBuffer { return self.tailBuffer.getSlice(at: self.tailBuffer.readerIndex, length: 0)! }
     /// bytes left to read from `read` function
     var bytesLeftToRead: Int
+
+    /// Chunk read ahead of time along with the hash of its payload
+    struct HashedChunk {
+        let buffer: ByteBuffer
+        let hashedPayload: String
+        /// loan for the buffer if it was borrowed from the pool
+        let loan: ByteBufferPool.Loan?
+    }
+
+    /// thread pool to hash chunks on. If this is nil chunks are hashed on the EventLoop as they are requested
+    let threadPool: NIOThreadPool?
+    /// number of chunks to read and hash ahead of them being requested
+    let readAhead: Int
+    /// chunks that have been read, or are being read, but not been requested yet
+    var pendingChunks: CircularBuffer<EventLoopFuture<HashedChunk>>
+    /// loan for the buffer of the chunk last returned by `streamPipelinedChunks`, given back once it has been written
+    var writingChunkLoan: ByteBufferPool.Loan?
+    /// future for the last read chunk. The next read waits for this
+    var previousChunkRead: EventLoopFuture<Void>?
+    /// number of chunks, including the final empty one, that have not started being read
+    var chunksLeftToRead: Int
 }
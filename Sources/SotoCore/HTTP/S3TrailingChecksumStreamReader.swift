@@ -0,0 +1,145 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the Soto for AWS open source project
+//
+// Copyright (c) 2017-2020 the Soto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.txt for the list of Soto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import struct Foundation.Data
+import NIO
+import NIOHTTP1
+
+/// Streams a `ByteBuffer` body to S3 using aws-chunked content encoding with an unsigned payload and a trailing CRC32
+/// checksum. The checksum is calculated as each chunk is handed to the HTTP client, so unlike a signed payload nothing has to
+/// be read before the first byte is sent. See https://docs.aws.amazon.com/AmazonS3/latest/userguide/checking-object-integrity.html
+final class S3TrailingChecksumStreamReader: RestartableStreamReader {
+    /// Chunk size
+    static let bufferSize: Int = 64 * 1024
+    /// trailer header name
+    static let checksumHeader = "x-amz-checksum-crc32"
+    /// value of the x-amz-content-sha256 header for aws-chunked upload with an unsigned payload and checksum trailer
+    static let hashedPayload = "STREAMING-UNSIGNED-PAYLOAD-TRAILER"
+    static let endOfLineLength = 2
+    /// "0\r\n" + "x-amz-checksum-crc32:" + base64(crc32) + "\r\n\r\n"
+    static let trailerLength = 1 + endOfLineLength + checksumHeader.count + 1 + 8 + endOfLineLength * 2
+
+    init(buffer: ByteBuffer, byteBufferAllocator: ByteBufferAllocator) {
+        self.body = buffer
+        self.buffer = buffer
+        self.size = buffer.readableBytes
+        self.byteBufferAllocator = byteBufferAllocator
+        self.crc = CRC32()
+        self.tailBuffer = byteBufferAllocator.buffer(capacity: Self.endOfLineLength)
+        self.tailBuffer.writeString("\r\n")
+    }
+
+    /// Add headers required for aws-chunked upload with an unsigned payload and checksum trailer. These need to be added
+    /// before the request is signed
+    static func addSignedHeaders(to headers: inout HTTPHeaders, size: Int) {
+        headers.add(name: "x-amz-decoded-content-length", value: size.description)
+        headers.add(name: "x-amz-trailer", value: Self.checksumHeader)
+    }
+
+    /// Update HTTP headers. Add "Content-encoding" header.
+    func updateHeaders(headers: HTTPHeaders) -> HTTPHeaders {
+        var headers = headers
+        headers.add(name: "Content-Encoding", value: "aws-chunked")
+        return headers
+    }
+
+    /// Start again from the beginning of the body
+    func restart() {
+        self.buffer = self.body
+        self.crc = CRC32()
+        self.finished = false
+    }
+
+    /// Return next chunk, with its header and tail. Once all the data has been returned the final empty chunk and the
+    /// checksum trailer are returned.
+    func streamChunks(on eventLoop: EventLoop) -> EventLoopFuture<[ByteBuffer]> {
+        guard !self.finished else {
+            return eventLoop.makeSucceededFuture([])
+        }
+        guard let chunk = self.buffer.readSlice(length: min(Self.bufferSize, self.buffer.readableBytes)), chunk.readableBytes > 0 else {
+            self.finished = true
+            var trailer = self.byteBufferAllocator.buffer(capacity: Self.trailerLength)
+            trailer.writeString("0\r\n\(Self.checksumHeader):\(self.crc.base64Value)\r\n\r\n")
+            return eventLoop.makeSucceededFuture([trailer])
+        }
+        chunk.withUnsafeReadableBytes { self.crc.update($0) }
+        var header = self.byteBufferAllocator.buffer(capacity: 8)
+        header.writeString("\(String(chunk.readableBytes, radix: 16))\r\n")
+        return eventLoop.makeSucceededFuture([header, chunk, self.tailBuffer])
+    }
+
+    /// Calculate content size for aws chunked data
+    var contentSize: Int? {
+        let numberOfChunks = self.size / Self.bufferSize
+        let remainingBytes = self.size - numberOfChunks * Self.bufferSize
+        var fullSize = numberOfChunks * (String(Self.bufferSize, radix: 16).count + Self.bufferSize + Self.endOfLineLength * 2)
+        if remainingBytes > 0 {
+            fullSize += String(remainingBytes, radix: 16).count + remainingBytes + Self.endOfLineLength * 2
+        }
+        return fullSize + Self.trailerLength
+    }
+
+    var chunkSize: Int? { return Self.bufferSize }
+
+    /// size of data to be streamed
+    let size: Int?
+    /// function providing data to be streamed. Return the rest of the buffer
+    var read: (EventLoop) -> EventLoopFuture<StreamReaderResult> {
+        return { eventLoop in
+            guard let buffer = self.buffer.readSlice(length: self.buffer.readableBytes), buffer.readableBytes > 0 else {
+                return eventLoop.makeSucceededFuture(.end)
+            }
+            return eventLoop.makeSucceededFuture(.byteBuffer(buffer))
+        }
+    }
+
+    /// bytebuffer allocator
+    let byteBufferAllocator: ByteBufferAllocator
+
+    /// full body
+    let body: ByteBuffer
+    /// part of body still to be streamed
+    var buffer: ByteBuffer
+    var crc: CRC32
+    var tailBuffer: ByteBuffer
+    var finished: Bool = false
+}
+
+/// CRC32 checksum, using the same polynomial as zlib and the S3 `x-amz-checksum-crc32` header
+struct CRC32 {
+    private(set) var value: UInt32 = 0
+
+    /// Update checksum with block of bytes
+    mutating func update(_ bytes: UnsafeRawBufferPointer) {
+        var crc = ~self.value
+        for byte in bytes {
+            crc = Self.table[Int((crc ^ UInt32(byte)) & 0xFF)] ^ (crc >> 8)
+        }
+        self.value = ~crc
+    }
+
+    /// checksum as big endian bytes base64 encoded
+    var base64Value: String {
+        let bytes: [UInt8] = [UInt8(self.value >> 24), UInt8((self.value >> 16) & 0xFF), UInt8((self.value >> 8) & 0xFF), UInt8(self.value & 0xFF)]
+        return Data(bytes).base64EncodedString()
+    }
+
+    static let table: [UInt32] = (0..<256).map { (index: Int) -> UInt32 in
+        var value = UInt32(index)
+        for _ in 0..<8 {
+            value = (value & 1 == 1) ? (0xEDB8_8320 ^ (value >> 1)) : (value >> 1)
+        }
+        return value
+    }
+}
@@ -27,6 +27,8 @@ protocol StreamReader {
     var size: Int? { get }
     /// total size of data to be streamed plus any chunk headers
     var contentSize: Int? { get }
+    /// size of chunks the data should be split into when it is signed, if the stream is signed in chunks
+    var chunkSize: Int? { get }
     /// function providing data to be streamed
     var read: (EventLoop) -> EventLoopFuture<StreamReaderResult> { get }
     /// bytebuffer allocator
@@ -41,6 +43,12 @@ protocol StreamReader {
     func streamChunks(on eventLoop: EventLoop) -> EventLoopFuture<[ByteBuffer]>
 }
 
+/// Stream reader that generates its data internally and can start again from the beginning, so requests using it can be retried
+protocol RestartableStreamReader: StreamReader {
+    /// Reset reader to the start of its data. This is called before each write of the stream
+    func restart()
+}
+
 /// Standard chunked streamer. Adds transfer-encoding : chunked header if a size is not supplied. NIO adds all the chunk headers
 /// so it just passes the streamed data straight through to the StreamWriter
 struct ChunkedStreamReader: StreamReader {
@@ -73,6 +81,8 @@ struct ChunkedStreamReader: StreamReader {
 
     /// size of data to be streamed
     let size: Int?
+    /// size of chunks used by S3 chunked uploads
+    let chunkSize: Int?
     /// function providing data to be streamed
     let read: (EventLoop) -> EventLoopFuture<StreamReaderResult>
     /// bytebuffer allocator
@@ -22,6 +22,7 @@ extension AsyncHTTPClient.HTTPClient.Body.StreamWriter {
         on eventLoop: EventLoop
     ) -> EventLoopFuture<Void> {
         let promise = eventLoop.makePromise(of: Void.self)
+        (reader as? RestartableStreamReader)?.restart()
 
         func _write(_ amountLeft: Int?) {
             // get byte buffer from closure, write to StreamWriter, if there are still bytes to write then call
@@ -32,13 +32,25 @@ public struct AWSRequest {
 
     /// Create HTTP Client request from AWSRequest.
     /// If the signer's credentials are available the request will be signed. Otherwise defaults to an unsigned request
-    func createHTTPRequest(signer: AWSSigner, byteBufferAllocator: ByteBufferAllocator) -> AWSHTTPRequest {
+    func createHTTPRequest(
+        signer: AWSSigner,
+        serviceOptions: AWSServiceConfig.Options = [],
+        s3ChunkedUpload: AWSClient.Options.S3ChunkedUpload = .init(),
+        bufferPool: ByteBufferPool? = nil,
+        byteBufferAllocator: ByteBufferAllocator
+    ) -> AWSHTTPRequest {
         // if credentials are empty don't sign request
         if signer.credentials.isEmpty() {
             return self.toHTTPRequest(byteBufferAllocator: byteBufferAllocator)
         }
 
-        return self.toHTTPRequestWithSignedHeader(signer: signer, byteBufferAllocator: byteBufferAllocator)
+        return self.toHTTPRequestWithSignedHeader(
+            signer: signer,
+            serviceOptions: serviceOptions,
+            s3ChunkedUpload: s3ChunkedUpload,
+            bufferPool: bufferPool,
+            byteBufferAllocator: byteBufferAllocator
+        )
     }
 
     /// Create HTTP Client request from AWSRequest
@@ -47,12 +59,29 @@ public struct AWSRequest {
     }
 
     /// Create HTTP Client request with signed headers from AWSRequest
-    func toHTTPRequestWithSignedHeader(signer: AWSSigner, byteBufferAllocator: ByteBufferAllocator) -> AWSHTTPRequest {
+    func toHTTPRequestWithSignedHeader(
+        signer: AWSSigner,
+        serviceOptions: AWSServiceConfig.Options = [],
+        s3ChunkedUpload: AWSClient.Options.S3ChunkedUpload = .init(),
+        bufferPool: ByteBufferPool? = nil,
+        byteBufferAllocator: ByteBufferAllocator
+    ) -> AWSHTTPRequest {
         let payload = self.body.asPayload(byteBufferAllocator: byteBufferAllocator)
         let bodyDataForSigning: AWSSigner.BodyData?
         switch payload.payload {
         case .byteBuffer(let buffer):
-            bodyDataForSigning = .byteBuffer(buffer)
+            if signer.name == "s3", self.url.scheme == "https", serviceOptions.contains(.s3TrailingChecksum) {
+                var headers = httpHeaders
+                // need to add these headers here as they need to be included in the signed headers
+                S3TrailingChecksumStreamReader.addSignedHeaders(to: &headers, size: buffer.readableBytes)
+                let signedHeaders = signer.signHeaders(url: url, method: httpMethod, headers: headers, hashedPayload: S3TrailingChecksumStreamReader.hashedPayload, date: Date())
+                let reader = S3TrailingChecksumStreamReader(buffer: buffer, byteBufferAllocator: byteBufferAllocator)
+                return AWSHTTPRequest(url: url, method: httpMethod, headers: signedHeaders, body: .streamReader(reader))
+            } else if signer.name == "s3", self.url.scheme == "https", serviceOptions.contains(.s3UnsignedPayload) {
+                bodyDataForSigning = .unsignedPayload
+            } else {
+                bodyDataForSigning = .byteBuffer(buffer)
+            }
         case .stream(let reader):
             if signer.name == "s3" {
                 assert(reader.size != nil, "S3 stream requires size")
@@ -64,6 +93,9 @@ public struct AWSRequest {
                     size: reader.size!,
                     seedSigningData: seedSigningData,
                     signer: signer,
+                    options: s3ChunkedUpload,
+                    chunkSize: reader.chunkSize,
+                    bufferPool: bufferPool,
                     byteBufferAllocator: reader.byteBufferAllocator,
                     read: reader.read
                 )
@@ -0,0 +1,199 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the Soto for AWS open source project
+//
+// Copyright (c) 2017-2020 the Soto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.txt for the list of Soto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import class Foundation.JSONDecoder
+import NIO
+import NIOFoundationCompat
+
+extension AWSResponse {
+    /// Decode output shape straight from a JSON body with `JSONDecoder`, instead of converting the body to a dictionary
+    /// first. Members that come from headers or the status code are supplied alongside the JSON body.
+    func generateOutputShape<Output: AWSDecodableShape>(fromJSON buffer: ByteBuffer) throws -> Output {
+        var members: [String: String] = [:]
+        let headerParams = Output.headerParams
+        if !headerParams.isEmpty {
+            for (key, value) in self.headers {
+                if let index = headerParams.firstIndex(where: { $0.key.lowercased() == key.lowercased() }) {
+                    members[headerParams[index].key] = value as? String ?? String(describing: value)
+                }
+            }
+        }
+        if let statusCodeParam = Output.statusCodeParam {
+            members[statusCodeParam] = self.status.code.description
+        }
+
+        let decoder = JSONDecoder()
+        decoder.dateDecodingStrategy = .secondsSince1970
+        decoder.userInfo[ResponseMembersDecoder.membersKey] = members
+        do {
+            return try decoder.decode(ResponseMembersDecodable<Output>.self, from: buffer).output
+        } catch DecodingError.typeMismatch(_, let context) where context.codingPath.isEmpty {
+            // body isn't a JSON object, eg it is an array. Decode as if it was an empty object, as the dictionary
+            // based decode does
+            var emptyObject = ByteBufferAllocator().buffer(capacity: 2)
+            emptyObject.writeString("{}")
+            return try decoder.decode(ResponseMembersDecodable<Output>.self, from: emptyObject).output
+        }
+    }
+}
+
+/// Captures the `JSONDecoder` decoding the body, so the output shape can be decoded through `ResponseMembersDecoder`
+private struct ResponseMembersDecodable<Output: Decodable>: Decodable {
+    let output: Output
+
+    init(from decoder: Decoder) throws {
+        let members = decoder.userInfo[ResponseMembersDecoder.membersKey] as? [String: String] ?? [:]
+        if members.isEmpty {
+            self.output = try Output(from: decoder)
+        } else {
+            self.output = try Output(from: ResponseMembersDecoder(decoder: decoder, members: members))
+        }
+    }
+}
+
+/// Decoder that decodes the top level of an output shape from the JSON body, except for the members found in `members`.
+/// These are decoded from the header or status code string
+private struct ResponseMembersDecoder: Decoder {
+    static let membersKey = CodingUserInfoKey(rawValue: "soto.responseMembers")!
+
+    let decoder: Decoder
+    let members: [String: String]
+
+    var codingPath: [CodingKey] { return self.decoder.codingPath }
+    var userInfo: [CodingUserInfoKey: Any] { return self.decoder.userInfo }
+
+    func container<Key: CodingKey>(keyedBy type: Key.Type) throws -> KeyedDecodingContainer<Key> {
+        return KeyedDecodingContainer(Container(container: try self.decoder.container(keyedBy: type), members: self.members))
+    }
+
+    func unkeyedContainer() throws -> UnkeyedDecodingContainer {
+        return try self.decoder.unkeyedContainer()
+    }
+
+    func singleValueContainer() throws -> SingleValueDecodingContainer {
+        return try self.decoder.singleValueContainer()
+    }
+
+    struct Container<Key: CodingKey>: KeyedDecodingContainerProtocol {
+        let container: KeyedDecodingContainer<Key>
+        let members: [String: String]
+
+        var codingPath: [CodingKey] { return self.container.codingPath }
+        var allKeys: [Key] { return self.container.allKeys + self.members.keys.compactMap { Key(stringValue: $0) } }
+
+        func contains(_ key: Key) -> Bool {
+            return self.members[key.stringValue] != nil || self.container.contains(key)
+        }
+
+        func decodeNil(forKey key: Key) throws -> Bool {
+            if self.members[key.stringValue] != nil {
+                return false
+            }
+            return try self.container.decodeNil(forKey: key)
+        }
+
+        func decode<T: Decodable>(_ type: T.Type, forKey key: Key) throws -> T {
+            if let value = self.members[key.stringValue] {
+                return try T(from: ResponseMemberValueDecoder(value: value, codingPath: self.codingPath + [key]))
+            }
+            return try self.container.decode(type, forKey: key)
+        }
+
+        func decode(_ type: Bool.Type, forKey key: Key) throws -> Bool { return try self.decodeMember(type, forKey: key) }
+        func decode(_ type: String.Type, forKey key: Key) throws -> String { return try self.decodeMember(type, forKey: key) }
+        func decode(_ type: Double.Type, forKey key: Key) throws -> Double { return try self.decodeMember(type, forKey: key) }
+        func decode(_ type: Float.Type, forKey key: Key) throws -> Float { return try self.decodeMember(type, forKey: key) }
+        func decode(_ type: Int.Type, forKey key: Key) throws -> Int { return try self.decodeMember(type, forKey: key) }
+        func decode(_ type: Int8.Type, forKey key: Key) throws -> Int8 { return try self.decodeMember(type, forKey: key) }
+        func decode(_ type: Int16.Type, forKey key: Key) throws -> Int16 { return try self.decodeMember(type, forKey: key) }
+        func decode(_ type: Int32.Type, forKey key: Key) throws -> Int32 { return try self.decodeMember(type, forKey: key) }
+        func decode(_ type: Int64.Type, forKey key: Key) throws -> Int64 { return try self.decodeMember(type, forKey: key) }
+        func decode(_ type: UInt.Type, forKey key: Key) throws -> UInt { return try self.decodeMember(type, forKey: key) }
+        func decode(_ type: UInt8.Type, forKey key: Key) throws -> UInt8 { return try self.decodeMember(type, forKey: key) }
+        func decode(_ type: UInt16.Type, forKey key: Key) throws -> UInt16 { return try self.decodeMember(type, forKey: key) }
+        func decode(_ type: UInt32.Type, forKey key: Key) throws -> UInt32 { return try self.decodeMember(type, forKey: key) }
+        func decode(_ type: UInt64.Type, forKey key: Key) throws -> UInt64 { return try self.decodeMember(type, forKey: key) }
+
+        func nestedContainer<NestedKey: CodingKey>(keyedBy type: NestedKey.Type, forKey key: Key) throws -> KeyedDecodingContainer<NestedKey> {
+            return try self.container.nestedContainer(keyedBy: type, forKey: key)
+        }
+
+        func nestedUnkeyedContainer(forKey key: Key) throws -> UnkeyedDecodingContainer {
+            return try self.container.nestedUnkeyedContainer(forKey: key)
+        }
+
+        func superDecoder() throws -> Decoder {
+            return try self.container.superDecoder()
+        }
+
+        func superDecoder(forKey key: Key) throws -> Decoder {
+            return try self.container.superDecoder(forKey: key)
+        }
+
+        /// decode primitive from member string if there is one, otherwise decode from the JSON body
+        private func decodeMember<T: Decodable & LosslessStringConvertible>(_ type: T.Type, forKey key: Key) throws -> T {
+            guard let value = self.members[key.stringValue] else { return try self.container.decode(type, forKey: key) }
+            guard let decoded = T(value) else {
+                throw DecodingError.typeMismatch(type, .init(codingPath: self.codingPath + [key], debugDescription: "Expected \(type) but found \"\(value)\""))
+            }
+            return decoded
+        }
+    }
+}
+
+/// Decoder for a single header or status code value. Numbers and booleans are parsed from the string
+private struct ResponseMemberValueDecoder: Decoder, SingleValueDecodingContainer {
+    let value: String
+    let codingPath: [CodingKey]
+    var userInfo: [CodingUserInfoKey: Any] { return [:] }
+
+    func container<Key: CodingKey>(keyedBy type: Key.Type) throws -> KeyedDecodingContainer<Key> {
+        throw DecodingError.typeMismatch([String: Any].self, .init(codingPath: self.codingPath, debugDescription: "Header values cannot be decoded as a dictionary"))
+    }
+
+    func unkeyedContainer() throws -> UnkeyedDecodingContainer {
+        throw DecodingError.typeMismatch([Any].self, .init(codingPath: self.codingPath, debugDescription: "Header values cannot be decoded as an array"))
+    }
+
+    func singleValueContainer() throws -> SingleValueDecodingContainer {
+        return self
+    }
+
+    func decodeNil() -> Bool { return false }
+    func decode(_ type: String.Type) throws -> String { return self.value }
+    func decode(_ type: Bool.Type) throws -> Bool { return try self.parse(type) }
+    func decode(_ type: Double.Type) throws -> Double { return try self.parse(type) }
+    func decode(_ type: Float.Type) throws -> Float { return try self.parse(type) }
+    func decode(_ type: Int.Type) throws -> Int { return try self.parse(type) }
+    func decode(_ type: Int8.Type) throws -> Int8 { return try self.parse(type) }
+    func decode(_ type: Int16.Type) throws -> Int16 { return try self.parse(type) }
+    func decode(_ type: Int32.Type) throws -> Int32 { return try self.parse(type) }
+    func decode(_ type: Int64.Type) throws -> Int64 { return try self.parse(type) }
+    func decode(_ type: UInt.Type) throws -> UInt { return try self.parse(type) }
+    func decode(_ type: UInt8.Type) throws -> UInt8 { return try self.parse(type) }
+    func decode(_ type: UInt16.Type) throws -> UInt16 { return try self.parse(type) }
+    func decode(_ type: UInt32.Type) throws -> UInt32 { return try self.parse(type) }
+    func decode(_ type: UInt64.Type) throws -> UInt64 { return try self.parse(type) }
+
+    func decode<T: Decodable>(_ type: T.Type) throws -> T {
+        return try T(from: self)
+    }
+
+    private func parse<T: LosslessStringConvertible>(_ type: T.Type) throws -> T {
+        guard let value = T(self.value) else {
+            throw DecodingError.typeMismatch(type, .init(codingPath: self.codingPath, debugDescription: "Expected \(type) but found \"\(self.value)\""))
+        }
+        return value
+    }
+}
@@ -44,6 +44,12 @@ public struct AWSResponse {
         }
         self.headers = responseHeaders
 
+        // body may have been parsed as XML while it was being received
+        if let parsedResponse = response as? AWSParsedXMLHTTPResponse, let element = parsedResponse.element {
+            self.body = .xml(element)
+            return
+        }
+
         // body
         guard let body = response.body,
               body.readableBytes > 0
@@ -69,11 +75,8 @@ public struct AWSResponse {
             responseBody = .json(body)
 
         case .restxml, .query, .ec2:
-            if let xmlString = body.getString(at: body.readerIndex, length: body.readableBytes) {
-                let xmlDocument = try XML.Document(string: xmlString)
-                if let element = xmlDocument.rootElement() {
-                    responseBody = .xml(element)
-                }
+            if let element = try XML.Element.parse(body) {
+                responseBody = .xml(element)
             }
         }
         self.body = responseBody
@@ -90,6 +93,16 @@ public struct AWSResponse {
         return awsResponse
     }
 
+    /// Decode output shape directly from a parsed XML document. Only used for output shapes where every member comes
+    /// from the XML body
+    static func generateOutputShape<Output: AWSDecodableShape>(operation: String, from document: XMLStreamingDecoder.Document) throws -> Output {
+        var element = document.rootElement
+        if element.name == operation + "Response", let child = element.firstChild, child.name == operation + "Result" {
+            element = child
+        }
+        return try XMLStreamingDecoder().decode(Output.self, from: element)
+    }
+
     /// Generate AWSShape from AWSResponse
     func generateOutputShape<Output: AWSDecodableShape>(operation: String) throws -> Output {
         var payloadKey: String? = (Output.self as? AWSShapeWithPayload.Type)?._payloadPath
@@ -101,6 +114,11 @@ public struct AWSResponse {
                 payloadKey = name
             }
         }
+        // decode JSON straight into output shape unless it needs restructuring first
+        if case .json(let buffer) = body, payloadKey == nil, !self.isHypertextApplicationLanguage {
+            return try self.generateOutputShape(fromJSON: buffer)
+        }
+
         let decoder = DictionaryDecoder()
 
         var outputDict: [String: Any] = [:]
@@ -154,10 +172,10 @@ public struct AWSResponse {
                 outputDict[payloadKey] = payload
             }
             // if body is raw or empty then assume any date to be decoded will be coming from headers
-            decoder.dateDecodingStrategy = .formatted(HTTPHeaderDateCoder.dateFormatters.first!)
+            decoder.dateDecodingStrategy = .custom(HTTPHeaderDateCoder.decode(from:))
 
         default:
-            decoder.dateDecodingStrategy = .formatted(HTTPHeaderDateCoder.dateFormatters.first!)
+            decoder.dateDecodingStrategy = .custom(HTTPHeaderDateCoder.decode(from:))
         }
 
         // add header values to output dictionary, so they can be decoded into the response object
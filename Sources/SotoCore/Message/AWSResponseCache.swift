@@ -0,0 +1,170 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the Soto for AWS open source project
+//
+// Copyright (c) 2017-2020 the Soto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.txt for the list of Soto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import struct Foundation.UUID
+import NIO
+import NIOConcurrencyHelpers
+
+/// Bounded cache of decoded outputs for read-mostly operations, eg SSM `GetParameter` or CloudFormation `DescribeStacks`.
+///
+/// Add a cache to a service through `AWSServiceConfig` or `AWSService.with(responseCache:)`. Only operations given a
+/// time to live are cached. A cached output is returned for an identical request until its time to live has passed.
+/// When the cache is full the least recently used output is removed. Only add operations whose results it is
+/// acceptable to be out of date by up to their time to live.
+public final class AWSResponseCache {
+    struct Key: Hashable {
+        /// outputs are not shared between clients, as they may be using different credentials
+        let client: UUID
+        /// access key id of the credential the request was signed with, so outputs aren't returned after the client's
+        /// credentials change to a different identity
+        let credential: String
+        let request: SingleFlight.Key
+    }
+
+    /// Entry in cache. Entries are also nodes in a linked list ordered from most to least recently used
+    final class Entry {
+        let key: Key
+        let output: Any
+        let expires: NIODeadline
+        var previous: Entry?
+        var next: Entry?
+
+        init(key: Key, output: Any, expires: NIODeadline) {
+            self.key = key
+            self.output = output
+            self.expires = expires
+        }
+    }
+
+    /// Maximum number of outputs held
+    public let maxCount: Int
+    /// time to live of outputs for each cached operation
+    public let timeToLive: [String: TimeAmount]
+
+    private var entries: [Key: Entry] = [:]
+    /// most recently used entry
+    private var head: Entry?
+    /// least recently used entry
+    private var tail: Entry?
+    private let lock = Lock()
+
+    /// Initialise an AWSResponseCache
+    /// - Parameters:
+    ///   - maxCount: Maximum number of outputs to hold
+    ///   - timeToLive: How long outputs are cached for, indexed by operation name. Operations not included are not cached
+    public init(maxCount: Int = 256, timeToLive: [String: TimeAmount]) {
+        precondition(maxCount > 0, "AWSResponseCache must be able to hold at least one output")
+        self.maxCount = maxCount
+        self.timeToLive = timeToLive
+    }
+
+    /// number of outputs in cache, including ones that have expired but haven't been removed yet
+    public var count: Int {
+        return self.lock.withLock { self.entries.count }
+    }
+
+    /// Remove all outputs from cache
+    public func removeAll() {
+        self.lock.withLockVoid {
+            // break links so entries aren't kept alive by each other
+            var entry = self.head
+            while let current = entry {
+                entry = current.next
+                current.previous = nil
+                current.next = nil
+            }
+            self.entries.removeAll()
+            self.head = nil
+            self.tail = nil
+        }
+    }
+
+    /// Remove all outputs added by a client
+    func removeAll(client: UUID) {
+        self.lock.withLockVoid {
+            for entry in self.entries.values where entry.key.client == client {
+                self.remove(entry)
+            }
+        }
+    }
+
+    /// Return cached output for request if there is one that hasn't expired
+    func output<Output>(for key: Key, type: Output.Type, now: NIODeadline = .now()) -> Output? {
+        return self.lock.withLock {
+            guard let entry = self.entries[key] else { return nil }
+            guard entry.expires > now else {
+                self.remove(entry)
+                return nil
+            }
+            self.moveToHead(entry)
+            return entry.output as? Output
+        }
+    }
+
+    /// Add output for a request, removing the least recently used output if the cache is full
+    func set<Output>(_ output: Output, for key: Key, operation: String, now: NIODeadline = .now()) {
+        guard let timeToLive = self.timeToLive[operation] else { return }
+        let entry = Entry(key: key, output: output, expires: now + timeToLive)
+        self.lock.withLockVoid {
+            if let existing = self.entries[key] {
+                self.remove(existing)
+            }
+            while self.entries.count >= self.maxCount, let leastRecentlyUsed = self.tail {
+                self.remove(leastRecentlyUsed)
+            }
+            self.entries[key] = entry
+            self.insertAtHead(entry)
+        }
+    }
+
+    /// Must be called inside the lock
+    private func remove(_ entry: Entry) {
+        self.entries[entry.key] = nil
+        self.unlink(entry)
+    }
+
+    /// Must be called inside the lock
+    private func moveToHead(_ entry: Entry) {
+        guard self.head !== entry else { return }
+        self.unlink(entry)
+        self.insertAtHead(entry)
+    }
+
+    /// Must be called inside the lock
+    private func insertAtHead(_ entry: Entry) {
+        entry.next = self.head
+        entry.previous = nil
+        self.head?.previous = entry
+        self.head = entry
+        if self.tail == nil {
+            self.tail = entry
+        }
+    }
+
+    /// Must be called inside the lock
+    private func unlink(_ entry: Entry) {
+        if let previous = entry.previous {
+            previous.next = entry.next
+        } else if self.head === entry {
+            self.head = entry.next
+        }
+        if let next = entry.next {
+            next.previous = entry.previous
+        } else if self.tail === entry {
+            self.tail = entry.previous
+        }
+        entry.previous = nil
+        entry.next = nil
+    }
+}
@@ -76,9 +76,8 @@ extension Body {
 
         case .xml(let node):
             let xmlDocument = XML.Document(rootElement: node)
-            let text = xmlDocument.xmlString
-            var buffer = byteBufferAllocator.buffer(capacity: text.utf8.count)
-            buffer.writeString(text)
+            var buffer = byteBufferAllocator.buffer(capacity: 1024)
+            xmlDocument.writeXML(to: &buffer)
             return .byteBuffer(buffer)
 
         case .empty:
@@ -0,0 +1,144 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the Soto for AWS open source project
+//
+// Copyright (c) 2017-2020 the Soto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.txt for the list of Soto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import NIO
+import SotoXML
+
+extension XML.IncrementalParser {
+    /// Feed parser the readable bytes of a ByteBuffer. The bytes are parsed where they sit, no copy of the
+    /// buffer or conversion to a String is made
+    /// - Parameter buffer: ByteBuffer containing UTF8 data
+    func feed(_ buffer: ByteBuffer) throws {
+        try buffer.withUnsafeReadableBytes { bytes in
+            try self.feed(bytes)
+        }
+    }
+}
+
+extension XMLStreamingDecoder.Parser {
+    /// Feed parser the readable bytes of a ByteBuffer without copying them
+    /// - Parameter buffer: ByteBuffer containing UTF8 data
+    func feed(_ buffer: ByteBuffer) throws {
+        try buffer.withUnsafeReadableBytes { bytes in
+            try self.feed(bytes)
+        }
+    }
+}
+
+extension XML.Element {
+    /// Parse a ByteBuffer containing a XML document and return its root element
+    /// - Parameter buffer: ByteBuffer containing UTF8 XML
+    /// - Returns: Root element or nil if the buffer was empty
+    static func parse(_ buffer: ByteBuffer) throws -> XML.Element? {
+        let parser = try XML.IncrementalParser()
+        try parser.feed(buffer)
+        return try parser.finish()
+    }
+}
+
+extension XML.Node {
+    /// Write formatted XML into a ByteBuffer. The output is the same as `xmlString` but is written as UTF8 straight
+    /// into the buffer instead of being built by concatenating the strings of every node in the tree
+    /// - Parameter buffer: ByteBuffer to write to
+    func writeXML(to buffer: inout ByteBuffer) {
+        switch self.kind {
+        case .document:
+            guard let document = self as? XML.Document else { return }
+            buffer.writeStaticString("<?xml version=\"")
+            buffer.writeString(document.version ?? "1.0")
+            buffer.writeStaticString("\" encoding=\"")
+            buffer.writeString(document.characterEncoding ?? "UTF-8")
+            buffer.writeStaticString("\"?>")
+            document.rootElement()?.writeXML(to: &buffer)
+        case .element:
+            guard let element = self as? XML.Element, let name = element.name else { return }
+            buffer.writeStaticString("<")
+            buffer.writeString(name)
+            for namespace in element.namespaces ?? [] {
+                buffer.writeStaticString(" ")
+                namespace.writeXML(to: &buffer)
+            }
+            for attribute in element.attributes ?? [] {
+                buffer.writeStaticString(" ")
+                attribute.writeXML(to: &buffer)
+            }
+            buffer.writeStaticString(">")
+            for node in element.children ?? [] {
+                node.writeXML(to: &buffer)
+            }
+            buffer.writeStaticString("</")
+            buffer.writeString(name)
+            buffer.writeStaticString(">")
+        case .text:
+            if let stringValue = self.stringValue {
+                buffer.writeXMLEncodedString(stringValue)
+            }
+        case .attribute:
+            guard let name = self.name else { return }
+            buffer.writeString(name)
+            buffer.writeStaticString("=\"")
+            buffer.writeXMLEncodedString(self.stringValue ?? "")
+            buffer.writeStaticString("\"")
+        case .comment:
+            guard let stringValue = self.stringValue else { return }
+            buffer.writeStaticString("<!--")
+            buffer.writeString(stringValue)
+            buffer.writeStaticString("-->")
+        case .namespace:
+            buffer.writeStaticString("xmlns")
+            if let name = self.name, name != "" {
+                buffer.writeStaticString(":")
+                buffer.writeString(name)
+            }
+            buffer.writeStaticString("=\"")
+            buffer.writeXMLEncodedString(self.stringValue ?? "")
+            buffer.writeStaticString("\"")
+        }
+    }
+}
+
+extension ByteBuffer {
+    /// Write text or attribute value replacing the characters that are XML markup, including quotes, with their
+    /// entities. Runs of bytes that don't need replacing are written in one go, so strings without markup characters
+    /// are copied straight into the buffer.
+    /// - Parameter string: String to write
+    mutating func writeXMLEncodedString(_ string: String) {
+        var string = string
+        string.withUTF8 { utf8 in
+            let bytes = UnsafeRawBufferPointer(utf8)
+            var runStart = 0
+            for index in 0..<bytes.count {
+                let replacement: StaticString
+                switch bytes[index] {
+                case UInt8(ascii: "&"):
+                    replacement = "&amp;"
+                case UInt8(ascii: "<"):
+                    replacement = "&lt;"
+                case UInt8(ascii: ">"):
+                    replacement = "&gt;"
+                case UInt8(ascii: "\""):
+                    replacement = "&quot;"
+                case UInt8(ascii: "'"):
+                    replacement = "&apos;"
+                default:
+                    continue
+                }
+                self.writeBytes(UnsafeRawBufferPointer(rebasing: bytes[runStart..<index]))
+                self.writeStaticString(replacement)
+                runStart = index + 1
+            }
+            self.writeBytes(UnsafeRawBufferPointer(rebasing: bytes[runStart..<bytes.count]))
+        }
+    }
+}
@@ -0,0 +1,66 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the Soto for AWS open source project
+//
+// Copyright (c) 2017-2020 the Soto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.txt for the list of Soto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Dispatch
+import Metrics
+
+/// Records how long each stage of a request takes in swift-metrics, with the same "aws-service" and "aws-operation"
+/// dimensions as `aws_request_duration`. Only created if `AWSClient.Options.recordStageMetrics` is set.
+struct RequestStageMetrics {
+    /// Stages of a request, and the label of the timer they are recorded with
+    enum Stage: String {
+        /// getting credentials from the credential provider
+        case credential = "aws_credential_duration"
+        /// signing the HTTP request
+        case signing = "aws_signing_duration"
+        /// from handing the request to the HTTP client to the request being sent. This includes setting up a connection
+        case requestSend = "aws_request_send_duration"
+        /// from handing the request to the HTTP client to receiving the response head
+        case timeToFirstByte = "aws_time_to_first_byte"
+        /// from receiving the response head to receiving the last of the response body
+        case bodyTransfer = "aws_response_transfer_duration"
+        /// generating the output shape from the response
+        case decode = "aws_decode_duration"
+    }
+
+    let dimensions: [(String, String)]
+
+    init(service: String, operation: String) {
+        self.dimensions = [("aws-service", service), ("aws-operation", operation)]
+    }
+
+    /// current time in nanoseconds
+    static func now() -> UInt64 {
+        return DispatchTime.now().uptimeNanoseconds
+    }
+
+    /// record time from `startTime` until now for stage
+    func record(_ stage: Stage, since startTime: UInt64) {
+        Metrics.Timer(
+            label: stage.rawValue,
+            dimensions: self.dimensions,
+            preferredDisplayUnit: .seconds
+        ).recordNanoseconds(Self.now() - startTime)
+    }
+
+    /// record size of response body in bytes
+    func recordResponseBodySize(_ size: Int) {
+        Recorder(label: "aws_response_body_size", dimensions: self.dimensions).record(size)
+    }
+
+    /// record number of attempts it took to complete a request, including the first
+    func recordAttempts(_ attempts: Int) {
+        Recorder(label: "aws_request_attempts", dimensions: self.dimensions).record(attempts)
+    }
+}
@@ -37,6 +37,19 @@ public struct RetryPolicyFactory {
     public static func jitter(base: TimeAmount = .seconds(1), maxRetries: Int = 4) -> RetryPolicyFactory {
         return .init(retryPolicy: JitterRetry(base: base, maxRetries: maxRetries))
     }
+
+    /// Jitter retry limited by a retry quota, as in the AWS SDK "standard" retry mode. The quota is shared by all the
+    /// requests made by the `AWSClient` using this policy. Each retry takes tokens from the quota and successful requests
+    /// return them. Once the quota is empty failed requests are not retried, so a failing service is not flooded with retries.
+    public static func standard(base: TimeAmount = .seconds(1), maxRetries: Int = 4) -> RetryPolicyFactory {
+        return .init(retryPolicy: TokenBucketRetry(base: base, maxRetries: maxRetries, rateLimiting: false))
+    }
+
+    /// Standard retry with client side rate limiting, as in the AWS SDK "adaptive" retry mode. Once a service has throttled
+    /// a request, requests to that service are paced before they are signed, at a rate that is adjusted from how often it throttles.
+    public static func adaptive(base: TimeAmount = .seconds(1), maxRetries: Int = 4) -> RetryPolicyFactory {
+        return .init(retryPolicy: TokenBucketRetry(base: base, maxRetries: maxRetries, rateLimiting: true))
+    }
 }
 
 /// Return value for `RetryPolicy.getRetryWaitTime`. Either retry after time amount or don't retry
@@ -0,0 +1,281 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the Soto for AWS open source project
+//
+// Copyright (c) 2020 the Soto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.txt for the list of Soto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import AsyncHTTPClient
+import NIO
+import NIOConcurrencyHelpers
+#if os(Linux)
+import Glibc
+#else
+import Darwin.C
+#endif
+
+/// Retry policy whose state is shared by all the requests made by an `AWSClient`. `AWSClient` calls these as well as
+/// `getRetryWaitTime` while it runs a request.
+protocol RetryQuotaPolicy: RetryPolicy {
+    /// Return future that is fulfilled when a request to service can be sent
+    func waitToSend(service: String, on eventLoop: EventLoop) -> EventLoopFuture<Void>
+    /// Called with the result of every attempt at a request, `error` is nil if the attempt succeeded
+    func attemptCompleted(service: String, error: Error?)
+    /// Take tokens from the retry quota to retry after error. Returns the number of tokens taken, or nil if there are
+    /// not enough tokens left and the request should not be retried
+    func acquireRetryTokens(error: Error) -> Int?
+    /// Called when a request succeeds, with the tokens taken by its last retry or nil if it wasn't retried
+    func releaseRetryTokens(_ tokens: Int?)
+}
+
+/// Jitter retry limited by a retry quota, and optionally a client side rate limiter for each service. These follow the
+/// AWS SDK "standard" and "adaptive" retry modes.
+final class TokenBucketRetry: RetryQuotaPolicy {
+    let retry: JitterRetry
+    let quota: RetryQuota
+    /// rate limiters for each service, if rate limiting is enabled
+    private var rateLimiters: [String: ClientRateLimiter]?
+    private let lock = Lock()
+
+    init(base: TimeAmount, maxRetries: Int, rateLimiting: Bool, quota: RetryQuota = RetryQuota()) {
+        self.retry = JitterRetry(base: base, maxRetries: maxRetries)
+        self.quota = quota
+        self.rateLimiters = rateLimiting ? [:] : nil
+    }
+
+    func getRetryWaitTime(error: Error, attempt: Int) -> RetryStatus? {
+        return self.retry.getRetryWaitTime(error: error, attempt: attempt)
+    }
+
+    func waitToSend(service: String, on eventLoop: EventLoop) -> EventLoopFuture<Void> {
+        guard let rateLimiter = self.rateLimiter(for: service),
+              let wait = rateLimiter.acquire(now: Self.now())
+        else {
+            return eventLoop.makeSucceededFuture(())
+        }
+        return eventLoop.scheduleTask(in: .nanoseconds(Int64(wait * 1_000_000_000))) {}.futureResult
+    }
+
+    func attemptCompleted(service: String, error: Error?) {
+        self.rateLimiter(for: service)?.update(isThrottle: error.map { Self.isThrottle($0) } ?? false, now: Self.now())
+    }
+
+    func acquireRetryTokens(error: Error) -> Int? {
+        return self.quota.acquire(cost: Self.isTimeout(error) ? RetryQuota.timeoutRetryCost : RetryQuota.retryCost)
+    }
+
+    func releaseRetryTokens(_ tokens: Int?) {
+        self.quota.release(tokens ?? RetryQuota.noRetryIncrement)
+    }
+
+    /// Return rate limiter for service, creating it if it doesn't exist
+    private func rateLimiter(for service: String) -> ClientRateLimiter? {
+        return self.lock.withLock {
+            guard self.rateLimiters != nil else { return nil }
+            if let rateLimiter = self.rateLimiters?[service] {
+                return rateLimiter
+            }
+            let rateLimiter = ClientRateLimiter()
+            self.rateLimiters?[service] = rateLimiter
+            return rateLimiter
+        }
+    }
+
+    /// current time in seconds
+    static func now() -> Double {
+        return Double(NIODeadline.now().uptimeNanoseconds) / 1_000_000_000
+    }
+
+    /// error codes returned when a request is throttled
+    static let throttlingErrorCodes: Set<String> = [
+        "Throttling",
+        "ThrottlingException",
+        "ThrottledException",
+        "RequestThrottledException",
+        "TooManyRequestsException",
+        "ProvisionedThroughputExceededException",
+        "TransactionInProgressException",
+        "RequestLimitExceeded",
+        "BandwidthLimitExceeded",
+        "LimitExceededException",
+        "RequestThrottled",
+        "SlowDown",
+        "PriorRequestNotComplete",
+        "EC2ThrottledException",
+    ]
+
+    static func isThrottle(_ error: Error) -> Bool {
+        guard let error = error as? AWSErrorType else { return false }
+        return error.context?.responseCode.code == 429 || self.throttlingErrorCodes.contains(error.errorCode)
+    }
+
+    static func isTimeout(_ error: Error) -> Bool {
+        switch error {
+        case let httpClientError as HTTPClientError:
+            return httpClientError == .readTimeout || httpClientError == .remoteConnectionClosed
+        case is NIOConnectionError:
+            return true
+        default:
+            return false
+        }
+    }
+}
+
+/// Quota of tokens used up by retries. While a service is failing the quota is exhausted and requests stop being retried,
+/// instead of every request retrying and adding to the load on the service. Successful requests refill the quota.
+final class RetryQuota {
+    static let initialCapacity = 500
+    static let retryCost = 5
+    static let timeoutRetryCost = 10
+    static let noRetryIncrement = 1
+
+    /// capacity the quota starts with, it is never refilled past this
+    let maxCapacity: Int
+    private var capacity: Int
+    private let lock = Lock()
+
+    init(capacity: Int = RetryQuota.initialCapacity) {
+        self.maxCapacity = capacity
+        self.capacity = capacity
+    }
+
+    /// tokens left in quota
+    var availableCapacity: Int {
+        return self.lock.withLock { self.capacity }
+    }
+
+    /// Take tokens from quota. Returns nil if there aren't enough
+    func acquire(cost: Int) -> Int? {
+        return self.lock.withLock {
+            guard self.capacity >= cost else { return nil }
+            self.capacity -= cost
+            return cost
+        }
+    }
+
+    /// Return tokens to quota
+    func release(_ tokens: Int) {
+        self.lock.withLockVoid {
+            self.capacity = min(self.capacity + tokens, self.maxCapacity)
+        }
+    }
+}
+
+/// Client side rate limiter for one service. Once a request to the service has been throttled, requests are sent at
+/// a rate limited by a token bucket. The rate is cut when a request is throttled and grows back along a cubic curve
+/// (as in TCP CUBIC congestion control) while requests succeed, so it stays close to the highest rate the service allows
+/// without oscillating. This is the client rate limiter from the AWS SDK "adaptive" retry mode.
+final class ClientRateLimiter {
+    static let minFillRate = 0.5
+    static let minCapacity = 1.0
+    /// weight given to latest measurement of sending rate
+    static let smooth = 0.8
+    /// rate is multiplied by this when a request is throttled
+    static let beta = 0.7
+    /// controls how fast the rate grows back after being throttled
+    static let scaleConstant = 0.4
+
+    private var fillRate: Double = 0
+    private var maxCapacity: Double = 0
+    private var currentCapacity: Double = 0
+    private var lastTimestamp: Double?
+    /// only start limiting the rate once a request has been throttled
+    private var enabled = false
+
+    private var measuredTxRate: Double = 0
+    private var lastTxRateBucket: Double
+    private var requestCount = 0
+    private var lastMaxRate: Double = 0
+    private var lastThrottleTime: Double
+    private var timeWindow: Double = 0
+    private let lock = Lock()
+
+    init(now: Double = TokenBucketRetry.now()) {
+        self.lastTxRateBucket = (now * 2).rounded(.down) / 2
+        self.lastThrottleTime = now
+    }
+
+    /// is rate limiting enabled
+    var isEnabled: Bool {
+        return self.lock.withLock { self.enabled }
+    }
+
+    /// current limit on requests per second
+    var sendingRate: Double {
+        return self.lock.withLock { self.fillRate }
+    }
+
+    /// Take a token to send a request. Returns how long in seconds to wait before sending, or nil if it can be sent now.
+    /// Tokens are taken even if there aren't enough, so concurrent requests queue up behind each other
+    func acquire(now: Double) -> Double? {
+        return self.lock.withLock {
+            guard self.enabled else { return nil }
+            self.refill(now: now)
+            self.currentCapacity -= 1
+            guard self.currentCapacity < 0 else { return nil }
+            return -self.currentCapacity / self.fillRate
+        }
+    }
+
+    /// Update sending rate after a response
+    func update(isThrottle: Bool, now: Double) {
+        self.lock.withLockVoid {
+            self.updateMeasuredRate(now: now)
+            let calculatedRate: Double
+            if isThrottle {
+                let rateToUse = self.enabled ? min(self.measuredTxRate, self.fillRate) : self.measuredTxRate
+                self.lastMaxRate = rateToUse
+                self.calculateTimeWindow()
+                self.lastThrottleTime = now
+                calculatedRate = rateToUse * Self.beta
+                self.enabled = true
+            } else {
+                self.calculateTimeWindow()
+                calculatedRate = Self.scaleConstant * pow(now - self.lastThrottleTime - self.timeWindow, 3) + self.lastMaxRate
+            }
+            self.updateRate(min(calculatedRate, 2 * self.measuredTxRate), now: now)
+        }
+    }
+
+    /// Must be called inside the lock
+    private func refill(now: Double) {
+        guard let lastTimestamp = self.lastTimestamp else {
+            self.lastTimestamp = now
+            return
+        }
+        self.currentCapacity = min(self.maxCapacity, self.currentCapacity + (now - lastTimestamp) * self.fillRate)
+        self.lastTimestamp = now
+    }
+
+    /// Must be called inside the lock
+    private func updateRate(_ rate: Double, now: Double) {
+        self.refill(now: now)
+        self.fillRate = max(rate, Self.minFillRate)
+        self.maxCapacity = max(rate, Self.minCapacity)
+        self.currentCapacity = min(self.currentCapacity, self.maxCapacity)
+    }
+
+    /// Must be called inside the lock
+    private func calculateTimeWindow() {
+        self.timeWindow = cbrt(self.lastMaxRate * (1 - Self.beta) / Self.scaleConstant)
+    }
+
+    /// Measure rate requests are being sent in half second buckets. Must be called inside the lock
+    private func updateMeasuredRate(now: Double) {
+        let timeBucket = (now * 2).rounded(.down) / 2
+        self.requestCount += 1
+        if timeBucket > self.lastTxRateBucket {
+            let currentRate = Double(self.requestCount) / (timeBucket - self.lastTxRateBucket)
+            self.measuredTxRate = currentRate * Self.smooth + self.measuredTxRate * (1 - Self.smooth)
+            self.requestCount = 0
+            self.lastTxRateBucket = timeBucket
+        }
+    }
+}
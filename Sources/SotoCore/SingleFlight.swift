@@ -0,0 +1,84 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the Soto for AWS open source project
+//
+// Copyright (c) 2017-2020 the Soto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.txt for the list of Soto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import NIO
+import NIOConcurrencyHelpers
+import NIOHTTP1
+
+/// Shares one in-flight request between callers making identical requests.
+///
+/// While a request is running, any identical request joins it instead of being signed and sent again. Once the request
+/// completes it is forgotten, so later callers send a new request. This is how `RotatingCredentialProvider` shares a
+/// credential refresh between callers.
+final class SingleFlight {
+    /// Identifies a request. Everything that goes into the HTTP request before signing is included
+    struct Key: Hashable {
+        let operation: String
+        let httpMethod: String
+        let url: String
+        let headers: [String]
+        let body: [UInt8]
+        /// requests with the same HTTP request but decoded to different types can't share a result
+        let outputType: ObjectIdentifier
+
+        /// Create key for request. Returns nil if the request can't be shared because its body is streamed
+        init?<Output>(request: AWSRequest, outputType: Output.Type, byteBufferAllocator: ByteBufferAllocator) {
+            guard !request.body.isStreaming else { return nil }
+            self.operation = request.operation
+            self.httpMethod = request.httpMethod.rawValue
+            self.url = request.url.absoluteString
+            self.headers = request.httpHeaders.map { "\($0.name.lowercased()):\($0.value)" }
+            if let buffer = request.body.asByteBuffer(byteBufferAllocator: byteBufferAllocator) {
+                self.body = buffer.getBytes(at: buffer.readerIndex, length: buffer.readableBytes) ?? []
+            } else {
+                self.body = []
+            }
+            self.outputType = ObjectIdentifier(outputType)
+        }
+    }
+
+    private var inFlight: [Key: Any] = [:]
+    private let lock = Lock()
+
+    /// Return the in-flight future for this key if there is one, otherwise start a new request with `execute`
+    func execute<Output>(key: Key, on eventLoop: EventLoop, _ execute: () -> EventLoopFuture<Output>) -> EventLoopFuture<Output> {
+        let promise: EventLoopPromise<Output>? = self.lock.withLock {
+            if self.inFlight[key] != nil {
+                return nil
+            }
+            let promise = eventLoop.makePromise(of: Output.self)
+            self.inFlight[key] = promise.futureResult
+            return promise
+        }
+        guard let newPromise = promise else {
+            let future = self.lock.withLock { self.inFlight[key] as? EventLoopFuture<Output> }
+            // the request may have completed since it was checked, if so send a new one
+            guard let inFlightFuture = future else { return execute() }
+            // We want to hop back to the event loop we came in case the request is resolved on another EventLoop
+            return inFlightFuture.hop(to: eventLoop)
+        }
+        // forget the request before anyone waiting on it is told it has completed
+        newPromise.futureResult.whenComplete { _ in
+            self.lock.withLockVoid { self.inFlight[key] = nil }
+        }
+        // run the request outside of the lock in case it completes immediately
+        execute().cascade(to: newPromise)
+        return newPromise.futureResult
+    }
+
+    /// number of requests in flight
+    var count: Int {
+        return self.lock.withLock { self.inFlight.count }
+    }
+}
@@ -86,6 +86,20 @@ extension AWSClient {
             }
             return timeDelay
         }
+
+        /// Return waiter state for the result of an API call. If no acceptor matches the result, errors fail the waiter
+        /// and anything else is retried
+        func state(for result: Result<Output, Error>) -> WaiterState {
+            for acceptor in self.acceptors {
+                if acceptor.matcher.match(result: result.map { $0 }) {
+                    return acceptor.state
+                }
+            }
+            if case .failure = result {
+                return .failure
+            }
+            return .retry
+        }
     }
 
     /// Returns an `EventLoopFuture` that will by fulfilled once waiter polling returns a success state
@@ -113,24 +127,8 @@ extension AWSClient {
         func attempt(number: Int) {
             waiter.command(input, logger, eventLoop)
                 .whenComplete { result in
-                    var acceptorState: WaiterState?
-                    for acceptor in waiter.acceptors {
-                        if acceptor.matcher.match(result: result.map { $0 }) {
-                            acceptorState = acceptor.state
-                            break
-                        }
-                    }
-                    // if state has not been set then set it based on return of API call
-                    let waiterState: WaiterState
-                    if let state = acceptorState {
-                        waiterState = state
-                    } else if case .failure = result {
-                        waiterState = .failure
-                    } else {
-                        waiterState = .retry
-                    }
                     // based on state succeed, fail promise or retry
-                    switch waiterState {
+                    switch waiter.state(for: result) {
                     case .success:
                         promise.succeed(())
                     case .failure:
@@ -0,0 +1,273 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the Soto for AWS open source project
+//
+// Copyright (c) 2017-2020 the Soto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.txt for the list of Soto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Logging
+import NIO
+
+// MARK: Batched waiters
+
+extension AWSClient {
+    /// Describes how the inputs of waiters polling the same operation can be combined into one API call, and how to
+    /// extract each waiter's part of the combined output. eg one `DescribeInstances` call can cover the instance ids of
+    /// many `InstanceRunning` waiters.
+    public struct WaiterBatching<Input, Output> {
+        /// Initialize waiter batching
+        /// - Parameters:
+        ///   - maxBatchSize: Maximum number of inputs combined into one API call
+        ///   - batchKey: Key for input. Only inputs with the same key are combined. This would normally be the input
+        ///     with the resource identifiers removed
+        ///   - combine: Combine inputs into one input
+        ///   - split: Extract the part of the combined output that is for one input
+        public init(
+            maxBatchSize: Int,
+            batchKey: @escaping (Input) -> AnyHashable,
+            combine: @escaping ([Input]) -> Input,
+            split: @escaping (Output, Input) -> Output
+        ) {
+            precondition(maxBatchSize > 0, "maxBatchSize must be greater than zero")
+            self.maxBatchSize = maxBatchSize
+            self.batchKey = batchKey
+            self.combine = combine
+            self.split = split
+        }
+
+        let maxBatchSize: Int
+        let batchKey: (Input) -> AnyHashable
+        let combine: ([Input]) -> Input
+        let split: (Output, Input) -> Output
+    }
+
+    /// Polls many waiters using the same `Waiter`, combining the waiters with compatible inputs into one API call each
+    /// time they poll. Each waiter's acceptors are run against its part of the combined output, and it keeps its own
+    /// retry delays and deadline. Waiters that are due to poll within `minDelayTime` of each other share the same call.
+    ///
+    /// If the combined call fails, the error is passed to the acceptors of every waiter in the batch. When a waiter added
+    /// by a call to `waitUntil` fails or times out, the other waiters added by that call stop polling.
+    public final class WaiterCoordinator<Input, Output> {
+        /// Initialize waiter coordinator
+        /// - Parameters:
+        ///   - waiter: Waiter to wait on
+        ///   - batching: How inputs are combined
+        ///   - eventLoop: EventLoop the coordinator state is kept on, and API calls are run on
+        public init(waiter: Waiter<Input, Output>, batching: WaiterBatching<Input, Output>, eventLoop: EventLoop) {
+            self.waiter = waiter
+            self.batching = batching
+            self.eventLoop = eventLoop
+            self.groups = [:]
+        }
+
+        /// Returns an `EventLoopFuture` that will by fulfilled once waiter polling of this input returns a success state
+        /// or returns an error if the polling returns an error or timesout
+        ///
+        /// - Parameters:
+        ///   - input: Input parameters
+        ///   - maxWaitTime: Maximum amount of time to wait
+        ///   - logger: Logger used to provide output
+        /// - Returns: EventLoopFuture that will be fulfilled once waiter has completed
+        public func waitUntil(_ input: Input, maxWaitTime: TimeAmount? = nil, logger: Logger = AWSClient.loggingDisabled) -> EventLoopFuture<Void> {
+            return self.waitUntil([input], maxWaitTime: maxWaitTime, logger: logger)
+        }
+
+        /// Returns an `EventLoopFuture` that will by fulfilled once waiter polling of all these inputs returns a success
+        /// state or returns an error if the polling of any of them returns an error or timesout. Once one of the inputs
+        /// has failed the others are no longer polled.
+        ///
+        /// - Parameters:
+        ///   - inputs: Input parameters
+        ///   - maxWaitTime: Maximum amount of time to wait
+        ///   - logger: Logger used to provide output
+        /// - Returns: EventLoopFuture that will be fulfilled once waiter has completed for all inputs
+        public func waitUntil(_ inputs: [Input], maxWaitTime: TimeAmount? = nil, logger: Logger = AWSClient.loggingDisabled) -> EventLoopFuture<Void> {
+            let deadline: NIODeadline = .now() + (maxWaitTime ?? self.waiter.maxDelayTime)
+            let call = WaitCall()
+            let pending = inputs.map {
+                PendingWaiter(
+                    input: $0,
+                    promise: self.eventLoop.makePromise(),
+                    call: call,
+                    logger: logger,
+                    deadline: deadline,
+                    attempt: 1,
+                    nextPoll: .now()
+                )
+            }
+            self.eventLoop.execute {
+                pending.forEach { self.add($0) }
+            }
+            let result = EventLoopFuture.andAllSucceed(pending.map { $0.promise.futureResult }, on: self.eventLoop)
+            // callbacks are run on `eventLoop`
+            result.whenFailure { error in
+                self.cancel(call, error: error)
+            }
+            return result
+        }
+
+        /// Waiters added by one call to `waitUntil`
+        final class WaitCall {
+            /// Error the first of the waiters failed with. Only accessed on `eventLoop`
+            var error: Error?
+        }
+
+        /// Waiter waiting for its next poll
+        struct PendingWaiter {
+            let input: Input
+            let promise: EventLoopPromise<Void>
+            let call: WaitCall
+            let logger: Logger
+            let deadline: NIODeadline
+            var attempt: Int
+            var nextPoll: NIODeadline
+        }
+
+        /// Waiters whose inputs can be combined
+        final class Group {
+            var pending: [PendingWaiter] = []
+            var scheduled: (task: Scheduled<Void>, deadline: NIODeadline)?
+        }
+
+        /// Add waiter to its group and schedule the group's next poll. Must be called on `eventLoop`
+        private func add(_ pending: PendingWaiter) {
+            let key = self.batching.batchKey(pending.input)
+            let group: Group
+            if let existingGroup = self.groups[key] {
+                group = existingGroup
+            } else {
+                group = Group()
+                self.groups[key] = group
+            }
+            group.pending.append(pending)
+            self.schedule(group, key: key)
+        }
+
+        /// Schedule poll for when the earliest waiter in the group is due. Must be called on `eventLoop`
+        private func schedule(_ group: Group, key: AnyHashable) {
+            guard let nextPoll = group.pending.map({ $0.nextPoll }).min() else {
+                group.scheduled?.task.cancel()
+                group.scheduled = nil
+                self.groups[key] = nil
+                return
+            }
+            if let scheduled = group.scheduled {
+                guard nextPoll < scheduled.deadline else { return }
+                scheduled.task.cancel()
+            }
+            let task = self.eventLoop.scheduleTask(deadline: nextPoll) { self.poll(group, key: key) }
+            group.scheduled = (task: task, deadline: nextPoll)
+        }
+
+        /// Send one API call for each batch of waiters that are due. Must be called on `eventLoop`
+        private func poll(_ group: Group, key: AnyHashable) {
+            group.scheduled = nil
+            // waiters due before the next call could be made share this one
+            let window = NIODeadline.now() + self.waiter.minDelayTime
+            var due: [PendingWaiter] = []
+            var notDue: [PendingWaiter] = []
+            for pending in group.pending {
+                if pending.nextPoll <= window {
+                    due.append(pending)
+                } else {
+                    notDue.append(pending)
+                }
+            }
+            group.pending = notDue
+
+            for index in stride(from: 0, to: due.count, by: self.batching.maxBatchSize) {
+                let batch = Array(due[index..<min(index + self.batching.maxBatchSize, due.count)])
+                let input = self.batching.combine(batch.map { $0.input })
+                let logger = batch[0].logger
+                logger.trace("Polling \(batch.count) waiters")
+                self.waiter.command(input, logger, self.eventLoop)
+                    .hop(to: self.eventLoop)
+                    .whenComplete { result in
+                        for pending in batch {
+                            self.complete(pending, result: result.map { self.batching.split($0, pending.input) })
+                        }
+                    }
+            }
+            self.schedule(group, key: key)
+        }
+
+        /// Fail all the waiters from a call to `waitUntil` that are waiting to poll, because one of them has failed. Waiters
+        /// whose poll is in progress are failed when it completes. Must be called on `eventLoop`
+        private func cancel(_ call: WaitCall, error: Error) {
+            call.error = error
+            for (key, group) in self.groups {
+                let cancelled = group.pending.filter { $0.call === call }
+                guard cancelled.count > 0 else { continue }
+                group.pending.removeAll { $0.call === call }
+                cancelled.forEach { $0.promise.fail(error) }
+                self.schedule(group, key: key)
+            }
+        }
+
+        /// Succeed, fail or reschedule waiter based on the result of its poll. Must be called on `eventLoop`
+        private func complete(_ pending: PendingWaiter, result: Result<Output, Error>) {
+            var pending = pending
+            if let error = pending.call.error {
+                pending.promise.fail(error)
+                return
+            }
+            switch self.waiter.state(for: result) {
+            case .success:
+                pending.promise.succeed(())
+            case .failure:
+                if case .failure(let error) = result {
+                    pending.promise.fail(error)
+                } else {
+                    pending.promise.fail(ClientError.waiterFailed)
+                }
+            case .retry:
+                let wait = self.waiter.calculateRetryWaitTime(attempt: pending.attempt, remainingTime: pending.deadline - .now())
+                if wait < .seconds(0) {
+                    pending.promise.fail(ClientError.waiterTimeout)
+                } else {
+                    pending.logger.trace("Wait \(wait.nanoseconds / 1_000_000)ms")
+                    pending.attempt += 1
+                    pending.nextPoll = .now() + wait
+                    self.add(pending)
+                }
+            }
+        }
+
+        let waiter: Waiter<Input, Output>
+        let batching: WaiterBatching<Input, Output>
+        let eventLoop: EventLoop
+        /// groups of waiters, only accessed on `eventLoop`
+        private var groups: [AnyHashable: Group]
+    }
+
+    /// Returns an `EventLoopFuture` that will by fulfilled once waiter polling of all the inputs returns a success state
+    /// or returns an error if the polling of any of them returns an error or timesout. Inputs that can be combined are
+    /// polled with one API call, as described by `batching`.
+    ///
+    /// - Parameters:
+    ///   - inputs: Input parameters
+    ///   - waiter: Waiter to wait on
+    ///   - batching: How inputs are combined
+    ///   - maxWaitTime: Maximum amount of time to wait
+    ///   - logger: Logger used to provide output
+    ///   - eventLoop: EventLoop to run API calls on
+    /// - Returns: EventLoopFuture that will be fulfilled once waiter has completed for all inputs
+    public func waitUntil<Input, Output>(
+        _ inputs: [Input],
+        waiter: Waiter<Input, Output>,
+        batching: WaiterBatching<Input, Output>,
+        maxWaitTime: TimeAmount? = nil,
+        logger: Logger = AWSClient.loggingDisabled,
+        on eventLoop: EventLoop? = nil
+    ) -> EventLoopFuture<Void> {
+        let coordinator = WaiterCoordinator(waiter: waiter, batching: batching, eventLoop: eventLoop ?? eventLoopGroup.next())
+        return coordinator.waitUntil(inputs, maxWaitTime: maxWaitTime, logger: logger)
+    }
+}
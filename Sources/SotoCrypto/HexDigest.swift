@@ -0,0 +1,77 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the Soto for AWS open source project
+//
+// Copyright (c) 2017-2020 the Soto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.txt for the list of Soto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import protocol Foundation.ContiguousBytes
+
+/// lower case hex digits indexed by nibble value
+private let hexDigits: StaticString = "0123456789abcdef"
+
+/// return hex encoded string of a buffer of bytes. Buffers of up to 64 bytes (SHA512) are formatted on the stack
+private func hexEncodedString(_ bytes: UnsafeRawBufferPointer) -> String {
+    let digits = hexDigits.utf8Start
+    func encode(into output: UnsafeMutablePointer<UInt8>) {
+        for (index, byte) in bytes.enumerated() {
+            output[index * 2] = digits[Int(byte >> 4)]
+            output[index * 2 + 1] = digits[Int(byte & 0xF)]
+        }
+    }
+    let count = bytes.count * 2
+    if bytes.count <= 64 {
+        var storage: (UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64,
+                      UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64) = (0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0)
+        return withUnsafeMutableBytes(of: &storage) { buffer in
+            let output = buffer.baseAddress!.assumingMemoryBound(to: UInt8.self)
+            encode(into: output)
+            return String(decoding: UnsafeBufferPointer(start: output, count: count), as: Unicode.UTF8.self)
+        }
+    } else {
+        let output = UnsafeMutablePointer<UInt8>.allocate(capacity: count)
+        defer { output.deallocate() }
+        encode(into: output)
+        return String(decoding: UnsafeBufferPointer(start: output, count: count), as: Unicode.UTF8.self)
+    }
+}
+
+/// return a hex encoded string from a sequence of bytes. This is `Sequence.hexDigest()` as a module level function, so modules
+/// providing their own `hexDigest()` can forward to it by its qualified name
+public func hexDigest<Bytes: Sequence>(_ bytes: Bytes) -> String where Bytes.Element == UInt8 {
+    return bytes.hexDigest()
+}
+
+extension Sequence where Element == UInt8 {
+    /// return a hex encoded string from a sequence of bytes
+    public func hexDigest() -> String {
+        if let string = self.withContiguousStorageIfAvailable({ hexEncodedString(.init($0)) }) {
+            return string
+        }
+        return [UInt8](self).withUnsafeBytes { hexEncodedString($0) }
+    }
+
+    /// append hex encoding of a sequence of bytes to a buffer
+    public func hexDigest<Buffer: RangeReplaceableCollection>(into buffer: inout Buffer) where Buffer.Element == UInt8 {
+        let digits = hexDigits.utf8Start
+        buffer.reserveCapacity(buffer.count + self.underestimatedCount * 2)
+        for byte in self {
+            buffer.append(digits[Int(byte >> 4)])
+            buffer.append(digits[Int(byte & 0xF)])
+        }
+    }
+}
+
+extension Sequence where Self: ContiguousBytes, Element == UInt8 {
+    /// return a hex encoded string from a digest or other contiguous block of bytes
+    public func hexDigest() -> String {
+        return self.withUnsafeBytes { hexEncodedString($0) }
+    }
+}
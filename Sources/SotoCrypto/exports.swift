@@ -15,5 +15,7 @@
 // Replicating the CryptoKit framework interface for < macOS 10.15
 
 #if os(Linux)
+// On Linux the hash functions come from swift-crypto. Its BoringSSL SHA256 block functions detect SHA-NI on x86_64 and the
+// ARMv8 crypto extensions on aarch64 at runtime, and `HMAC<SHA256>` is built on the same hash function.
 @_exported import Crypto
 #endif
@@ -15,9 +15,6 @@
 import struct Foundation.CharacterSet
 import struct Foundation.Data
 import struct Foundation.Date
-import class Foundation.DateFormatter
-import struct Foundation.Locale
-import struct Foundation.TimeZone
 import struct Foundation.URL
 import struct Foundation.URLComponents
 import SotoCrypto
@@ -30,16 +27,23 @@ public struct AWSSigner {
     public let name: String
     /// AWS region you are working in
     public let region: String
+    /// cache of signing keys and credential scopes shared between signers
+    public let signingKeyCache: SigningKeyCache?
 
     static let hashedEmptyBody = SHA256.hash(data: [UInt8]()).hexDigest()
 
-    private static let timeStampDateFormatter: DateFormatter = createTimeStampDateFormatter()
-
     /// Initialise the Signer class with AWS credentials
-    public init(credentials: Credential, name: String, region: String) {
+    /// - Parameters:
+    ///   - credentials: security credentials
+    ///   - name: service signing name
+    ///   - region: AWS region
+    ///   - signingKeyCache: optional cache to store derived signing keys in. Share this between signers to avoid
+    ///         re-deriving the signing key for every request
+    public init(credentials: Credential, name: String, region: String, signingKeyCache: SigningKeyCache? = nil) {
         self.credentials = credentials
         self.name = name
         self.region = region
+        self.signingKeyCache = signingKeyCache
     }
 
     /// Enum for holding your body data
@@ -74,7 +78,13 @@ public struct AWSSigner {
 
     /// Generate signed headers, for a HTTP request
     public func signHeaders(url: URL, method: HTTPMethod = .GET, headers: HTTPHeaders = HTTPHeaders(), body: BodyData? = nil, date: Date = Date()) -> HTTPHeaders {
-        let bodyHash = AWSSigner.hashedPayload(body)
+        return self.signHeaders(url: url, method: method, headers: headers, hashedPayload: AWSSigner.hashedPayload(body), date: date)
+    }
+
+    /// Generate signed headers, for a HTTP request whose payload hash has already been calculated. This is also used
+    /// for payloads `BodyData` can't describe, where `hashedPayload` is one of the special values S3 accepts in the
+    /// `x-amz-content-sha256` header
+    public func signHeaders(url: URL, method: HTTPMethod = .GET, headers: HTTPHeaders = HTTPHeaders(), hashedPayload bodyHash: String, date: Date = Date()) -> HTTPHeaders {
         let dateString = AWSSigner.timestamp(date)
         var headers = headers
         // add date, host, sha256 and if available security token headers
@@ -86,11 +96,11 @@ public struct AWSSigner {
         }
 
         // construct signing data. Do this after adding the headers as it uses data from the headers
-        let signingData = AWSSigner.SigningData(url: url, method: method, headers: headers, body: body, bodyHash: bodyHash, date: dateString, signer: self)
+        let signingData = AWSSigner.SigningData(url: url, method: method, headers: headers, bodyHash: bodyHash, date: dateString, signer: self)
 
         // construct authorization string
         let authorization = "AWS4-HMAC-SHA256 " +
-            "Credential=\(credentials.accessKeyId)/\(signingData.date)/\(region)/\(name)/aws4_request, " +
+            "Credential=\(credentials.accessKeyId)/\(scope(date: signingData.date)), " +
             "SignedHeaders=\(signingData.signedHeaders), " +
             "Signature=\(signature(signingData: signingData))"
 
@@ -112,7 +122,7 @@ public struct AWSSigner {
             query += "&"
         }
         query += "X-Amz-Algorithm=AWS4-HMAC-SHA256"
-        query += "&X-Amz-Credential=\(credentials.accessKeyId)/\(signingData.date)/\(region)/\(name)/aws4_request"
+        query += "&X-Amz-Credential=\(credentials.accessKeyId)/\(scope(date: signingData.date))"
         query += "&X-Amz-Date=\(signingData.datetime)"
         query += "&X-Amz-Expires=\(expires.nanoseconds / 1_000_000_000)"
         query += "&X-Amz-SignedHeaders=\(signingData.signedHeaders)"
@@ -171,7 +181,7 @@ public struct AWSSigner {
 
         // construct authorization string
         let authorization = "AWS4-HMAC-SHA256 " +
-            "Credential=\(credentials.accessKeyId)/\(signingData.date)/\(region)/\(name)/aws4_request, " +
+            "Credential=\(credentials.accessKeyId)/\(scope(date: signingData.date)), " +
             "SignedHeaders=\(signingData.signedHeaders), " +
             "Signature=\(signature)"
 
@@ -187,8 +197,28 @@ public struct AWSSigner {
     ///   - signingData: Signing data returned from previous `signChunk` or `startSigningChunk` if this is the first call
     /// - Returns: signing data that includes the signature and other data that is required for signing the next chunk
     public func signChunk(body: BodyData, signingData: ChunkedSigningData) -> ChunkedSigningData {
-        let stringToSign = self.chunkStringToSign(body: body, previousSignature: signingData.signature, datetime: signingData.datetime)
-        let signature = HMAC<SHA256>.authenticationCode(for: [UInt8](stringToSign.utf8), using: signingData.signingKey).hexDigest()
+        var stringToSign: [UInt8] = []
+        stringToSign.reserveCapacity(384)
+        self.writeChunkStringToSign(body: body, previousSignature: signingData.signature, datetime: signingData.datetime, into: &stringToSign)
+        return self.signChunk(stringToSign: stringToSign, signingData: signingData)
+    }
+
+    /// Generate the signature for a chunk in a s3 chunked upload, given the hash of the chunk. The chunk signatures form a chain
+    /// so they have to be generated in order, but the chunk hashes do not. Use this to calculate the chunk hashes elsewhere
+    /// - Parameters:
+    ///   - hashedPayload: SHA256 hash of chunk as returned by `AWSSigner.hashedPayload`
+    ///   - signingData: Signing data returned from previous `signChunk` or `startSigningChunk` if this is the first call
+    /// - Returns: signing data that includes the signature and other data that is required for signing the next chunk
+    public func signChunk(hashedPayload: String, signingData: ChunkedSigningData) -> ChunkedSigningData {
+        var stringToSign: [UInt8] = []
+        stringToSign.reserveCapacity(384)
+        self.writeChunkStringToSignHeader(previousSignature: signingData.signature, datetime: signingData.datetime, into: &stringToSign)
+        stringToSign.append(contentsOf: hashedPayload.utf8)
+        return self.signChunk(stringToSign: stringToSign, signingData: signingData)
+    }
+
+    func signChunk(stringToSign: [UInt8], signingData: ChunkedSigningData) -> ChunkedSigningData {
+        let signature = HMAC<SHA256>.authenticationCode(for: stringToSign, using: signingData.signingKey).hexDigest()
         return ChunkedSigningData(signature: signature, datetime: signingData.datetime, signingKey: signingData.signingKey)
     }
 
@@ -198,7 +228,8 @@ public struct AWSSigner {
         let method: HTTPMethod
         let hashedPayload: String
         let datetime: String
-        let headersToSign: [String: String]
+        /// headers to sign, with lowercased names, sorted by name. Headers with the same name are adjacent
+        let headersToSign: [(name: String, value: String)]
         let signedHeaders: String
         var unsignedURL: URL
 
@@ -218,65 +249,240 @@ public struct AWSSigner {
                 self.hashedPayload = AWSSigner.hashedPayload(body)
             }
 
-            let headersNotToSign: Set<String> = [
-                "Authorization",
-            ]
-            var headersToSign: [String: String] = [:]
-            var signedHeadersArray: [String] = []
-            for header in headers {
-                if headersNotToSign.contains(header.name) {
-                    continue
-                }
-                headersToSign[header.name] = header.value
-                signedHeadersArray.append(header.name.lowercased())
+            var headersToSign: [(offset: Int, name: String, value: String)] = []
+            headersToSign.reserveCapacity(headers.count)
+            for (offset, header) in headers.enumerated() where header.name != "Authorization" {
+                headersToSign.append((offset: offset, name: header.name.lowercased(), value: header.value))
+            }
+            // sort by name, keeping the original order of headers with the same name
+            headersToSign.sort { $0.name < $1.name || ($0.name == $1.name && $0.offset < $1.offset) }
+            self.headersToSign = headersToSign.map { (name: $0.name, value: $0.value) }
+            // headers with the same name only appear once in the signed headers list
+            var signedHeaders: [String] = []
+            signedHeaders.reserveCapacity(headersToSign.count)
+            for header in headersToSign where header.name != signedHeaders.last {
+                signedHeaders.append(header.name)
             }
-            self.headersToSign = headersToSign
-            self.signedHeaders = signedHeadersArray.sorted().joined(separator: ";")
+            self.signedHeaders = signedHeaders.joined(separator: ";")
         }
     }
 
     // Stage 3 Calculating signature as in https://docs.aws.amazon.com/general/latest/gr/sigv4-calculate-signature.html
     func signature(signingData: SigningData) -> String {
+        // The canonical request and then the string to sign are written into the same buffer
+        var buffer: [UInt8] = []
+        buffer.reserveCapacity(1024)
+        self.writeCanonicalRequest(signingData: signingData, into: &buffer)
+        var sha256 = SHA256()
+        buffer.withUnsafeBytes { sha256.update(bufferPointer: $0) }
+        let canonicalRequestHash = sha256.finalize()
+
+        buffer.removeAll(keepingCapacity: true)
+        self.writeStringToSign(signingData: signingData, canonicalRequestHash: canonicalRequestHash, into: &buffer)
         let signingKey = self.signingKey(date: signingData.date)
-        let kSignature = HMAC<SHA256>.authenticationCode(for: [UInt8](stringToSign(signingData: signingData).utf8), using: signingKey)
+        let kSignature = HMAC<SHA256>.authenticationCode(for: buffer, using: signingKey)
         return kSignature.hexDigest()
     }
 
     /// Stage 2 Create the string to sign as in https://docs.aws.amazon.com/general/latest/gr/sigv4-create-string-to-sign.html
     func stringToSign(signingData: SigningData) -> String {
-        let stringToSign = "AWS4-HMAC-SHA256\n" +
-            "\(signingData.datetime)\n" +
-            "\(signingData.date)/\(region)/\(name)/aws4_request\n" +
-            SHA256.hash(data: [UInt8](canonicalRequest(signingData: signingData).utf8)).hexDigest()
-        return stringToSign
+        var buffer: [UInt8] = []
+        let canonicalRequestHash = SHA256.hash(data: [UInt8](canonicalRequest(signingData: signingData).utf8))
+        self.writeStringToSign(signingData: signingData, canonicalRequestHash: canonicalRequestHash, into: &buffer)
+        return String(decoding: buffer, as: Unicode.UTF8.self)
     }
 
     /// Stage 1 Create the canonical request as in https://docs.aws.amazon.com/general/latest/gr/sigv4-create-canonical-request.html
     func canonicalRequest(signingData: SigningData) -> String {
-        let canonicalHeaders = signingData.headersToSign
-            .map { (key: $0.key.lowercased(), value: $0.value) }
-            .sorted { $0.key < $1.key }
-            .map { return "\($0.key):\($0.value.trimmingCharacters(in: CharacterSet.whitespaces))" }
-            .joined(separator: "\n")
-        let canonicalPath: String
-        let urlComps = URLComponents(url: signingData.unsignedURL, resolvingAgainstBaseURL: false)!
+        var buffer: [UInt8] = []
+        self.writeCanonicalRequest(signingData: signingData, into: &buffer)
+        return String(decoding: buffer, as: Unicode.UTF8.self)
+    }
+
+    /// Write string to sign into byte buffer
+    func writeStringToSign(signingData: SigningData, canonicalRequestHash: SHA256.Digest, into buffer: inout [UInt8]) {
+        buffer.append(contentsOf: "AWS4-HMAC-SHA256\n".utf8)
+        buffer.append(contentsOf: signingData.datetime.utf8)
+        buffer.append(UInt8(ascii: "\n"))
+        buffer.append(contentsOf: self.scope(date: signingData.date).utf8)
+        buffer.append(UInt8(ascii: "\n"))
+        canonicalRequestHash.hexDigest(into: &buffer)
+    }
+
+    /// Write canonical request into byte buffer
+    func writeCanonicalRequest(signingData: SigningData, into buffer: inout [UInt8]) {
+        let url = signingData.unsignedURL.absoluteString.utf8
+        let (path, query) = Self.pathAndQuery(url)
+
+        buffer.append(contentsOf: signingData.method.rawValue.utf8)
+        buffer.append(UInt8(ascii: "\n"))
         if name == "s3" {
-            canonicalPath = urlComps.path.uriEncodeWithSlash()
+            Self.writeURIEncoded(percentDecoding: url[path], into: &buffer)
         } else {
             // non S3 paths need to be encoded twice
-            canonicalPath = urlComps.percentEncodedPath.uriEncodeWithSlash()
+            Self.writeURIEncoded(url[path], encodeSlash: false, into: &buffer)
+        }
+        buffer.append(UInt8(ascii: "\n"))
+        // assuming query parameters have are already percent encoded correctly
+        buffer.append(contentsOf: url[query])
+        buffer.append(UInt8(ascii: "\n"))
+        var previousName: String?
+        for header in signingData.headersToSign {
+            if header.name == previousName {
+                // values of headers with the same name are combined into a comma separated list
+                buffer.append(UInt8(ascii: ","))
+            } else {
+                if previousName != nil {
+                    buffer.append(UInt8(ascii: "\n"))
+                }
+                buffer.append(contentsOf: header.name.utf8)
+                buffer.append(UInt8(ascii: ":"))
+                previousName = header.name
+            }
+            Self.writeCanonicalHeaderValue(header.value.utf8, into: &buffer)
+        }
+        buffer.append(contentsOf: "\n\n".utf8)
+        buffer.append(contentsOf: signingData.signedHeaders.utf8)
+        buffer.append(UInt8(ascii: "\n"))
+        buffer.append(contentsOf: signingData.hashedPayload.utf8)
+    }
+
+    /// Return ranges of the percent encoded path and the query in a URL string
+    static func pathAndQuery(_ url: String.UTF8View) -> (path: Range<String.Index>, query: Range<String.Index>) {
+        var index = url.startIndex
+        // skip past scheme and authority
+        if let schemeEnd = url.firstIndex(of: UInt8(ascii: ":")),
+           url[schemeEnd...].starts(with: "://".utf8) {
+            index = url.index(schemeEnd, offsetBy: 3)
+            while index != url.endIndex, url[index] != UInt8(ascii: "/"), url[index] != UInt8(ascii: "?"), url[index] != UInt8(ascii: "#") {
+                index = url.index(after: index)
+            }
+        }
+        let pathStart = index
+        while index != url.endIndex, url[index] != UInt8(ascii: "?"), url[index] != UInt8(ascii: "#") {
+            index = url.index(after: index)
+        }
+        let path = pathStart..<index
+        guard index != url.endIndex, url[index] == UInt8(ascii: "?") else { return (path: path, query: index..<index) }
+        let queryStart = url.index(after: index)
+        let queryEnd = url[queryStart...].firstIndex(of: UInt8(ascii: "#")) ?? url.endIndex
+        return (path: path, query: queryStart..<queryEnd)
+    }
+
+    /// Write bytes percent encoding everything except the unreserved characters "A-Za-z0-9-._~" and optionally "/"
+    static func writeURIEncoded<Bytes: Sequence>(_ bytes: Bytes, encodeSlash: Bool, into buffer: inout [UInt8]) where Bytes.Element == UInt8 {
+        let mask: UInt8 = encodeSlash ? CharacterClass.unreserved : CharacterClass.unreserved | CharacterClass.slash
+        for byte in bytes {
+            if self.characterClasses[Int(byte)] & mask != 0 {
+                buffer.append(byte)
+            } else {
+                Self.writePercentEncoded(byte, into: &buffer)
+            }
         }
-        let canonicalRequest = "\(signingData.method.rawValue)\n" +
-            "\(canonicalPath)\n" +
-            "\(signingData.unsignedURL.query ?? "")\n" + // assuming query parameters have are already percent encoded correctly
-            "\(canonicalHeaders)\n\n" +
-            "\(signingData.signedHeaders)\n" +
-            signingData.hashedPayload
-        return canonicalRequest
     }
 
+    /// Write percent encoded path, decoding it first and then re-encoding it with `writeURIEncoded`
+    static func writeURIEncoded(percentDecoding bytes: Substring.UTF8View, into buffer: inout [UInt8]) {
+        var index = bytes.startIndex
+        while index != bytes.endIndex {
+            var byte = bytes[index]
+            index = bytes.index(after: index)
+            if byte == UInt8(ascii: "%"),
+               let high = bytes[index...].first.flatMap({ Self.hexValue($0) }),
+               let low = bytes[bytes.index(after: index)...].first.flatMap({ Self.hexValue($0) }) {
+                byte = high << 4 | low
+                index = bytes.index(index, offsetBy: 2)
+            }
+            if self.characterClasses[Int(byte)] & (CharacterClass.unreserved | CharacterClass.slash) != 0 {
+                buffer.append(byte)
+            } else {
+                Self.writePercentEncoded(byte, into: &buffer)
+            }
+        }
+    }
+
+    /// Write header value as it appears in the canonical request. Leading and trailing spaces and tabs are removed
+    /// and each run of spaces and tabs inside the value is replaced by a single space
+    static func writeCanonicalHeaderValue(_ bytes: String.UTF8View, into buffer: inout [UInt8]) {
+        var pendingSpace = false
+        var started = false
+        for byte in bytes {
+            if byte == UInt8(ascii: " ") || byte == UInt8(ascii: "\t") {
+                pendingSpace = started
+            } else {
+                if pendingSpace {
+                    buffer.append(UInt8(ascii: " "))
+                    pendingSpace = false
+                }
+                buffer.append(byte)
+                started = true
+            }
+        }
+    }
+
+    static func writePercentEncoded(_ byte: UInt8, into buffer: inout [UInt8]) {
+        buffer.append(UInt8(ascii: "%"))
+        buffer.append(self.upperHexDigits[Int(byte >> 4)])
+        buffer.append(self.upperHexDigits[Int(byte & 0xF)])
+    }
+
+    static func hexValue(_ byte: UInt8) -> UInt8? {
+        switch byte {
+        case UInt8(ascii: "0")...UInt8(ascii: "9"): return byte - UInt8(ascii: "0")
+        case UInt8(ascii: "A")...UInt8(ascii: "F"): return byte - UInt8(ascii: "A") + 10
+        case UInt8(ascii: "a")...UInt8(ascii: "f"): return byte - UInt8(ascii: "a") + 10
+        default: return nil
+        }
+    }
+
+    /// flags used by `characterClasses`
+    enum CharacterClass {
+        static let unreserved: UInt8 = 1
+        static let slash: UInt8 = 2
+    }
+
+    /// table of character classes for each byte value, used for percent encoding
+    static let characterClasses: [UInt8] = (0...255).map { (byte: Int) -> UInt8 in
+        switch UInt8(byte) {
+        case UInt8(ascii: "A")...UInt8(ascii: "Z"), UInt8(ascii: "a")...UInt8(ascii: "z"), UInt8(ascii: "0")...UInt8(ascii: "9"),
+             UInt8(ascii: "-"), UInt8(ascii: "."), UInt8(ascii: "_"), UInt8(ascii: "~"):
+            return CharacterClass.unreserved
+        case UInt8(ascii: "/"):
+            return CharacterClass.slash
+        default:
+            return 0
+        }
+    }
+
+    static let upperHexDigits: [UInt8] = Array("0123456789ABCDEF".utf8)
+
     /// get signing key
     func signingKey(date: String) -> SymmetricKey {
+        return self.cachedEntry(date: date)?.signingKey ?? self.deriveSigningKey(date: date)
+    }
+
+    /// get credential scope "date/region/service/aws4_request"
+    func scope(date: String) -> String {
+        return self.cachedEntry(date: date)?.scope ?? "\(date)/\(region)/\(name)/aws4_request"
+    }
+
+    /// get signing key and credential scope from the signing key cache, deriving them if they are not already there
+    func cachedEntry(date: String) -> SigningKeyCache.Entry? {
+        guard let cache = self.signingKeyCache else { return nil }
+        let key = SigningKeyCache.Key(
+            date: date,
+            region: self.region,
+            service: self.name,
+            accessKeyId: self.credentials.accessKeyId,
+            secretAccessKey: self.credentials.secretAccessKey
+        )
+        return cache.entry(for: key) {
+            SigningKeyCache.Entry(signingKey: self.deriveSigningKey(date: date), scope: "\(date)/\(region)/\(name)/aws4_request")
+        }
+    }
+
+    /// derive signing key from secret access key, date, region and service name
+    func deriveSigningKey(date: String) -> SymmetricKey {
         let kDate = HMAC<SHA256>.authenticationCode(for: [UInt8](date.utf8), using: SymmetricKey(data: Array("AWS4\(credentials.secretAccessKey)".utf8)))
         let kRegion = HMAC<SHA256>.authenticationCode(for: [UInt8](region.utf8), using: SymmetricKey(data: kDate))
         let kService = HMAC<SHA256>.authenticationCode(for: [UInt8](name.utf8), using: SymmetricKey(data: kRegion))
@@ -286,30 +492,47 @@ public struct AWSSigner {
 
     /// chunked upload string to sign
     func chunkStringToSign(body: BodyData, previousSignature: String, datetime: String) -> String {
-        let date = String(datetime.prefix(8))
-        let stringToSign = "AWS4-HMAC-SHA256-PAYLOAD\n" +
-            "\(datetime)\n" +
-            "\(date)/\(region)/\(name)/aws4_request\n" +
-            "\(previousSignature)\n" +
-            "\(Self.hashedEmptyBody)\n" +
-            Self.hashedPayload(body)
-        return stringToSign
+        var buffer: [UInt8] = []
+        self.writeChunkStringToSign(body: body, previousSignature: previousSignature, datetime: datetime, into: &buffer)
+        return String(decoding: buffer, as: Unicode.UTF8.self)
+    }
+
+    /// Write chunked upload string to sign into byte buffer
+    func writeChunkStringToSign(body: BodyData, previousSignature: String, datetime: String, into buffer: inout [UInt8]) {
+        self.writeChunkStringToSignHeader(previousSignature: previousSignature, datetime: datetime, into: &buffer)
+        Self.writeHashedPayload(body, into: &buffer)
+    }
+
+    /// Write chunked upload string to sign, up to the chunk hash, into byte buffer
+    func writeChunkStringToSignHeader(previousSignature: String, datetime: String, into buffer: inout [UInt8]) {
+        buffer.append(contentsOf: "AWS4-HMAC-SHA256-PAYLOAD\n".utf8)
+        buffer.append(contentsOf: datetime.utf8)
+        buffer.append(UInt8(ascii: "\n"))
+        buffer.append(contentsOf: self.scope(date: String(datetime.prefix(8))).utf8)
+        buffer.append(UInt8(ascii: "\n"))
+        buffer.append(contentsOf: previousSignature.utf8)
+        buffer.append(UInt8(ascii: "\n"))
+        buffer.append(contentsOf: Self.hashedEmptyBody.utf8)
+        buffer.append(UInt8(ascii: "\n"))
+    }
+
+    /// Write SHA256 hash of the chunk body into byte buffer
+    static func writeHashedPayload(_ payload: BodyData, into buffer: inout [UInt8]) {
+        switch payload {
+        case .string, .data, .byteBuffer:
+            Self.sha256(payload)?.hexDigest(into: &buffer)
+        case .unsignedPayload, .s3chunked:
+            buffer.append(contentsOf: Self.hashedPayload(payload).utf8)
+        }
     }
 
     /// Create a SHA256 hash of the Requests body
-    static func hashedPayload(_ payload: BodyData?) -> String {
+    public static func hashedPayload(_ payload: BodyData?) -> String {
         guard let payload = payload else { return hashedEmptyBody }
         let hash: String?
         switch payload {
-        case .string(let string):
-            hash = SHA256.hash(data: [UInt8](string.utf8)).hexDigest()
-        case .data(let data):
-            hash = SHA256.hash(data: data).hexDigest()
-        case .byteBuffer(let byteBuffer):
-            let byteBufferView = byteBuffer.readableBytesView
-            hash = byteBufferView.withContiguousStorageIfAvailable { bytes in
-                return SHA256.hash(data: bytes).hexDigest()
-            }
+        case .string, .data, .byteBuffer:
+            hash = Self.sha256(payload)?.hexDigest()
         case .unsignedPayload:
             return "UNSIGNED-PAYLOAD"
         case .s3chunked:
@@ -322,18 +545,71 @@ public struct AWSSigner {
         }
     }
 
-    /// create timestamp dateformatter
-    private static func createTimeStampDateFormatter() -> DateFormatter {
-        let formatter = DateFormatter()
-        formatter.dateFormat = "yyyyMMdd'T'HHmmss'Z'"
-        formatter.timeZone = TimeZone(abbreviation: "UTC")
-        formatter.locale = Locale(identifier: "en_US_POSIX")
-        return formatter
+    /// SHA256 hash of a body held in memory. The bytes are passed to `hash(bufferPointer:)` in place, without copying them
+    /// into an intermediate array or iterating over them as a `DataProtocol`, so large payloads go straight to the platform's
+    /// block function
+    static func sha256(_ payload: BodyData) -> SHA256.Digest? {
+        switch payload {
+        case .string(let string):
+            var string = string
+            return string.withUTF8 { bytes in
+                SHA256.hash(bufferPointer: .init(bytes))
+            }
+        case .data(let data):
+            return data.withUnsafeBytes { bytes in
+                SHA256.hash(bufferPointer: bytes)
+            }
+        case .byteBuffer(let byteBuffer):
+            return byteBuffer.withUnsafeReadableBytes { bytes in
+                SHA256.hash(bufferPointer: bytes)
+            }
+        case .unsignedPayload, .s3chunked:
+            return nil
+        }
     }
 
-    /// return a timestamp formatted for signing requests
+    /// return a timestamp formatted for signing requests ie "yyyyMMdd'T'HHmmss'Z'". This is written directly, as it is
+    /// called for every request and a DateFormatter is slow and takes a lock
     static func timestamp(_ date: Date) -> String {
-        return timeStampDateFormatter.string(from: date)
+        var seconds = Int(date.timeIntervalSince1970.rounded(.down))
+        var days = seconds / 86400
+        seconds -= days * 86400
+        if seconds < 0 {
+            days -= 1
+            seconds += 86400
+        }
+        // convert days since 1970-01-01 to year, month, day. From http://howardhinnant.github.io/date_algorithms.html
+        days += 719_468
+        let era = (days >= 0 ? days : days - 146_096) / 146_097
+        let dayOfEra = days - era * 146_097
+        let yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146_096) / 365
+        let dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100)
+        let shiftedMonth = (5 * dayOfYear + 2) / 153
+        let day = dayOfYear - (153 * shiftedMonth + 2) / 5 + 1
+        let month = shiftedMonth < 10 ? shiftedMonth + 3 : shiftedMonth - 9
+        let year = yearOfEra + era * 400 + (month <= 2 ? 1 : 0)
+
+        var bytes: [UInt8] = []
+        bytes.reserveCapacity(16)
+        func write(_ value: Int, digits: Int) {
+            var divisor = 1
+            for _ in 1..<digits {
+                divisor *= 10
+            }
+            while divisor > 0 {
+                bytes.append(UInt8(ascii: "0") + UInt8((value / divisor) % 10))
+                divisor /= 10
+            }
+        }
+        write(year, digits: 4)
+        write(month, digits: 2)
+        write(day, digits: 2)
+        bytes.append(UInt8(ascii: "T"))
+        write(seconds / 3600, digits: 2)
+        write((seconds / 60) % 60, digits: 2)
+        write(seconds % 60, digits: 2)
+        bytes.append(UInt8(ascii: "Z"))
+        return String(decoding: bytes, as: UTF8.self)
     }
 
     /// returns port from URL. If port is set to 80 on an http url or 443 on an https url nil is returned
@@ -373,9 +649,10 @@ extension String {
 }
 
 public extension Sequence where Element == UInt8 {
-    /// return a hexEncoded string buffer from an array of bytes
+    /// return a hex encoded string from a sequence of bytes. The implementation lives in SotoCrypto, which isn't a product
+    /// itself, so this keeps it available to users of SotoSignerV4
     func hexDigest() -> String {
-        return self.map { String(format: "%02x", $0) }.joined(separator: "")
+        return SotoCrypto.hexDigest(self)
     }
 }
 
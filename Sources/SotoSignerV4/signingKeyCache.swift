@@ -0,0 +1,78 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the Soto for AWS open source project
+//
+// Copyright (c) 2017-2020 the Soto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.txt for the list of Soto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import NIOConcurrencyHelpers
+import SotoCrypto
+
+/// Thread safe cache of derived signing keys and credential scopes.
+///
+/// The signing key derived from a secret access key only changes once a day for each region and service, so there is
+/// no need to run the four HMAC computations it requires for every request. Share one cache between all the signers
+/// created for a client.
+public final class SigningKeyCache {
+    /// Signing key and credential scope for one date, region, service and credential
+    struct Entry {
+        let signingKey: SymmetricKey
+        /// "date/region/service/aws4_request"
+        let scope: String
+    }
+
+    struct Key: Hashable {
+        let date: String
+        let region: String
+        let service: String
+        let accessKeyId: String
+        let secretAccessKey: String
+    }
+
+    /// Maximum number of entries kept before the cache is flushed
+    public let maxCount: Int
+
+    private var entries: [Key: Entry] = [:]
+    private let lock = Lock()
+
+    /// Initialise a SigningKeyCache
+    /// - Parameter maxCount: Maximum number of entries to hold. When this is reached the cache is emptied
+    public init(maxCount: Int = 64) {
+        precondition(maxCount > 0, "SigningKeyCache must be able to hold at least one entry")
+        self.maxCount = maxCount
+    }
+
+    /// number of entries in cache
+    public var count: Int {
+        return self.lock.withLock { self.entries.count }
+    }
+
+    /// Remove all entries from cache
+    public func removeAll() {
+        self.lock.withLock { self.entries.removeAll() }
+    }
+
+    /// Return cached signing key and scope, or derive them using `create` and store the result
+    func entry(for key: Key, create: () -> Entry) -> Entry {
+        if let entry = self.lock.withLock({ self.entries[key] }) {
+            return entry
+        }
+        // derive outside of the lock. If two threads race here they both compute the same value
+        let entry = create()
+        self.lock.withLockVoid {
+            // entries for a previous day will never be used again. Rather than track age just flush the cache when full
+            if self.entries.count >= self.maxCount {
+                self.entries.removeAll(keepingCapacity: true)
+            }
+            self.entries[key] = entry
+        }
+        return entry
+    }
+}
@@ -44,34 +44,161 @@ class Expat {
         case suspended
     }
 
+    /// Where the Expat parser allocates its memory from
+    enum Memory {
+        /// system malloc and free
+        case system
+        /// arena that is released in one go when the parser is freed, see `expat_arena.h`. Parsers using an arena
+        /// cannot be reset
+        case arena
+    }
+
+    /// size of blocks allocated by the arena memory suite
+    static let arenaBlockSize = 16 * 1024
+
     var parser: XML_Parser
+    let encoding: String
+    /// salt for Expat's hash tables. Generated once so resetting the parser doesn't have to read entropy again
+    let hashSalt: UInt
+    /// arena parser allocates its memory from
+    private let arena: OpaquePointer?
 
-    init(encoding: String = "UTF-8") throws {
-        guard let parser = encoding.withCString({ cs in
-            Soto_XML_ParserCreate(cs)
-        }) else {
+    init(encoding: String = "UTF-8", memory: Memory = .system) throws {
+        var arena: OpaquePointer?
+        if case .arena = memory {
+            arena = Soto_XML_ArenaCreate(Expat.arenaBlockSize)
+            guard arena != nil else { throw XML_ERROR_NO_MEMORY }
+        }
+        guard let parser = Expat.createParser(encoding: encoding, arena: arena) else {
+            Soto_XML_ArenaFree(arena)
             throw XML_ERROR_NO_MEMORY
         }
         self.parser = parser
+        self.arena = arena
+        self.encoding = encoding
+        self.hashSalt = UInt.random(in: 1...UInt.max)
+
+        setup()
+    }
+
+    deinit {
+        withArena {
+            Soto_XML_ParserFree(parser)
+        }
+        Soto_XML_ArenaFree(arena)
+    }
+
+    /// Number of bytes the parser's arena has allocated from the system. Zero for a parser using the system memory
+    var arenaCapacity: Int {
+        return self.arena.map { Soto_XML_ArenaCapacity($0) } ?? 0
+    }
 
+    private static func createParser(encoding: String, arena: OpaquePointer?) -> XML_Parser? {
+        return encoding.withCString { cs in
+            if let arena = arena {
+                return Soto_XML_ParserCreateInArena(cs, arena)
+            } else {
+                return Soto_XML_ParserCreate(cs)
+            }
+        }
+    }
+
+    /// Run closure with parser's arena as the current arena for this thread. Any Expat call that might allocate or
+    /// free memory has to be made inside this.
+    @inline(__always)
+    private func withArena<Value>(_ body: () throws -> Value) rethrows -> Value {
+        guard let arena = self.arena else { return try body() }
+        let previous = Soto_XML_ArenaSetCurrent(arena)
+        defer { Soto_XML_ArenaSetCurrent(previous) }
+        return try body()
+    }
+
+    /// set user data, hash salt and callbacks on Expat parser
+    private func setup() {
         // TBD: what is the better way to do this?
         let ud = unsafeBitCast(self, to: UnsafeMutableRawPointer.self)
         Soto_XML_SetUserData(parser, ud)
+        Soto_XML_SetHashSalt(parser, hashSalt)
 
         registerCallbacks()
     }
 
-    deinit {
-        Soto_XML_ParserFree(parser)
+    /// Reset parser so it can parse a new document. Callbacks are removed. The table of element names is kept.
+    ///
+    /// The parser is reset with `XML_ParserReset`, which keeps the buffers and hash tables Expat has already
+    /// allocated. Those are allocated from the arena for a parser using one, so the arena cannot be released
+    /// without freeing the parser as well. Parsers using an arena are not reset, they should be freed instead.
+    /// - Returns: Whether parser was reset
+    func reset() -> Bool {
+        guard self.arena == nil else { return false }
+        let reset = encoding.withCString { cs in
+            Soto_XML_ParserReset(parser, cs)
+        }
+        guard reset != 0 else { return false }
+        self.cbStartElement = nil
+        self.cbEndElement = nil
+        self.cbCharacterData = nil
+        self.cbComment = nil
+        self.cbError = nil
+        setup()
+        return true
     }
 
-    /// feed the parser
+    /// feed the parser a NUL terminated C string
     func feedRaw(_ cs: UnsafePointer<CChar>, final: Bool = false) throws -> Result {
         let cslen = strlen(cs) // cs? checks for a NULL C string
+        return try self.feed(UnsafeRawBufferPointer(start: cs, count: cslen), final: final)
+    }
+
+    /// feed the parser a block of data of explicit length. The data can include NUL characters
+    func feed(_ bytes: UnsafeRawBufferPointer, final: Bool = false) throws -> Result {
         let isFinal: Int32 = final ? 1 : 0
+        guard bytes.count <= Int32.max else { throw XML_ERROR_NO_MEMORY }
+        let cs = bytes.baseAddress?.assumingMemoryBound(to: CChar.self)
 
-        let status: XML_Status = Soto_XML_Parse(parser, cs, Int32(cslen), isFinal)
+        let status: XML_Status = withArena {
+            Soto_XML_Parse(parser, cs, Int32(bytes.count), isFinal)
+        }
+        return try self.result(from: status)
+    }
+
+    /// feed the parser by writing data directly into the parser's own buffer. This avoids the copy `feed` has to make
+    /// when the data can be generated in place
+    /// - Parameters:
+    ///   - capacity: Maximum number of bytes to write
+    ///   - final: Is this the last block of data
+    ///   - fill: Closure that writes data into the buffer provided and returns the number of bytes written
+    func feed(capacity: Int, final: Bool = false, fill: (UnsafeMutableRawBufferPointer) throws -> Int) throws -> Result {
+        let isFinal: Int32 = final ? 1 : 0
+        guard capacity <= Int32.max else { throw XML_ERROR_NO_MEMORY }
+        let buffer = withArena {
+            Soto_XML_GetBuffer(parser, Int32(capacity))
+        }
+        guard let bufferPointer = buffer else {
+            throw Soto_XML_GetErrorCode(parser)
+        }
+        let length = try fill(UnsafeMutableRawBufferPointer(start: bufferPointer, count: capacity))
+        precondition(length <= capacity, "Wrote more data than the buffer can hold")
+
+        let status: XML_Status = withArena {
+            Soto_XML_ParseBuffer(parser, Int32(length), isFinal)
+        }
+        return try self.result(from: status)
+    }
+
+    func feed(_ s: String, final: Bool = false) throws -> Result {
+        var s = s
+        return try s.withUTF8 { bytes -> Result in
+            return try self.feed(UnsafeRawBufferPointer(bytes), final: final)
+        }
+    }
+
+    func close() throws -> Result {
+        return try self.feed(UnsafeRawBufferPointer(start: nil, count: 0), final: true)
+    }
 
+    /// convert parser status to result, throwing the parser error if parsing failed
+    private func result(from status: XML_Status) throws -> Result {
         switch status { // the Expat enum's don't work?
         case XML_STATUS_OK: return .ok
         case XML_STATUS_SUSPENDED: return .suspended
@@ -84,32 +211,18 @@ class Expat {
         }
     }
 
-    func feed(_ s: String, final: Bool = false) throws -> Result {
-        return try s.withCString { cs -> Result in
-            return try self.feedRaw(cs, final: final)
-        }
-    }
-
-    func close() throws -> Result {
-        return try self.feed("", final: true)
-    }
-
     func registerCallbacks() {
         Soto_XML_SetStartElementHandler(self.parser) { ud, name, attrs in
             let me = unsafeBitCast(ud, to: Expat.self)
             guard let callback = me.cbStartElement else { return }
-            let sName = name != nil ? String(cString: name!) : ""
-
-            // FIXME: we should not copy stuff, but have a wrapper which works on the
-            //        attrs structure 'on demand'
-            let sAttrs = Expat.makeAttributesDictionary(attrs)
-            callback(sName, sAttrs)
+            let sName = name != nil ? me.elementNames.name(for: name!) : ""
+            callback(sName, Attributes(attrs))
         }
 
         Soto_XML_SetEndElementHandler(self.parser) { ud, name in
             let me = unsafeBitCast(ud, to: Expat.self)
             guard let callback = me.cbEndElement else { return }
-            let sName = String(cString: name!) // force unwrap, must be set
+            let sName = me.elementNames.name(for: name!) // force unwrap, must be set
             callback(sName)
         }
 
@@ -121,10 +234,7 @@ class Expat {
             let me = unsafeBitCast(ud, to: Expat.self)
             guard let callback = me.cbCharacterData else { return }
 
-            let cs2 = UnsafeRawPointer(cs!).assumingMemoryBound(to: UInt8.self)
-            let bp = UnsafeBufferPointer(start: cs2, count: Int(cslen))
-            let s = String(decoding: bp, as: UTF8.self)
-            callback(s)
+            callback(UnsafeRawBufferPointer(start: cs, count: Int(cslen)))
         }
 
         Soto_XML_SetCommentHandler(self.parser) { ud, comment in
@@ -137,10 +247,10 @@ class Expat {
 
     /* callbacks */
 
-    typealias AttributeDictionary = [String: String]
-    typealias StartElementHandler = (String, AttributeDictionary) -> Void
+    typealias StartElementHandler = (String, Attributes) -> Void
     typealias EndElementHandler = (String) -> Void
-    typealias CDataHandler = (String) -> Void
+    /// Character data is passed as the UTF8 bytes Expat supplies, which are only valid for the duration of the callback
+    typealias CDataHandler = (UnsafeRawBufferPointer) -> Void
     typealias CommentHandler = (String) -> Void
     typealias ErrorHandler = (XML_Error) -> Void
 
@@ -150,6 +260,9 @@ class Expat {
     var cbComment: CommentHandler?
     var cbError: ErrorHandler?
 
+    /// table of element names already seen by this parser
+    var elementNames = NameTable()
+
     func onStartElement(_ callback: @escaping StartElementHandler) -> Self {
         self.cbStartElement = callback
         return self
@@ -175,22 +288,155 @@ class Expat {
         return self
     }
 
-    /// Make a dictionary from the attribute list returned by Expat
+    /// View of the attribute list returned by Expat. Attribute names and values are only converted to Strings when they
+    /// are accessed, so elements without attributes cost nothing. The view is only valid for the duration of the start
+    /// element callback.
+    ///
     /// List is array of char pointers arranaged as follows: name, value, name, value...
-    /// - Parameter attrs: array of string pointers
-    /// - Returns: attributes in dictionary form
-    static func makeAttributesDictionary(_ attrs: UnsafeMutablePointer<UnsafePointer<XML_Char>?>?) -> [String: String] {
-        var sAttrs = [String: String]()
-        guard let attrs = attrs else { return sAttrs }
-        var i = 0
-        while attrs[i] != nil {
-            let name = String(cString: attrs[i]!)
-            let value = attrs[i + 1] != nil ? String(cString: attrs[i + 1]!) : ""
-            sAttrs[name] = value
-            i += 2
-        }
-        return sAttrs
+    struct Attributes: Sequence {
+        typealias Element = (name: String, value: String)
+
+        let attrs: UnsafeMutablePointer<UnsafePointer<XML_Char>?>?
+
+        init(_ attrs: UnsafeMutablePointer<UnsafePointer<XML_Char>?>?) {
+            self.attrs = attrs
+        }
+
+        /// Are there no attributes
+        var isEmpty: Bool {
+            return self.attrs?[0] == nil
+        }
+
+        /// Return value of attribute with name
+        subscript(name: String) -> String? {
+            guard let attrs = attrs else { return nil }
+            var i = 0
+            while let attrName = attrs[i] {
+                if name.withCString({ strcmp($0, attrName) == 0 }) {
+                    return attrs[i + 1].map { String(cString: $0) } ?? ""
+                }
+                i += 2
+            }
+            return nil
+        }
+
+        func makeIterator() -> Iterator {
+            return Iterator(attrs: self.attrs)
+        }
+
+        struct Iterator: IteratorProtocol {
+            let attrs: UnsafeMutablePointer<UnsafePointer<XML_Char>?>?
+            var index: Int = 0
+
+            mutating func next() -> (name: String, value: String)? {
+                guard let attrs = attrs, let name = attrs[index] else { return nil }
+                let value = attrs[self.index + 1].map { String(cString: $0) } ?? ""
+                self.index += 2
+                return (name: String(cString: name), value: value)
+            }
+        }
+    }
+
+    /// Intern table for element names. AWS responses repeat the same few element names (`member`, `Key`, `ETag` etc)
+    /// many times, so the String for each name is created once per parser and returned for every subsequent occurrence.
+    struct NameTable {
+        /// maximum number of names held, so a document with many unique names cannot grow the table indefinitely
+        static let maxCount = 1024
+
+        private var names: [Int: String] = [:]
+
+        /// Return String for NUL terminated name
+        mutating func name(for cs: UnsafePointer<XML_Char>) -> String {
+            let bytes = UnsafeRawPointer(cs).assumingMemoryBound(to: UInt8.self)
+            // calculate FNV-1a hash and length in one pass
+            var hash: UInt64 = 0xCBF2_9CE4_8422_2325
+            var length = 0
+            while bytes[length] != 0 {
+                hash = (hash ^ UInt64(bytes[length])) &* 0x100_0000_01B3
+                length += 1
+            }
+            let nameBytes = UnsafeBufferPointer(start: bytes, count: length)
+            let key = Int(truncatingIfNeeded: hash)
+            if let name = self.names[key] {
+                if name.utf8.elementsEqual(nameBytes) {
+                    return name
+                }
+                // hash collision, don't replace existing entry
+                return String(decoding: nameBytes, as: UTF8.self)
+            }
+            let name = String(decoding: nameBytes, as: UTF8.self)
+            if self.names.count < Self.maxCount {
+                self.names[key] = name
+            }
+            return name
+        }
     }
 }
 
 extension XML_Error: Error {}
+
+// MARK: Parser pool
+
+extension Expat {
+    /// Return a UTF-8 parser. The parser is taken from the pool of the current thread if one is available. As each
+    /// NIO EventLoop runs on its own thread this gives every EventLoop its own pool without any locking. Pooled
+    /// parsers use the system memory, so resetting one keeps the buffers allocated by its last parse.
+    static func make() throws -> Expat {
+        if let expat = ExpatPool.current.pop() {
+            return expat
+        }
+        return try Expat()
+    }
+
+    /// Reset parser and return it to the pool of the current thread. Parsers that cannot be reset are dropped. The
+    /// parser should not be used after this.
+    func recycle() {
+        guard self.encoding == "UTF-8", self.reset() else { return }
+        ExpatPool.current.push(self)
+    }
+}
+
+/// Thread local pool of parsers
+private final class ExpatPool {
+    /// maximum number of parsers held by each thread
+    static let maxCount = 4
+
+    private var parsers: [Expat] = []
+
+    func pop() -> Expat? {
+        return self.parsers.popLast()
+    }
+
+    func push(_ expat: Expat) {
+        guard self.parsers.count < Self.maxCount else { return }
+        self.parsers.append(expat)
+    }
+
+    /// pool for current thread
+    static var current: ExpatPool {
+        if let pointer = pthread_getspecific(key) {
+            return Unmanaged<ExpatPool>.fromOpaque(pointer).takeUnretainedValue()
+        }
+        let pool = ExpatPool()
+        pthread_setspecific(key, Unmanaged.passRetained(pool).toOpaque())
+        return pool
+    }
+
+    /// thread specific key, releasing the pool when the thread exits
+    private static let key: pthread_key_t = {
+        var key = pthread_key_t()
+        #if os(Linux)
+        let destructor: @convention(c) (UnsafeMutableRawPointer?) -> Void = { pointer in
+            guard let pointer = pointer else { return }
+            Unmanaged<ExpatPool>.fromOpaque(pointer).release()
+        }
+        #else
+        let destructor: @convention(c) (UnsafeMutableRawPointer) -> Void = { pointer in
+            Unmanaged<ExpatPool>.fromOpaque(pointer).release()
+        }
+        #endif
+        let result = pthread_key_create(&key, destructor)
+        precondition(result == 0, "Failed to create thread specific key for Expat parser pool")
+        return key
+    }()
+}
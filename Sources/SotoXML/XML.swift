@@ -32,9 +32,15 @@ public enum XML {
 
         /// defines the type of xml node
         public let kind: Kind
-        public var name: String?
+        public var name: String? {
+            didSet { parent?.childrenDidChange() }
+        }
+
         public var stringValue: String?
-        public fileprivate(set) var children: [XML.Node]?
+        public fileprivate(set) var children: [XML.Node]? {
+            didSet { childrenDidChange() }
+        }
+
         public weak var parent: XML.Node?
 
         fileprivate init(_ kind: Kind, name: String? = nil, stringValue: String? = nil) {
@@ -94,6 +100,9 @@ public enum XML {
             children?.removeAll(where: { $0 === child })
         }
 
+        /// called when the list of children or the name of a child has changed
+        fileprivate func childrenDidChange() {}
+
         /// return children of a specific kind
         public func children(of kind: Kind) -> [XML.Node]? {
             return children?.compactMap { $0.kind == kind ? $0 : nil }
@@ -103,9 +112,17 @@ public enum XML {
             "&": "&amp;",
             "<": "&lt;",
             ">": "&gt;",
+            "\"": "&quot;",
+            "'": "&apos;",
         ]
-        /// encode text with XML markup
+        /// encode text or attribute value with XML markup
         private static func xmlEncode(string: String) -> String {
+            // most strings contain no markup, check the UTF8 bytes before building a new string
+            guard string.utf8.contains(where: {
+                $0 == UInt8(ascii: "&") || $0 == UInt8(ascii: "<") || $0 == UInt8(ascii: ">") || $0 == UInt8(ascii: "\"") || $0 == UInt8(ascii: "'")
+            }) else {
+                return string
+            }
             var newString = ""
             for c in string {
                 if let replacement = XML.Node.xmlEncodedCharacters[c] {
@@ -127,7 +144,7 @@ public enum XML {
                 return ""
             case .attribute:
                 if let name = name {
-                    return "\(name)=\"\(stringValue ?? "")\""
+                    return "\(name)=\"\(XML.Node.xmlEncode(string: stringValue ?? ""))\""
                 } else {
                     return ""
                 }
@@ -142,7 +159,7 @@ public enum XML {
                 if let name = name, name != "" {
                     string += ":\(name)"
                 }
-                string += "=\"\(stringValue ?? "")\""
+                string += "=\"\(XML.Node.xmlEncode(string: stringValue ?? ""))\""
                 return string
             default:
                 return ""
@@ -214,6 +231,12 @@ public enum XML {
         public fileprivate(set) var attributes: [XML.Node]?
         /// array of namespaces attached to XML ELement
         public fileprivate(set) var namespaces: [XML.Node]?
+        /// positions of child elements in `children` indexed by name. Built on first lookup by name and discarded
+        /// whenever the children change
+        private var childElementIndex: [String: [Int]]?
+
+        /// Elements with fewer children than this are searched linearly instead of building an index
+        static let childElementIndexThreshold = 8
 
         public init(name: String, stringValue: String? = nil) {
             super.init(.element, name: name)
@@ -225,72 +248,87 @@ public enum XML {
             super.init(.element)
 
             if let rootElement = try Self.parse(xml: xmlString) {
-                // copy contents of rootElement
-                self.setChildren(rootElement.children)
-                self.setAttributes(rootElement.attributes)
-                self.setNamespaces(rootElement.namespaces)
-                self.name = rootElement.name
+                self.copyContents(of: rootElement)
             } else {
                 throw ParsingError.emptyFile
             }
         }
 
         /// initialise XML.Element from xml data
-        public convenience init(xmlData: Data) throws {
-            let xml = String(decoding: xmlData, as: Unicode.UTF8.self)
-            try self.init(xmlString: xml)
+        public init(xmlData: Data) throws {
+            super.init(.element)
+
+            let parser = try IncrementalParser()
+            try xmlData.withUnsafeBytes { (bytes: UnsafeRawBufferPointer) in
+                try parser.feed(bytes)
+            }
+            if let rootElement = try parser.finish() {
+                self.copyContents(of: rootElement)
+            } else {
+                throw ParsingError.emptyFile
+            }
         }
 
         /// Parse XML string and return an XML root element
         static func parse(xml: String) throws -> Element? {
-            var rootElement: XML.Element?
-            var currentElement: XML.Element?
-            var currentNamespace: XML.Node?
-
-            let parser = try Expat()
-                .onStartElement { name, attrs in
-                    let element = XML.Element(name: name)
-                    for attribute in attrs {
-                        element.addAttribute(XML.Node(.attribute, name: attribute.key, stringValue: attribute.value))
-                    }
-                    if rootElement == nil {
-                        rootElement = element
-                    }
-                    currentElement?.addChild(element)
-                    currentElement = element
-                    if let namespace = currentNamespace {
-                        currentElement?.addNamespace(namespace)
-                        currentNamespace = nil
-                    }
-                }
-                .onEndElement { name in
-                    assert(currentElement?.name == name)
-                    currentElement = currentElement?.parent as? XML.Element
-                }
-                .onCharacterData { characters in
-                    // if string with white space removed still has characters, add text node
-                    if characters.split(omittingEmptySubsequences: true, whereSeparator: { $0.isWhitespace && !$0.isNewline }).joined().count > 0 {
-                        currentElement?.addChild(XML.Node.text(stringValue: characters))
-                    }
-                }
-                .onComment { comment in
-                    currentElement?.addChild(.comment(stringValue: comment))
-                }
-
-            _ = try parser.feed(xml)
-            _ = try parser.close()
+            var xml = xml
+            let parser = try IncrementalParser()
+            try xml.withUTF8 { bytes in
+                try parser.feed(UnsafeRawBufferPointer(bytes))
+            }
+            return try parser.finish()
+        }
 
-            return rootElement
+        /// copy contents of another element into this one
+        private func copyContents(of element: XML.Element) {
+            self.setChildren(element.children)
+            self.setAttributes(element.attributes)
+            self.setNamespaces(element.namespaces)
+            self.name = element.name
         }
 
         /// return children XML elements
         public func elements(forName: String) -> [XML.Element] {
-            return children?.compactMap {
+            guard let children = self.children else { return [] }
+            if let index = self.indexedChildElements() {
+                return index[forName]?.map { children[$0] as! XML.Element } ?? []
+            }
+            return children.compactMap {
                 if let element = $0 as? XML.Element, element.name == forName {
                     return element
                 }
                 return nil
-            } ?? []
+            }
+        }
+
+        /// return first child XML element with name
+        public func firstElement(forName: String) -> XML.Element? {
+            guard let children = self.children else { return nil }
+            if let index = self.indexedChildElements() {
+                return index[forName].map { children[$0[0]] as! XML.Element }
+            }
+            return children.first { $0.kind == .element && $0.name == forName } as? XML.Element
+        }
+
+        /// return index of child elements, building it if required. Returns nil if element has too few children to
+        /// make an index worthwhile
+        private func indexedChildElements() -> [String: [Int]]? {
+            if let index = self.childElementIndex {
+                return index
+            }
+            guard let children = self.children, children.count >= Self.childElementIndexThreshold else { return nil }
+            var index: [String: [Int]] = [:]
+            for (position, child) in children.enumerated() {
+                if child.kind == .element, let name = child.name {
+                    index[name, default: []].append(position)
+                }
+            }
+            self.childElementIndex = index
+            return index
+        }
+
+        override fileprivate func childrenDidChange() {
+            self.childElementIndex = nil
         }
 
         /// return child text nodes all concatenated together
@@ -438,6 +476,117 @@ public enum XML {
         }
     }
 
+    /// XML parser that builds an XML.Element tree from blocks of UTF8 data as they are supplied. This means a tree
+    /// can be constructed while the rest of a document is still being received and the document never has to be held
+    /// in memory as a whole.
+    public final class IncrementalParser {
+        private let expat: Expat
+        private let builder: TreeBuilder
+        private var receivedData: Bool
+        private var finished: Bool
+
+        /// Initialize IncrementalParser
+        public init() throws {
+            let builder = TreeBuilder()
+            self.expat = try Expat.make()
+                .onStartElement { name, attrs in
+                    builder.startElement(name: name, attributes: attrs)
+                }
+                .onEndElement { name in
+                    builder.endElement(name: name)
+                }
+                .onCharacterData { characters in
+                    builder.characterData(String(decoding: characters, as: UTF8.self))
+                }
+                .onComment { comment in
+                    builder.comment(comment)
+                }
+            self.builder = builder
+            self.receivedData = false
+            self.finished = false
+        }
+
+        /// Feed parser the next block of UTF8 data
+        /// - Parameter bytes: UTF8 data
+        public func feed(_ bytes: UnsafeRawBufferPointer) throws {
+            precondition(!self.finished, "Cannot feed parser after it has finished")
+            guard bytes.count > 0 else { return }
+            self.receivedData = true
+            _ = try self.expat.feed(bytes)
+        }
+
+        /// Feed parser the next block of UTF8 data by writing it directly into the parser's buffer
+        /// - Parameters:
+        ///   - capacity: Maximum number of bytes that will be written
+        ///   - fill: Closure writing data into the buffer supplied and returning how many bytes were written
+        public func feed(capacity: Int, fill: (UnsafeMutableRawBufferPointer) throws -> Int) throws {
+            precondition(!self.finished, "Cannot feed parser after it has finished")
+            guard capacity > 0 else { return }
+            self.receivedData = true
+            _ = try self.expat.feed(capacity: capacity, fill: fill)
+        }
+
+        /// Finish parsing and return the root element of the document. Returns nil if no data was supplied
+        public func finish() throws -> XML.Element? {
+            precondition(!self.finished, "Parser has already finished")
+            self.finished = true
+            // the Expat parser can be reused once this document is complete
+            defer { self.expat.recycle() }
+            guard self.receivedData else { return nil }
+            _ = try self.expat.close()
+            return self.builder.rootElement
+        }
+
+        /// Builds XML.Element tree from Expat callbacks. Held separately from the parser to avoid a reference cycle
+        /// between Expat and its callbacks
+        private final class TreeBuilder {
+            var rootElement: XML.Element?
+            var currentElement: XML.Element?
+            var characters: String = ""
+
+            func startElement(name: String, attributes: Expat.Attributes) {
+                self.flushCharacters()
+                let element = XML.Element(name: name)
+                if !attributes.isEmpty {
+                    for attribute in attributes {
+                        element.addAttribute(XML.Node(.attribute, name: attribute.name, stringValue: attribute.value))
+                    }
+                }
+                if self.rootElement == nil {
+                    self.rootElement = element
+                }
+                self.currentElement?.addChild(element)
+                self.currentElement = element
+            }
+
+            func endElement(name: String) {
+                self.flushCharacters()
+                assert(self.currentElement?.name == name)
+                self.currentElement = self.currentElement?.parent as? XML.Element
+            }
+
+            func characterData(_ characters: String) {
+                // Expat can split character data over multiple callbacks (at newlines, entities or the end of a block of
+                // data) so accumulate it until the next element or comment
+                self.characters += characters
+            }
+
+            func comment(_ comment: String) {
+                self.flushCharacters()
+                self.currentElement?.addChild(.comment(stringValue: comment))
+            }
+
+            func flushCharacters() {
+                guard !self.characters.isEmpty else { return }
+                // if string with white space removed still has characters, add text node
+                if self.characters.contains(where: { !$0.isWhitespace || $0.isNewline }) {
+                    self.currentElement?.addChild(XML.Node.text(stringValue: self.characters))
+                }
+                self.characters = ""
+            }
+        }
+    }
+
     /// XML parsing errors
     enum ParsingError: Error {
         case emptyFile
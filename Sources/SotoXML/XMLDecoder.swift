@@ -76,8 +76,41 @@ public struct XMLDecoder {
     }
 }
 
+extension XMLDecoder.NonConformingFloatDecodingStrategy {
+    /// Return floating point value of string. With `.convertFromString` the strings given decode as infinity and NaN.
+    /// The spellings `LosslessStringConvertible` accepts, eg "inf" and "nan", are decoded with either strategy, as
+    /// they always have been
+    func value<T: BinaryFloatingPoint & LosslessStringConvertible>(_ string: String, as type: T.Type) -> T? {
+        if case .convertFromString(let positiveInfinity, let negativeInfinity, let nan) = self {
+            if string == positiveInfinity { return .infinity }
+            if string == negativeInfinity { return -.infinity }
+            if string == nan { return .nan }
+        }
+        return T(string)
+    }
+}
+
+extension XMLDecoder {
+    /// Date formatters used to decode dates
+    static let dateFormatters: [DateFormatter] = {
+        var dateFormatters: [DateFormatter] = []
+        let formats = ["yyyy-MM-dd'T'HH:mm:ss.SSS'Z'", "yyyy-MM-dd'T'HH:mm:ss'Z'"]
+        for format in formats {
+            let dateFormatter = DateFormatter()
+            dateFormatter.locale = Locale(identifier: "en_US_POSIX")
+            dateFormatter.dateFormat = format
+            dateFormatter.timeZone = TimeZone(secondsFromGMT: 0)
+            dateFormatters.append(dateFormatter)
+        }
+        return dateFormatters
+    }()
+}
+
 extension XML.Node {
     func child(for string: String) -> XML.Node? {
+        if let element = self as? XML.Element {
+            return element.firstElement(forName: string)
+        }
         return (children ?? []).first(where: { $0.name == string })
     }
 
@@ -140,16 +173,18 @@ private class _XMLDecoder: Decoder {
 
     struct KDC<Key: CodingKey>: KeyedDecodingContainerProtocol {
         var codingPath: [CodingKey] { return decoder.codingPath }
-        var allKeys: [Key] = []
         let element: XML.Node
         let decoder: _XMLDecoder
 
         public init(_ element: XML.Node, decoder: _XMLDecoder) {
             self.element = element
             self.decoder = decoder
+        }
 
-            // all elements directly under the container xml element are considered. THe key is the name of the element and the value is the text attached to the element
-            allKeys = element.children?.compactMap { (element: XML.Node) -> Key? in
+        /// all elements directly under the container xml element are considered. THe key is the name of the element and the value is the text attached to the element.
+        /// This is only needed when decoding dictionaries so is calculated on demand
+        var allKeys: [Key] {
+            return element.children?.compactMap { (element: XML.Node) -> Key? in
                 if let name = element.name {
                     return Key(stringValue: name)
                 }
@@ -597,12 +632,12 @@ private class _XMLDecoder: Decoder {
     }
 
     func unbox(_ element: XML.Node, as type: Double.Type) throws -> Double {
-        guard let value = element.stringValue, let unboxValue = Double(value) else { throw DecodingError._typeMismatch(at: codingPath, expectation: Double.self, reality: element.stringValue ?? "nil") }
+        guard let value = element.stringValue, let unboxValue = self.options.nonConformingFloatDecodingStrategy.value(value, as: Double.self) else { throw DecodingError._typeMismatch(at: codingPath, expectation: Double.self, reality: element.stringValue ?? "nil") }
         return unboxValue
     }
 
     func unbox(_ element: XML.Node, as type: Float.Type) throws -> Float {
-        guard let value = element.stringValue, let unboxValue = Float(value) else { throw DecodingError._typeMismatch(at: codingPath, expectation: Float.self, reality: element.stringValue ?? "nil") }
+        guard let value = element.stringValue, let unboxValue = self.options.nonConformingFloatDecodingStrategy.value(value, as: Float.self) else { throw DecodingError._typeMismatch(at: codingPath, expectation: Float.self, reality: element.stringValue ?? "nil") }
         return unboxValue
     }
 
@@ -612,7 +647,7 @@ private class _XMLDecoder: Decoder {
         }
 
         let string = try self.unbox(element, as: String.self)
-        for formatter in Self.dateFormatters {
+        for formatter in XMLDecoder.dateFormatters {
             if let date = formatter.date(from: string) {
                 return date
             }
@@ -659,19 +694,6 @@ private class _XMLDecoder: Decoder {
             return try type.init(from: self)
         }
     }
-
-    static let dateFormatters: [DateFormatter] = {
-        var dateFormatters: [DateFormatter] = []
-        let formats = ["yyyy-MM-dd'T'HH:mm:ss.SSS'Z'", "yyyy-MM-dd'T'HH:mm:ss'Z'"]
-        for format in formats {
-            let dateFormatter = DateFormatter()
-            dateFormatter.locale = Locale(identifier: "en_US_POSIX")
-            dateFormatter.dateFormat = format
-            dateFormatter.timeZone = TimeZone(secondsFromGMT: 0)
-            dateFormatters.append(dateFormatter)
-        }
-        return dateFormatters
-    }()
 }
 
 //===----------------------------------------------------------------------===//
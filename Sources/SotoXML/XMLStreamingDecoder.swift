@@ -0,0 +1,851 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the Soto for AWS open source project
+//
+// Copyright (c) 2017-2020 the Soto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.txt for the list of Soto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import struct Foundation.Data
+import struct Foundation.Date
+
+/// Decoder for Codable types that works directly from the events of the XML parser without building an `XML.Element`
+/// tree. While parsing, the name, text and attributes of each element are recorded in one flat array of value types
+/// with each element linking to its first child and next sibling. This avoids allocating a class instance, weak parent
+/// reference and children array per element. The text of every element is copied once, into one byte array for the
+/// whole document, and each element references its slice of it. Strings are only created for the text of values decoded
+/// as strings or numbers, and base64 data is decoded straight from the bytes.
+///
+/// The decoding rules are the same as `XMLDecoder`.
+///
+/// Sample:
+///  let parser = try XMLStreamingDecoder.Parser()
+///  try parser.feed(bytes)
+///  if let document = try parser.finish() {
+///      let value = try XMLStreamingDecoder().decode(Value.self, from: document.rootElement)
+///  }
+public struct XMLStreamingDecoder {
+    /// The strategy to use in decoding binary data. Defaults to `.base64`.
+    public var dataDecodingStrategy: XMLDecoder.DataDecodingStrategy = .base64
+
+    /// The strategy to use in decoding non-conforming numbers. Defaults to `.throw`.
+    public var nonConformingFloatDecodingStrategy: XMLDecoder.NonConformingFloatDecodingStrategy = .throw
+
+    /// Contextual user-provided information for use during decoding.
+    public var userInfo: [CodingUserInfoKey: Any] = [:]
+
+    public init() {}
+
+    /// decode a Codable class from an element of a parsed XML document
+    public func decode<T: Decodable>(_ type: T.Type, from element: Element) throws -> T {
+        let decoder = _XMLStreamingDecoder(
+            .element(element.index),
+            nodes: element.document.nodes,
+            text: element.document.text,
+            dataDecodingStrategy: self.dataDecodingStrategy,
+            nonConformingFloatDecodingStrategy: self.nonConformingFloatDecodingStrategy,
+            userInfo: self.userInfo
+        )
+        return try T(from: decoder)
+    }
+
+    /// decode a Codable class from a block of UTF8 XML
+    public func decode<T: Decodable>(_ type: T.Type, from bytes: UnsafeRawBufferPointer) throws -> T {
+        let parser = try Parser()
+        try parser.feed(bytes)
+        guard let document = try parser.finish() else { throw XML.ParsingError.emptyFile }
+        return try self.decode(type, from: document.rootElement)
+    }
+}
+
+extension XMLStreamingDecoder {
+    /// Parser that records the XML events required for decoding from blocks of UTF8 data as they are supplied.
+    public final class Parser {
+        private let expat: Expat
+        private let builder: DocumentBuilder
+        private var receivedData: Bool
+        private var finished: Bool
+
+        /// Initialize Parser
+        public init() throws {
+            let builder = DocumentBuilder()
+            self.expat = try Expat.make()
+                .onStartElement { name, attrs in
+                    builder.startElement(name: name, attributes: attrs)
+                }
+                .onEndElement { _ in
+                    builder.endElement()
+                }
+                .onCharacterData { characters in
+                    builder.characterData(characters)
+                }
+                .onComment { _ in
+                    builder.flushCharacters()
+                }
+            self.builder = builder
+            self.receivedData = false
+            self.finished = false
+        }
+
+        /// Feed parser the next block of UTF8 data
+        /// - Parameter bytes: UTF8 data
+        public func feed(_ bytes: UnsafeRawBufferPointer) throws {
+            precondition(!self.finished, "Cannot feed parser after it has finished")
+            guard bytes.count > 0 else { return }
+            self.receivedData = true
+            _ = try self.expat.feed(bytes)
+        }
+
+        /// Finish parsing and return the document. Returns nil if no data was supplied
+        public func finish() throws -> Document? {
+            precondition(!self.finished, "Parser has already finished")
+            self.finished = true
+            // the Expat parser can be reused once this document is complete
+            defer { self.expat.recycle() }
+            guard self.receivedData else { return nil }
+            _ = try self.expat.close()
+            return Document(nodes: self.builder.nodes, text: self.builder.text)
+        }
+    }
+
+    /// Elements of a parsed XML document
+    public struct Document {
+        let nodes: [Node]
+        /// text of all the elements, each element references its slice
+        let text: [UInt8]
+
+        /// return the root element. A document is only created from a successful parse so always has one
+        public var rootElement: Element {
+            return Element(document: self, index: 0)
+        }
+    }
+
+    /// Element of a parsed XML document
+    public struct Element {
+        let document: Document
+        let index: Int
+
+        /// name of element
+        public var name: String { return self.document.nodes[self.index].name }
+
+        /// return first child element
+        public var firstChild: Element? {
+            let child = self.document.nodes[self.index].firstChild
+            return child != Node.none ? Element(document: self.document, index: child) : nil
+        }
+    }
+
+    /// Record of an element kept by the parser
+    struct Node {
+        static let none = -1
+
+        let name: String
+        /// range of the document text attached to element, only including text that isn't whitespace.
+        var text: Range<Int> = 0..<0
+        var attributes: [(name: String, value: String)]?
+        var firstChild: Int = Node.none
+        var lastChild: Int = Node.none
+        var nextSibling: Int = Node.none
+
+        init(name: String) {
+            self.name = name
+        }
+    }
+
+    /// Builds array of nodes from Expat callbacks
+    final class DocumentBuilder {
+        var nodes: [Node] = []
+        /// stack of indices of open elements
+        var openElements: [Int] = []
+        /// text of document. Character data is appended as it is received, and removed again if it is only whitespace
+        var text: [UInt8] = []
+        /// start of character data not yet attached to an element
+        var charactersStart: Int = 0
+
+        func startElement(name: String, attributes: Expat.Attributes) {
+            self.flushCharacters()
+            let index = self.nodes.count
+            var node = Node(name: name)
+            if !attributes.isEmpty {
+                node.attributes = attributes.map { $0 }
+            }
+            self.nodes.append(node)
+            if let parent = self.openElements.last {
+                let lastChild = self.nodes[parent].lastChild
+                if lastChild != Node.none {
+                    self.nodes[lastChild].nextSibling = index
+                } else {
+                    self.nodes[parent].firstChild = index
+                }
+                self.nodes[parent].lastChild = index
+            }
+            self.openElements.append(index)
+        }
+
+        func endElement() {
+            self.flushCharacters()
+            self.openElements.removeLast()
+        }
+
+        func characterData(_ characters: UnsafeRawBufferPointer) {
+            self.text.append(contentsOf: characters)
+        }
+
+        func flushCharacters() {
+            let characters = self.charactersStart..<self.text.count
+            guard !characters.isEmpty else { return }
+            // if string with white space removed still has characters, add to element text
+            if let current = self.openElements.last, !self.isWhitespace(characters) {
+                let elementText = self.nodes[current].text
+                if elementText.isEmpty || elementText.upperBound == characters.lowerBound {
+                    self.nodes[current].text = (elementText.isEmpty ? characters.lowerBound : elementText.lowerBound)..<characters.upperBound
+                } else {
+                    // element text is split by a child element, so move the element text to the end of the document text
+                    let combined = Array(self.text[elementText]) + self.text[characters]
+                    self.text.removeSubrange(characters)
+                    let start = self.text.count
+                    self.text.append(contentsOf: combined)
+                    self.nodes[current].text = start..<self.text.count
+                }
+            } else {
+                self.text.removeSubrange(characters)
+            }
+            self.charactersStart = self.text.count
+        }
+
+        /// Is text all white space that isn't a newline
+        func isWhitespace(_ range: Range<Int>) -> Bool {
+            var isASCII = true
+            for byte in self.text[range] {
+                switch byte {
+                case UInt8(ascii: " "), UInt8(ascii: "\t"):
+                    continue
+                case 0x80...:
+                    isASCII = false
+                default:
+                    return false
+                }
+            }
+            guard !isASCII else { return true }
+            return !String(decoding: self.text[range], as: UTF8.self).contains(where: { !$0.isWhitespace || $0.isNewline })
+        }
+    }
+}
+
+/// Internal decoder class for XMLStreamingDecoder
+private class _XMLStreamingDecoder: Decoder {
+    /// Value being decoded, either an element or the value of an attribute
+    enum Value {
+        case element(Int)
+        case attribute(String)
+    }
+
+    /// The decoder's storage.
+    var storage: [Value?]
+
+    let nodes: [XMLStreamingDecoder.Node]
+
+    /// text of document
+    let text: [UInt8]
+
+    let dataDecodingStrategy: XMLDecoder.DataDecodingStrategy
+    let nonConformingFloatDecodingStrategy: XMLDecoder.NonConformingFloatDecodingStrategy
+
+    /// The path to the current point in encoding.
+    var codingPath: [CodingKey]
+
+    /// Contextual user-provided information for use during encoding.
+    let userInfo: [CodingUserInfoKey: Any]
+
+    init(
+        _ value: Value?,
+        at codingPath: [CodingKey] = [],
+        nodes: [XMLStreamingDecoder.Node],
+        text: [UInt8],
+        dataDecodingStrategy: XMLDecoder.DataDecodingStrategy,
+        nonConformingFloatDecodingStrategy: XMLDecoder.NonConformingFloatDecodingStrategy,
+        userInfo: [CodingUserInfoKey: Any]
+    ) {
+        self.storage = [value]
+        self.nodes = nodes
+        self.text = text
+        self.codingPath = codingPath
+        self.dataDecodingStrategy = dataDecodingStrategy
+        self.nonConformingFloatDecodingStrategy = nonConformingFloatDecodingStrategy
+        self.userInfo = userInfo
+    }
+
+    var topContainer: Value? { return self.storage.last! }
+
+    func container<Key>(keyedBy type: Key.Type) throws -> KeyedDecodingContainer<Key> where Key: CodingKey {
+        guard let value = topContainer else {
+            throw DecodingError.keyNotFound(codingPath.last!, DecodingError.Context(codingPath: codingPath, debugDescription: "Key not found"))
+        }
+        return KeyedDecodingContainer(KDC(value, decoder: self))
+    }
+
+    func unkeyedContainer() throws -> UnkeyedDecodingContainer {
+        // the elements of an array are siblings of the element being decoded, so use the parent container
+        let top = self.storage.removeLast()
+        defer { self.storage.append(top) }
+        guard let value = topContainer else {
+            throw DecodingError.keyNotFound(codingPath.last!, DecodingError.Context(codingPath: codingPath, debugDescription: "Key not found"))
+        }
+        return UKDC(value, decoder: self)
+    }
+
+    func singleValueContainer() throws -> SingleValueDecodingContainer {
+        guard let value = topContainer else {
+            throw DecodingError.keyNotFound(codingPath.last!, DecodingError.Context(codingPath: codingPath, debugDescription: "Key not found"))
+        }
+        return SVDC(value, decoder: self)
+    }
+
+    /// return child element with name
+    func child(of value: Value, named name: String) -> Int? {
+        guard case .element(let index) = value else { return nil }
+        var child = self.nodes[index].firstChild
+        while child != XMLStreamingDecoder.Node.none {
+            if self.nodes[child].name == name {
+                return child
+            }
+            child = self.nodes[child].nextSibling
+        }
+        return nil
+    }
+
+    /// return value of attribute with name
+    func attribute(of value: Value, named name: String) -> String? {
+        guard case .element(let index) = value else { return nil }
+        return self.nodes[index].attributes?.first { $0.name == name }?.value
+    }
+
+    /// return string value of element or attribute
+    func stringValue(_ value: Value) -> String {
+        switch value {
+        case .element(let index):
+            return String(decoding: self.text[self.nodes[index].text], as: UTF8.self)
+        case .attribute(let string):
+            return string
+        }
+    }
+
+    /// decode base64 string value of element or attribute, without creating a String
+    func base64DecodedValue(_ value: Value) -> Data? {
+        switch value {
+        case .element(let index):
+            return self.text[self.nodes[index].text].withUnsafeBytes { Self.base64Decode($0) }
+        case .attribute(var string):
+            return string.withUTF8 { Self.base64Decode(UnsafeRawBufferPointer($0)) }
+        }
+    }
+
+    /// Decode base64 into Data. Like `Data(base64Encoded:)` with no options, the input must be padded and have no
+    /// characters outside the base64 alphabet
+    static func base64Decode(_ bytes: UnsafeRawBufferPointer) -> Data? {
+        guard bytes.count % 4 == 0 else { return nil }
+        var padding = 0
+        if bytes.count > 0, bytes[bytes.count - 1] == UInt8(ascii: "=") {
+            padding = bytes[bytes.count - 2] == UInt8(ascii: "=") ? 2 : 1
+        }
+        let length = bytes.count / 4 * 3 - padding
+        var data = Data(count: length)
+        let success = data.withUnsafeMutableBytes { output -> Bool in
+            var outputIndex = 0
+            var index = 0
+            while index < bytes.count {
+                var value: UInt32 = 0
+                for i in index..<index + 4 {
+                    let sextet: UInt8
+                    if i >= bytes.count - padding {
+                        sextet = 0
+                    } else {
+                        sextet = Self.base64DecodeTable[Int(bytes[i])]
+                        guard sextet != 0xFF else { return false }
+                    }
+                    value = value << 6 | UInt32(sextet)
+                }
+                // the last block may be padded and decode to fewer than three bytes
+                output[outputIndex] = UInt8(truncatingIfNeeded: value >> 16)
+                if outputIndex + 1 < length { output[outputIndex + 1] = UInt8(truncatingIfNeeded: value >> 8) }
+                if outputIndex + 2 < length { output[outputIndex + 2] = UInt8(truncatingIfNeeded: value) }
+                outputIndex += 3
+                index += 4
+            }
+            return true
+        }
+        return success ? data : nil
+    }
+
+    /// value of each base64 character, 0xFF for characters outside the alphabet
+    static let base64DecodeTable: [UInt8] = {
+        var table = [UInt8](repeating: 0xFF, count: 256)
+        for (value, character) in "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/".utf8.enumerated() {
+            table[Int(character)] = UInt8(value)
+        }
+        return table
+    }()
+
+    struct KDC<Key: CodingKey>: KeyedDecodingContainerProtocol {
+        var codingPath: [CodingKey] { return decoder.codingPath }
+        let value: Value
+        let decoder: _XMLStreamingDecoder
+
+        init(_ value: Value, decoder: _XMLStreamingDecoder) {
+            self.value = value
+            self.decoder = decoder
+        }
+
+        /// all elements directly under the container xml element are considered
+        var allKeys: [Key] {
+            guard case .element(let index) = value else { return [] }
+            var keys: [Key] = []
+            var child = self.decoder.nodes[index].firstChild
+            while child != XMLStreamingDecoder.Node.none {
+                if let key = Key(stringValue: self.decoder.nodes[child].name) {
+                    keys.append(key)
+                }
+                child = self.decoder.nodes[child].nextSibling
+            }
+            return keys
+        }
+
+        func contains(_ key: Key) -> Bool {
+            return self.decoder.child(of: self.value, named: key.stringValue) != nil
+        }
+
+        /// get the value for a particular key
+        func optionalChild(for key: CodingKey) -> Value? {
+            if let child = decoder.child(of: value, named: key.stringValue) {
+                return .element(child)
+            } else if let attribute = decoder.attribute(of: value, named: key.stringValue) {
+                return .attribute(attribute)
+            }
+            return nil
+        }
+
+        /// get the value for a particular key
+        func child(for key: CodingKey) throws -> Value {
+            guard let child = optionalChild(for: key) else {
+                throw DecodingError.keyNotFound(key, DecodingError.Context(codingPath: codingPath, debugDescription: "Key not found"))
+            }
+            return child
+        }
+
+        func decodeNil(forKey key: Key) throws -> Bool {
+            return false
+        }
+
+        func decode(_ type: Bool.Type, forKey key: Key) throws -> Bool {
+            return try self.decoder.unbox(try self.child(for: key), as: Bool.self)
+        }
+
+        func decode(_ type: String.Type, forKey key: Key) throws -> String {
+            return self.decoder.stringValue(try self.child(for: key))
+        }
+
+        func decode(_ type: Double.Type, forKey key: Key) throws -> Double {
+            return try self.decoder.unbox(try self.child(for: key), as: Double.self)
+        }
+
+        func decode(_ type: Float.Type, forKey key: Key) throws -> Float {
+            return try self.decoder.unbox(try self.child(for: key), as: Float.self)
+        }
+
+        func decode(_ type: Int.Type, forKey key: Key) throws -> Int {
+            return try self.decoder.unbox(try self.child(for: key), as: Int.self)
+        }
+
+        func decode(_ type: Int8.Type, forKey key: Key) throws -> Int8 {
+            return try self.decoder.unbox(try self.child(for: key), as: Int8.self)
+        }
+
+        func decode(_ type: Int16.Type, forKey key: Key) throws -> Int16 {
+            return try self.decoder.unbox(try self.child(for: key), as: Int16.self)
+        }
+
+        func decode(_ type: Int32.Type, forKey key: Key) throws -> Int32 {
+            return try self.decoder.unbox(try self.child(for: key), as: Int32.self)
+        }
+
+        func decode(_ type: Int64.Type, forKey key: Key) throws -> Int64 {
+            return try self.decoder.unbox(try self.child(for: key), as: Int64.self)
+        }
+
+        func decode(_ type: UInt.Type, forKey key: Key) throws -> UInt {
+            return try self.decoder.unbox(try self.child(for: key), as: UInt.self)
+        }
+
+        func decode(_ type: UInt8.Type, forKey key: Key) throws -> UInt8 {
+            return try self.decoder.unbox(try self.child(for: key), as: UInt8.self)
+        }
+
+        func decode(_ type: UInt16.Type, forKey key: Key) throws -> UInt16 {
+            return try self.decoder.unbox(try self.child(for: key), as: UInt16.self)
+        }
+
+        func decode(_ type: UInt32.Type, forKey key: Key) throws -> UInt32 {
+            return try self.decoder.unbox(try self.child(for: key), as: UInt32.self)
+        }
+
+        func decode(_ type: UInt64.Type, forKey key: Key) throws -> UInt64 {
+            return try self.decoder.unbox(try self.child(for: key), as: UInt64.self)
+        }
+
+        func decode<T>(_ type: T.Type, forKey key: Key) throws -> T where T: Decodable {
+            self.decoder.codingPath.append(key)
+            defer { self.decoder.codingPath.removeLast() }
+
+            return try self.decoder.unbox(self.optionalChild(for: key), as: T.self)
+        }
+
+        func nestedContainer<NestedKey>(keyedBy type: NestedKey.Type, forKey key: Key) throws -> KeyedDecodingContainer<NestedKey> where NestedKey: CodingKey {
+            self.decoder.codingPath.append(key)
+            defer { self.decoder.codingPath.removeLast() }
+
+            return KeyedDecodingContainer(KDC<NestedKey>(try self.child(for: key), decoder: self.decoder))
+        }
+
+        func nestedUnkeyedContainer(forKey key: Key) throws -> UnkeyedDecodingContainer {
+            self.decoder.codingPath.append(key)
+            defer { self.decoder.codingPath.removeLast() }
+
+            return UKDC(self.value, decoder: self.decoder)
+        }
+
+        private func _superDecoder(forKey key: __owned CodingKey) throws -> Decoder {
+            self.decoder.codingPath.append(key)
+            defer { self.decoder.codingPath.removeLast() }
+
+            return _XMLStreamingDecoder(
+                try self.child(for: key),
+                at: self.decoder.codingPath,
+                nodes: self.decoder.nodes,
+                text: self.decoder.text,
+                dataDecodingStrategy: self.decoder.dataDecodingStrategy,
+                nonConformingFloatDecodingStrategy: self.decoder.nonConformingFloatDecodingStrategy,
+                userInfo: self.decoder.userInfo
+            )
+        }
+
+        func superDecoder() throws -> Decoder {
+            return try _superDecoder(forKey: _XMLKey.super)
+        }
+
+        func superDecoder(forKey key: Key) throws -> Decoder {
+            return try _superDecoder(forKey: key)
+        }
+    }
+
+    struct UKDC: UnkeyedDecodingContainer {
+        var codingPath: [CodingKey] { return decoder.codingPath }
+        var currentIndex: Int = 0
+        let elements: [Int]
+        let decoder: _XMLStreamingDecoder
+
+        /// the elements of the container are the children of `value` named after the last key in the coding path
+        init(_ value: Value, decoder: _XMLStreamingDecoder) {
+            var elements: [Int] = []
+            if case .element(let index) = value {
+                let name = decoder.codingPath.last!.stringValue
+                var child = decoder.nodes[index].firstChild
+                while child != XMLStreamingDecoder.Node.none {
+                    if decoder.nodes[child].name == name {
+                        elements.append(child)
+                    }
+                    child = decoder.nodes[child].nextSibling
+                }
+            }
+            self.elements = elements
+            self.decoder = decoder
+        }
+
+        var count: Int? {
+            return self.elements.count
+        }
+
+        var isAtEnd: Bool {
+            return self.currentIndex >= self.elements.count
+        }
+
+        mutating func nextValue() throws -> Value {
+            guard !self.isAtEnd else {
+                throw DecodingError.valueNotFound(Any.self, DecodingError.Context(codingPath: self.codingPath, debugDescription: "Unkeyed container is at end."))
+            }
+            let value = Value.element(self.elements[self.currentIndex])
+            self.currentIndex += 1
+            return value
+        }
+
+        mutating func decodeNil() throws -> Bool {
+            return false
+        }
+
+        mutating func decode(_: Bool.Type) throws -> Bool {
+            return try self.decoder.unbox(try self.nextValue(), as: Bool.self)
+        }
+
+        mutating func decode(_: String.Type) throws -> String {
+            return self.decoder.stringValue(try self.nextValue())
+        }
+
+        mutating func decode(_: Double.Type) throws -> Double {
+            return try self.decoder.unbox(try self.nextValue(), as: Double.self)
+        }
+
+        mutating func decode(_: Float.Type) throws -> Float {
+            return try self.decoder.unbox(try self.nextValue(), as: Float.self)
+        }
+
+        mutating func decode(_: Int.Type) throws -> Int {
+            return try self.decoder.unbox(try self.nextValue(), as: Int.self)
+        }
+
+        mutating func decode(_: Int8.Type) throws -> Int8 {
+            return try self.decoder.unbox(try self.nextValue(), as: Int8.self)
+        }
+
+        mutating func decode(_: Int16.Type) throws -> Int16 {
+            return try self.decoder.unbox(try self.nextValue(), as: Int16.self)
+        }
+
+        mutating func decode(_: Int32.Type) throws -> Int32 {
+            return try self.decoder.unbox(try self.nextValue(), as: Int32.self)
+        }
+
+        mutating func decode(_: Int64.Type) throws -> Int64 {
+            return try self.decoder.unbox(try self.nextValue(), as: Int64.self)
+        }
+
+        mutating func decode(_: UInt.Type) throws -> UInt {
+            return try self.decoder.unbox(try self.nextValue(), as: UInt.self)
+        }
+
+        mutating func decode(_: UInt8.Type) throws -> UInt8 {
+            return try self.decoder.unbox(try self.nextValue(), as: UInt8.self)
+        }
+
+        mutating func decode(_: UInt16.Type) throws -> UInt16 {
+            return try self.decoder.unbox(try self.nextValue(), as: UInt16.self)
+        }
+
+        mutating func decode(_: UInt32.Type) throws -> UInt32 {
+            return try self.decoder.unbox(try self.nextValue(), as: UInt32.self)
+        }
+
+        mutating func decode(_: UInt64.Type) throws -> UInt64 {
+            return try self.decoder.unbox(try self.nextValue(), as: UInt64.self)
+        }
+
+        mutating func decode<T>(_: T.Type) throws -> T where T: Decodable {
+            return try self.decoder.unbox(try self.nextValue(), as: T.self)
+        }
+
+        mutating func nestedContainer<NestedKey>(keyedBy type: NestedKey.Type) throws -> KeyedDecodingContainer<NestedKey> where NestedKey: CodingKey {
+            self.decoder.codingPath.append(_XMLKey(index: self.currentIndex))
+            defer { self.decoder.codingPath.removeLast() }
+
+            return KeyedDecodingContainer(KDC<NestedKey>(try self.nextValue(), decoder: self.decoder))
+        }
+
+        mutating func nestedUnkeyedContainer() throws -> UnkeyedDecodingContainer {
+            self.decoder.codingPath.append(_XMLKey(index: self.currentIndex))
+            defer { self.decoder.codingPath.removeLast() }
+
+            return UKDC(try self.nextValue(), decoder: self.decoder)
+        }
+
+        mutating func superDecoder() throws -> Decoder {
+            self.decoder.codingPath.append(_XMLKey(index: self.currentIndex))
+            defer { self.decoder.codingPath.removeLast() }
+
+            return _XMLStreamingDecoder(
+                try self.nextValue(),
+                at: self.decoder.codingPath,
+                nodes: self.decoder.nodes,
+                text: self.decoder.text,
+                dataDecodingStrategy: self.decoder.dataDecodingStrategy,
+                nonConformingFloatDecodingStrategy: self.decoder.nonConformingFloatDecodingStrategy,
+                userInfo: self.decoder.userInfo
+            )
+        }
+    }
+
+    struct SVDC: SingleValueDecodingContainer {
+        var codingPath: [CodingKey] { return decoder.codingPath }
+        let value: Value
+        let decoder: _XMLStreamingDecoder
+
+        init(_ value: Value, decoder: _XMLStreamingDecoder) {
+            self.value = value
+            self.decoder = decoder
+        }
+
+        func decodeNil() -> Bool {
+            return false
+        }
+
+        func decode(_: Bool.Type) throws -> Bool {
+            return try self.decoder.unbox(self.value, as: Bool.self)
+        }
+
+        func decode(_: String.Type) throws -> String {
+            return self.decoder.stringValue(self.value)
+        }
+
+        func decode(_: Double.Type) throws -> Double {
+            return try self.decoder.unbox(self.value, as: Double.self)
+        }
+
+        func decode(_: Float.Type) throws -> Float {
+            return try self.decoder.unbox(self.value, as: Float.self)
+        }
+
+        func decode(_: Int.Type) throws -> Int {
+            return try self.decoder.unbox(self.value, as: Int.self)
+        }
+
+        func decode(_: Int8.Type) throws -> Int8 {
+            return try self.decoder.unbox(self.value, as: Int8.self)
+        }
+
+        func decode(_: Int16.Type) throws -> Int16 {
+            return try self.decoder.unbox(self.value, as: Int16.self)
+        }
+
+        func decode(_: Int32.Type) throws -> Int32 {
+            return try self.decoder.unbox(self.value, as: Int32.self)
+        }
+
+        func decode(_: Int64.Type) throws -> Int64 {
+            return try self.decoder.unbox(self.value, as: Int64.self)
+        }
+
+        func decode(_: UInt.Type) throws -> UInt {
+            return try self.decoder.unbox(self.value, as: UInt.self)
+        }
+
+        func decode(_: UInt8.Type) throws -> UInt8 {
+            return try self.decoder.unbox(self.value, as: UInt8.self)
+        }
+
+        func decode(_: UInt16.Type) throws -> UInt16 {
+            return try self.decoder.unbox(self.value, as: UInt16.self)
+        }
+
+        func decode(_: UInt32.Type) throws -> UInt32 {
+            return try self.decoder.unbox(self.value, as: UInt32.self)
+        }
+
+        func decode(_: UInt64.Type) throws -> UInt64 {
+            return try self.decoder.unbox(self.value, as: UInt64.self)
+        }
+
+        func decode<T>(_: T.Type) throws -> T where T: Decodable {
+            return try self.decoder.unbox(self.value, as: T.self)
+        }
+    }
+
+    /// unbox numbers and booleans from their string value
+    func unbox<T: LosslessStringConvertible>(_ value: Value, as type: T.Type) throws -> T {
+        let string = self.stringValue(value)
+        guard let unboxValue = T(string) else { throw DecodingError._typeMismatch(at: codingPath, expectation: T.self, reality: string) }
+        return unboxValue
+    }
+
+    func unbox(_ value: Value, as type: Double.Type) throws -> Double {
+        let string = self.stringValue(value)
+        guard let unboxValue = self.nonConformingFloatDecodingStrategy.value(string, as: Double.self) else {
+            throw DecodingError._typeMismatch(at: codingPath, expectation: Double.self, reality: string)
+        }
+        return unboxValue
+    }
+
+    func unbox(_ value: Value, as type: Float.Type) throws -> Float {
+        let string = self.stringValue(value)
+        guard let unboxValue = self.nonConformingFloatDecodingStrategy.value(string, as: Float.self) else {
+            throw DecodingError._typeMismatch(at: codingPath, expectation: Float.self, reality: string)
+        }
+        return unboxValue
+    }
+
+    func unbox(_ value: Value?, as type: Date.Type) throws -> Date {
+        guard let value = value else {
+            throw DecodingError.keyNotFound(codingPath.last!, DecodingError.Context(codingPath: codingPath, debugDescription: "Key not found"))
+        }
+
+        let string = self.stringValue(value)
+        for formatter in XMLDecoder.dateFormatters {
+            if let date = formatter.date(from: string) {
+                return date
+            }
+        }
+        throw DecodingError.dataCorrupted(DecodingError.Context(codingPath: self.codingPath, debugDescription: "Date string does not match format expected"))
+    }
+
+    func unbox(_ value: Value?, as type: Data.Type) throws -> Data {
+        guard let value = value else {
+            throw DecodingError.keyNotFound(codingPath.last!, DecodingError.Context(codingPath: codingPath, debugDescription: "Key not found"))
+        }
+        switch self.dataDecodingStrategy {
+        case .base64:
+            guard let data = self.base64DecodedValue(value) else {
+                throw DecodingError.dataCorrupted(DecodingError.Context(codingPath: self.codingPath, debugDescription: "Encountered Data is not valid Base64."))
+            }
+            return data
+
+        case .custom(let closure):
+            self.storage.append(value)
+            defer { self.storage.removeLast() }
+            return try closure(self)
+        }
+    }
+
+    func unbox<T>(_ value: Value?, as type: T.Type) throws -> T where T: Decodable {
+        return try unbox_(value, as: T.self) as! T
+    }
+
+    func unbox_(_ value: Value?, as type: Decodable.Type) throws -> Any {
+        if type == Data.self {
+            return try self.unbox(value, as: Data.self)
+        } else if type == Date.self {
+            return try self.unbox(value, as: Date.self)
+        } else {
+            self.storage.append(value)
+            defer { self.storage.removeLast() }
+            return try type.init(from: self)
+        }
+    }
+}
+
+//===----------------------------------------------------------------------===//
+// Shared Key Types
+//===----------------------------------------------------------------------===//
+
+private struct _XMLKey: CodingKey {
+    public var stringValue: String
+    public var intValue: Int?
+
+    public init?(stringValue: String) {
+        self.stringValue = stringValue
+        self.intValue = nil
+    }
+
+    public init?(intValue: Int) {
+        self.stringValue = "\(intValue)"
+        self.intValue = intValue
+    }
+
+    fileprivate init(index: Int) {
+        self.stringValue = "Index \(index)"
+        self.intValue = index
+    }
+
+    fileprivate static let `super` = _XMLKey(stringValue: "super")!
+}
@@ -14,6 +14,7 @@
 
 import AsyncHTTPClient
 import Logging
+import Metrics
 import NIO
 import NIOConcurrencyHelpers
 import NIOFoundationCompat
@@ -217,7 +218,222 @@ class AWSClientTests: XCTestCase {
         }
     }
 
-    func testRequestStreaming(config: AWSServiceConfig, client: AWSClient, server: AWSTestServer, bufferSize: Int, blockSize: Int) throws {
+    func testCoalescedRequests() {
+        struct Input: AWSEncodableShape & Decodable {
+            let name: String
+        }
+        struct Output: AWSDecodableShape & Encodable {
+            let s: String
+        }
+        do {
+            let eventLoopGroup = MultiThreadedEventLoopGroup(numberOfThreads: 2)
+            defer { XCTAssertNoThrow(try eventLoopGroup.syncShutdownGracefully()) }
+            let awsServer = AWSTestServer(serviceProtocol: .json)
+            let config = createServiceConfig(serviceProtocol: .json(version: "1.1"), endpoint: awsServer.address)
+            let client = createAWSClient(
+                credentialProvider: .empty,
+                options: .init(coalescedOperations: [config.service: ["Get"]]),
+                httpClientProvider: .createNewWithEventLoopGroup(eventLoopGroup)
+            )
+            defer {
+                XCTAssertNoThrow(try client.syncShutdown())
+                XCTAssertNoThrow(try awsServer.stop())
+            }
+            let responses: [EventLoopFuture<Output>] = (0..<8).map { _ in
+                client.execute(operation: "Get", path: "/", httpMethod: .POST, serviceConfig: config, input: Input(name: "param"), logger: TestEnvironment.logger)
+            }
+            XCTAssertEqual(client.singleFlight.count, 1)
+
+            // server only receives one request
+            try awsServer.process { (input: Input) -> AWSTestServer.Result<Output> in
+                return .result(Output(s: input.name))
+            }
+
+            for response in responses {
+                XCTAssertEqual(try response.wait().s, "param")
+            }
+            XCTAssertEqual(client.singleFlight.count, 0)
+        } catch {
+            XCTFail("Unexpected error: \(error)")
+        }
+    }
+
+    func testRecordStageMetrics() {
+        struct Input: AWSEncodableShape & Decodable {
+            let name: String
+        }
+        struct Output: AWSDecodableShape & Encodable {
+            let s: String
+        }
+        let metrics = MetricsCollector.shared
+        let stageTimers = [
+            "aws_credential_duration",
+            "aws_signing_duration",
+            "aws_request_send_duration",
+            "aws_time_to_first_byte",
+            "aws_response_transfer_duration",
+            "aws_decode_duration",
+        ]
+        let stageRecorders = ["aws_response_body_size", "aws_request_attempts"]
+        do {
+            let awsServer = AWSTestServer(serviceProtocol: .json)
+            let config = createServiceConfig(serviceProtocol: .json(version: "1.1"), endpoint: awsServer.address)
+            let xmlConfig = createServiceConfig(serviceProtocol: .restxml, endpoint: awsServer.address)
+            let client = createAWSClient(credentialProvider: .empty, options: .init(recordStageMetrics: true))
+            defer {
+                XCTAssertNoThrow(try client.syncShutdown())
+                XCTAssertNoThrow(try awsServer.stop())
+            }
+            let response: EventLoopFuture<Output> = client.execute(
+                operation: "StageMetricsJSON",
+                path: "/",
+                httpMethod: .POST,
+                serviceConfig: config,
+                input: Input(name: "json"),
+                logger: TestEnvironment.logger
+            )
+            try awsServer.process { (input: Input) -> AWSTestServer.Result<Output> in
+                return .result(Output(s: input.name))
+            }
+            XCTAssertEqual(try response.wait().s, "json")
+
+            // XML responses are parsed by a different HTTP client delegate
+            let xmlResponse: EventLoopFuture<Output> = client.execute(
+                operation: "StageMetricsXML",
+                path: "/",
+                httpMethod: .GET,
+                serviceConfig: xmlConfig,
+                logger: TestEnvironment.logger
+            )
+            let xmlBody = "<Output><s>xml</s></Output>"
+            try awsServer.processRaw { _ in
+                return .result(.init(httpStatus: .ok, body: ByteBufferAllocator().buffer(string: xmlBody)))
+            }
+            XCTAssertEqual(try xmlResponse.wait().s, "xml")
+
+            for operation in ["StageMetricsJSON", "StageMetricsXML"] {
+                let dimensions = ["aws-service": config.service, "aws-operation": operation]
+                for label in stageTimers {
+                    let timers = metrics.handlers(label: label, dimensions: dimensions)
+                    XCTAssertEqual(timers.count, 1, "\(label) for \(operation)")
+                    XCTAssertEqual(timers.first?.kind, .timer)
+                    XCTAssertEqual(timers.first?.values.count, 1, "\(label) for \(operation)")
+                    XCTAssertGreaterThanOrEqual(timers.first?.values.first ?? -1, 0)
+                }
+                for label in stageRecorders {
+                    let recorders = metrics.handlers(label: label, dimensions: dimensions)
+                    XCTAssertEqual(recorders.count, 1, "\(label) for \(operation)")
+                    XCTAssertEqual(recorders.first?.kind, .recorder)
+                    XCTAssertEqual(recorders.first?.values.count, 1, "\(label) for \(operation)")
+                }
+                XCTAssertEqual(metrics.handlers(label: "aws_request_attempts", dimensions: dimensions).first?.values, [1])
+            }
+            let xmlDimensions = ["aws-service": config.service, "aws-operation": "StageMetricsXML"]
+            XCTAssertEqual(metrics.handlers(label: "aws_response_body_size", dimensions: xmlDimensions).first?.values, [Double(xmlBody.utf8.count)])
+        } catch {
+            XCTFail("Unexpected error: \(error)")
+        }
+    }
+
+    func testClientNoInputWithXMLOutput() {
+        struct Output: AWSDecodableShape {
+            static let _encoding = [AWSMemberEncoding(label: "test", location: .header(locationName: "test"))]
+            let test: String
+            let values: [Int]
+        }
+        do {
+            let awsServer = AWSTestServer(serviceProtocol: .xml)
+            let config = createServiceConfig(serviceProtocol: .restxml, endpoint: awsServer.address)
+            let client = createAWSClient(credentialProvider: .empty)
+            defer {
+                XCTAssertNoThrow(try client.syncShutdown())
+                XCTAssertNoThrow(try awsServer.stop())
+            }
+            let response: EventLoopFuture<Output> = client.execute(operation: "test", path: "/", httpMethod: .GET, serviceConfig: config, logger: TestEnvironment.logger)
+
+            try awsServer.processRaw { _ in
+                // large enough to be received in multiple parts
+                let xml = "<Output>" + (0..<10000).map { "<values>\($0)</values>" }.joined() + "</Output>"
+                var byteBuffer = ByteBufferAllocator().buffer(capacity: xml.utf8.count)
+                byteBuffer.writeString(xml)
+                let response = AWSTestServer.Response(httpStatus: .ok, headers: ["test": "TestHeader"], body: byteBuffer)
+                return .result(response)
+            }
+
+            let output = try response.wait()
+
+            XCTAssertEqual(output.test, "TestHeader")
+            XCTAssertEqual(output.values.count, 10000)
+            XCTAssertEqual(output.values.last, 9999)
+        } catch {
+            XCTFail("Unexpected error: \(error)")
+        }
+    }
+
+    func testClientNoInputWithQueryXMLOutput() {
+        struct Output: AWSDecodableShape {
+            let name: String
+            let values: [Int]
+        }
+        do {
+            let awsServer = AWSTestServer(serviceProtocol: .xml)
+            let config = createServiceConfig(serviceProtocol: .query, endpoint: awsServer.address)
+            let client = createAWSClient(credentialProvider: .empty)
+            defer {
+                XCTAssertNoThrow(try client.syncShutdown())
+                XCTAssertNoThrow(try awsServer.stop())
+            }
+            let response: EventLoopFuture<Output> = client.execute(operation: "Test", path: "/", httpMethod: .GET, serviceConfig: config, logger: TestEnvironment.logger)
+
+            try awsServer.processRaw { _ in
+                let values = (0..<10000).map { "<values>\($0)</values>" }.joined()
+                let xml = "<TestResponse><TestResult><name>test</name>\(values)</TestResult></TestResponse>"
+                var byteBuffer = ByteBufferAllocator().buffer(capacity: xml.utf8.count)
+                byteBuffer.writeString(xml)
+                let response = AWSTestServer.Response(httpStatus: .ok, headers: [:], body: byteBuffer)
+                return .result(response)
+            }
+
+            let output = try response.wait()
+
+            XCTAssertEqual(output.name, "test")
+            XCTAssertEqual(output.values.count, 10000)
+            XCTAssertEqual(output.values.last, 9999)
+        } catch {
+            XCTFail("Unexpected error: \(error)")
+        }
+    }
+
+    func testClientXMLOutputError() {
+        struct Output: AWSDecodableShape {
+            let value: String
+        }
+        do {
+            let awsServer = AWSTestServer(serviceProtocol: .xml)
+            let config = createServiceConfig(serviceProtocol: .restxml, endpoint: awsServer.address)
+            let client = createAWSClient(credentialProvider: .empty)
+            defer {
+                XCTAssertNoThrow(try client.syncShutdown())
+                XCTAssertNoThrow(try awsServer.stop())
+            }
+            let response: EventLoopFuture<Output> = client.execute(operation: "test", path: "/", httpMethod: .GET, serviceConfig: config, logger: TestEnvironment.logger)
+
+            try awsServer.processRaw { _ in
+                return .error(.accessDenied)
+            }
+
+            XCTAssertThrowsError(try response.wait()) { error in
+                guard let error = error as? AWSClientError, error == .accessDenied else {
+                    return XCTFail("Unexpected error: \(error)")
+                }
+                XCTAssertEqual(error.message, AWSTestServer.ErrorType.accessDenied.message)
+            }
+        } catch {
+            XCTFail("Unexpected error: \(error)")
+        }
+    }
+
+    func testRequestStreaming(config: AWSServiceConfig, client: AWSClient, server: AWSTestServer, bufferSize: Int, blockSize: Int, chunkSize: Int? = nil) throws {
         struct Input: AWSEncodableShape & AWSShapeWithPayload {
             static var _payloadPath: String = "payload"
             static var _payloadOptions: AWSShapePayloadOptions = [.allowStreaming, .raw]
@@ -228,7 +444,7 @@ class AWSClientTests: XCTestCase {
         var byteBuffer = ByteBufferAllocator().buffer(capacity: data.count)
         byteBuffer.writeBytes(data)
 
-        let payload = AWSPayload.stream(size: bufferSize) { eventLoop in
+        let payload = AWSPayload.stream(size: bufferSize, chunkSize: chunkSize) { eventLoop in
             let size = min(blockSize, byteBuffer.readableBytes)
             // don't ask for 0 bytes
             if size == 0 {
@@ -288,6 +504,84 @@ class AWSClientTests: XCTestCase {
         XCTAssertNoThrow(try self.testRequestStreaming(config: config, client: client, server: awsServer, bufferSize: 65552, blockSize: 65552))
     }
 
+    func testRequestS3StreamingPipelined() {
+        let awsServer = AWSTestServer(serviceProtocol: .json)
+        let httpClient = HTTPClient(eventLoopGroupProvider: .createNew)
+        let threadPool = NIOThreadPool(numberOfThreads: 2)
+        threadPool.start()
+        let config = createServiceConfig(service: "s3", endpoint: awsServer.address)
+        let client = createAWSClient(
+            credentialProvider: .static(accessKeyId: "foo", secretAccessKey: "bar"),
+            options: .init(s3ChunkedUpload: .init(threadPool: threadPool, readAhead: 3)),
+            httpClientProvider: .shared(httpClient)
+        )
+        defer {
+            XCTAssertNoThrow(try client.syncShutdown())
+            XCTAssertNoThrow(try awsServer.stop())
+            XCTAssertNoThrow(try httpClient.syncShutdown())
+            XCTAssertNoThrow(try threadPool.syncShutdownGracefully())
+        }
+
+        XCTAssertNoThrow(try self.testRequestStreaming(config: config, client: client, server: awsServer, bufferSize: 128 * 1024, blockSize: 16 * 1024))
+        XCTAssertNoThrow(try self.testRequestStreaming(config: config, client: client, server: awsServer, bufferSize: 81 * 1024, blockSize: 16 * 1024))
+        XCTAssertNoThrow(try self.testRequestStreaming(config: config, client: client, server: awsServer, bufferSize: 130 * 1024, blockSize: S3ChunkedStreamReader.bufferSize))
+        XCTAssertNoThrow(try self.testRequestStreaming(config: config, client: client, server: awsServer, bufferSize: 600 * 1024, blockSize: 47 * 1024))
+        XCTAssertNoThrow(try self.testRequestStreaming(config: config, client: client, server: awsServer, bufferSize: 1000, blockSize: 1000))
+    }
+
+    func testRequestS3StreamingChunkSizeAndBufferPool() throws {
+        let awsServer = AWSTestServer(serviceProtocol: .json)
+        let httpClient = HTTPClient(eventLoopGroupProvider: .createNew)
+        let config = createServiceConfig(service: "s3", endpoint: awsServer.address)
+        let client = createAWSClient(
+            credentialProvider: .static(accessKeyId: "foo", secretAccessKey: "bar"),
+            options: .init(s3ChunkedUpload: .init(bufferPoolSize: 256 * 1024)),
+            httpClientProvider: .shared(httpClient)
+        )
+        defer {
+            XCTAssertNoThrow(try client.syncShutdown())
+            XCTAssertNoThrow(try awsServer.stop())
+            XCTAssertNoThrow(try httpClient.syncShutdown())
+        }
+
+        XCTAssertNoThrow(try self.testRequestStreaming(config: config, client: client, server: awsServer, bufferSize: 128 * 1024, blockSize: 16 * 1024, chunkSize: 16 * 1024))
+        XCTAssertNoThrow(try self.testRequestStreaming(config: config, client: client, server: awsServer, bufferSize: 81 * 1024, blockSize: 17 * 1024, chunkSize: 8 * 1024))
+        XCTAssertNoThrow(try self.testRequestStreaming(config: config, client: client, server: awsServer, bufferSize: 600 * 1024, blockSize: 47 * 1024, chunkSize: 256 * 1024))
+        XCTAssertNoThrow(try self.testRequestStreaming(config: config, client: client, server: awsServer, bufferSize: 600 * 1024, blockSize: 47 * 1024, chunkSize: 300 * 1024))
+        // chunk sizes below the S3 minimum are rounded up
+        XCTAssertNoThrow(try self.testRequestStreaming(config: config, client: client, server: awsServer, bufferSize: 81 * 1024, blockSize: 17 * 1024, chunkSize: 1000))
+        let bufferPool = try XCTUnwrap(client.s3ChunkedUploadBufferPool)
+        XCTAssertLessThanOrEqual(bufferPool.allocatedBytes, bufferPool.maximumBytes)
+        // buffers are given back when each upload finishes
+        XCTAssertEqual(bufferPool.borrowedBytes, 0)
+    }
+
+    func testRequestS3StreamingPipelinedBufferPool() throws {
+        let awsServer = AWSTestServer(serviceProtocol: .json)
+        let httpClient = HTTPClient(eventLoopGroupProvider: .createNew)
+        let threadPool = NIOThreadPool(numberOfThreads: 2)
+        threadPool.start()
+        let config = createServiceConfig(service: "s3", endpoint: awsServer.address)
+        // pool only has room for two of the four chunks read ahead
+        let client = createAWSClient(
+            credentialProvider: .static(accessKeyId: "foo", secretAccessKey: "bar"),
+            options: .init(s3ChunkedUpload: .init(threadPool: threadPool, readAhead: 4, bufferPoolSize: 128 * 1024)),
+            httpClientProvider: .shared(httpClient)
+        )
+        defer {
+            XCTAssertNoThrow(try client.syncShutdown())
+            XCTAssertNoThrow(try awsServer.stop())
+            XCTAssertNoThrow(try httpClient.syncShutdown())
+            XCTAssertNoThrow(try threadPool.syncShutdownGracefully())
+        }
+
+        XCTAssertNoThrow(try self.testRequestStreaming(config: config, client: client, server: awsServer, bufferSize: 600 * 1024, blockSize: 47 * 1024))
+        XCTAssertNoThrow(try self.testRequestStreaming(config: config, client: client, server: awsServer, bufferSize: 130 * 1024, blockSize: S3ChunkedStreamReader.bufferSize))
+        let bufferPool = try XCTUnwrap(client.s3ChunkedUploadBufferPool)
+        XCTAssertLessThanOrEqual(bufferPool.allocatedBytes, bufferPool.maximumBytes)
+        XCTAssertEqual(bufferPool.borrowedBytes, 0)
+    }
+
     func testRequestStreamingWithPayload(_ payload: AWSPayload) throws {
         struct Input: AWSEncodableShape & AWSShapeWithPayload {
             static var _payloadPath: String = "payload"
@@ -842,3 +1136,88 @@ class AWSClientTests: XCTestCase {
         XCTAssertNoThrow(try response.wait())
     }
 }
+
+/// Metrics factory that keeps every value recorded, so tests can check what was recorded
+final class MetricsCollector: MetricsFactory {
+    /// `MetricsSystem` can only be bootstrapped once per process, so all tests share this collector
+    static let shared: MetricsCollector = {
+        let collector = MetricsCollector()
+        MetricsSystem.bootstrap(collector)
+        return collector
+    }()
+
+    final class Handler: CounterHandler, RecorderHandler, TimerHandler {
+        enum Kind {
+            case counter
+            case recorder
+            case timer
+        }
+
+        let kind: Kind
+        let label: String
+        let dimensions: [(String, String)]
+        private let lock = Lock()
+        private var _values: [Double] = []
+
+        var values: [Double] { return self.lock.withLock { self._values } }
+
+        init(kind: Kind, label: String, dimensions: [(String, String)]) {
+            self.kind = kind
+            self.label = label
+            self.dimensions = dimensions
+        }
+
+        func increment(by amount: Int64) { self.append(Double(amount)) }
+        func reset() { self.lock.withLockVoid { self._values = [] } }
+        func record(_ value: Int64) { self.append(Double(value)) }
+        func record(_ value: Double) { self.append(value) }
+        func recordNanoseconds(_ duration: Int64) { self.append(Double(duration)) }
+
+        private func append(_ value: Double) {
+            self.lock.withLockVoid { self._values.append(value) }
+        }
+    }
+
+    private let lock = Lock()
+    private var handlers: [Handler] = []
+
+    /// Return handlers created with label, whose dimensions include `dimensions`
+    func handlers(label: String, dimensions: [String: String]) -> [Handler] {
+        return self.lock.withLock {
+            self.handlers.filter { handler in
+                let handlerDimensions = Dictionary(handler.dimensions) { $1 }
+                return handler.label == label && dimensions.allSatisfy { handlerDimensions[$0.key] == $0.value }
+            }
+        }
+    }
+
+    func makeCounter(label: String, dimensions: [(String, String)]) -> CounterHandler {
+        return self.makeHandler(kind: .counter, label: label, dimensions: dimensions)
+    }
+
+    func makeRecorder(label: String, dimensions: [(String, String)], aggregate: Bool) -> RecorderHandler {
+        return self.makeHandler(kind: .recorder, label: label, dimensions: dimensions)
+    }
+
+    func makeTimer(label: String, dimensions: [(String, String)]) -> TimerHandler {
+        return self.makeHandler(kind: .timer, label: label, dimensions: dimensions)
+    }
+
+    func destroyCounter(_ handler: CounterHandler) {}
+    func destroyRecorder(_ handler: RecorderHandler) {}
+    func destroyTimer(_ handler: TimerHandler) {}
+
+    /// Return existing handler with the same kind, label and dimensions, or create a new one
+    private func makeHandler(kind: Handler.Kind, label: String, dimensions: [(String, String)]) -> Handler {
+        return self.lock.withLock {
+            if let handler = self.handlers.first(where: { handler in
+                handler.kind == kind && handler.label == label && handler.dimensions.elementsEqual(dimensions) { $0 == $1 }
+            }) {
+                return handler
+            }
+            let handler = Handler(kind: kind, label: label, dimensions: dimensions)
+            self.handlers.append(handler)
+            return handler
+        }
+    }
+}
@@ -17,6 +17,7 @@ import NIOHTTP1
 @testable import SotoCore
 import SotoSignerV4
 import SotoTestUtils
+import SotoXML
 import XCTest
 
 class AWSRequestTests: XCTestCase {
@@ -283,6 +284,105 @@ class AWSRequestTests: XCTestCase {
         XCTAssertEqual(element.xmlString, "<Payload xmlns=\"https://test.amazonaws.com/doc/2020-03-11/\"><number>5</number></Payload>")
     }
 
+    func testXMLPayload() throws {
+        struct Input: AWSEncodableShape {
+            public static let _xmlNamespace: String? = "https://test.amazonaws.com/doc/2020-03-11/"
+            let text: String
+            let values: [String]
+        }
+        let input = Input(text: "Tom & Jerry <cartoon>", values: (0..<1000).map { "Key\($0)" })
+        let xmlConfig = createServiceConfig(serviceProtocol: .restxml)
+        let request = try AWSRequest(operation: "Test", path: "/", httpMethod: .POST, input: input, configuration: xmlConfig)
+        guard case .xml(let element) = request.body else {
+            return XCTFail("Shouldn't get here")
+        }
+        let element2 = XML.Element(name: "Comment")
+        element2.addAttribute(XML.Node.attribute(withName: "type", stringValue: "test"))
+        element2.addChild(XML.Node.comment(stringValue: "comment"))
+        element.addChild(element2)
+
+        let buffer = try XCTUnwrap(request.body.asByteBuffer(byteBufferAllocator: ByteBufferAllocator()))
+        let xml = String(buffer: buffer)
+        XCTAssertEqual(xml, XML.Document(rootElement: element).xmlString)
+        XCTAssert(xml.hasPrefix("<?xml version=\"1.0\" encoding=\"UTF-8\"?><Input xmlns=\"https://test.amazonaws.com/doc/2020-03-11/\"><text>Tom &amp; Jerry &lt;cartoon&gt;</text><values>Key0</values>"))
+        XCTAssert(xml.hasSuffix("<Comment type=\"test\"><!--comment--></Comment></Input>"))
+    }
+
+    func testS3UnsignedPayloadAndTrailingChecksum() throws {
+        struct Input: AWSEncodableShape & AWSShapeWithPayload {
+            static var _payloadPath: String = "payload"
+            static var _payloadOptions: AWSShapePayloadOptions = [.allowStreaming, .raw]
+            let payload: AWSPayload
+            private enum CodingKeys: CodingKey {}
+        }
+        let data = createRandomBuffer(23, 4, size: 150 * 1024)
+        var byteBuffer = ByteBufferAllocator().buffer(capacity: data.count)
+        byteBuffer.writeBytes(data)
+        let config = createServiceConfig(region: .useast1, service: "s3", serviceProtocol: .restxml)
+        let request = try AWSRequest(operation: "PutObject", path: "/bucket/file", httpMethod: .PUT, input: Input(payload: .byteBuffer(byteBuffer)), configuration: config)
+        let signer = AWSSigner(credentials: StaticCredential(accessKeyId: "foo", secretAccessKey: "bar"), name: "s3", region: "us-east-1")
+
+        let unsignedRequest = request.createHTTPRequest(signer: signer, serviceOptions: .s3UnsignedPayload, byteBufferAllocator: ByteBufferAllocator())
+        XCTAssertEqual(unsignedRequest.headers["x-amz-content-sha256"].first, "UNSIGNED-PAYLOAD")
+        XCTAssertEqual(unsignedRequest.body.size, data.count)
+
+        let checksumRequest = request.createHTTPRequest(signer: signer, serviceOptions: .s3TrailingChecksum, byteBufferAllocator: ByteBufferAllocator())
+        XCTAssertEqual(checksumRequest.headers["x-amz-content-sha256"].first, "STREAMING-UNSIGNED-PAYLOAD-TRAILER")
+        XCTAssertEqual(checksumRequest.headers["x-amz-trailer"].first, "x-amz-checksum-crc32")
+        XCTAssertEqual(checksumRequest.headers["x-amz-decoded-content-length"].first, data.count.description)
+        XCTAssert(checksumRequest.headers["Authorization"].first?.contains("x-amz-trailer") == true)
+        guard case .stream(let reader) = checksumRequest.body.payload else { return XCTFail("Expected stream payload") }
+        XCTAssertEqual(reader.updateHeaders(headers: [:])["Content-Encoding"].first, "aws-chunked")
+
+        // read all chunks and verify size and content
+        let eventLoop = EmbeddedEventLoop()
+        var output = ByteBufferAllocator().buffer(capacity: reader.contentSize ?? 0)
+        while true {
+            var buffers = try reader.streamChunks(on: eventLoop).wait()
+            guard buffers.count > 0 else { break }
+            for index in buffers.indices {
+                output.writeBuffer(&buffers[index])
+            }
+        }
+        XCTAssertEqual(output.readableBytes, reader.contentSize)
+        var crc = CRC32()
+        data.withUnsafeBytes { crc.update($0) }
+        let body = String(decoding: output.readableBytesView, as: Unicode.UTF8.self)
+        XCTAssert(body.hasPrefix("10000\r\n"))
+        XCTAssert(body.hasSuffix("\r\n0\r\nx-amz-checksum-crc32:\(crc.base64Value)\r\n\r\n"))
+    }
+
+    func testCRC32() {
+        var crc = CRC32()
+        Array("123456789".utf8).withUnsafeBytes { crc.update($0) }
+        XCTAssertEqual(crc.value, 0xCBF4_3926)
+        XCTAssertEqual(crc.base64Value, "y/Q5Jg==")
+        // update in two parts
+        var crc2 = CRC32()
+        Array("1234".utf8).withUnsafeBytes { crc2.update($0) }
+        Array("56789".utf8).withUnsafeBytes { crc2.update($0) }
+        XCTAssertEqual(crc2.value, crc.value)
+    }
+
+    func testXMLPayloadEscapesQuotes() throws {
+        let value = "He said \"hello\" & 'goodbye' <twice>"
+        let element = XML.Element(name: "Test", stringValue: value)
+        element.addAttribute(XML.Node.attribute(withName: "quote", stringValue: value))
+
+        var buffer = ByteBufferAllocator().buffer(capacity: 0)
+        element.writeXML(to: &buffer)
+        let xml = String(buffer: buffer)
+        XCTAssertEqual(xml, element.xmlString)
+        XCTAssertEqual(
+            xml,
+            "<Test quote=\"He said &quot;hello&quot; &amp; &apos;goodbye&apos; &lt;twice&gt;\">He said &quot;hello&quot; &amp; &apos;goodbye&apos; &lt;twice&gt;</Test>"
+        )
+        // attribute and text survive a round trip through the parser
+        let parsed = try XML.Element(xmlString: xml)
+        XCTAssertEqual(parsed.attribute(forName: "quote")?.stringValue, value)
+        XCTAssertEqual(parsed.stringValue, value)
+    }
+
     func testDataInJsonPayload() {
         struct DataContainer: AWSEncodableShape {
             let data: Data
@@ -0,0 +1,111 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the Soto for AWS open source project
+//
+// Copyright (c) 2017-2020 the Soto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.txt for the list of Soto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Foundation
+import NIO
+@testable import SotoCore
+import SotoTestUtils
+import XCTest
+
+class AWSResponseCacheTests: XCTestCase {
+    struct Input: AWSEncodableShape & Decodable {
+        let name: String
+    }
+
+    struct Output: AWSDecodableShape & Encodable {
+        let value: String
+    }
+
+    let clientID = UUID()
+
+    func key(_ name: String, client: UUID? = nil, credential: String = "MYACCESSKEY") throws -> AWSResponseCache.Key {
+        let config = createServiceConfig()
+        let request = try AWSRequest(operation: "Get", path: "/", httpMethod: .POST, input: Input(name: name), configuration: config)
+        let key = try XCTUnwrap(SingleFlight.Key(request: request, outputType: Output.self, byteBufferAllocator: config.byteBufferAllocator))
+        return .init(client: client ?? self.clientID, credential: credential, request: key)
+    }
+
+    func testLeastRecentlyUsedEviction() throws {
+        let cache = AWSResponseCache(maxCount: 2, timeToLive: ["Get": .minutes(1)])
+        let key1 = try self.key("one")
+        let key2 = try self.key("two")
+        let key3 = try self.key("three")
+        cache.set(Output(value: "1"), for: key1, operation: "Get")
+        cache.set(Output(value: "2"), for: key2, operation: "Get")
+        // use key1 so key2 is the least recently used
+        XCTAssertEqual(cache.output(for: key1, type: Output.self)?.value, "1")
+        cache.set(Output(value: "3"), for: key3, operation: "Get")
+        XCTAssertEqual(cache.count, 2)
+        XCTAssertNil(cache.output(for: key2, type: Output.self))
+        XCTAssertEqual(cache.output(for: key1, type: Output.self)?.value, "1")
+        XCTAssertEqual(cache.output(for: key3, type: Output.self)?.value, "3")
+        // operations without a time to live are not cached
+        cache.set(Output(value: "4"), for: key2, operation: "Put")
+        XCTAssertNil(cache.output(for: key2, type: Output.self))
+    }
+
+    func testTimeToLive() throws {
+        let cache = AWSResponseCache(timeToLive: ["Get": .seconds(10)])
+        let key = try self.key("one")
+        let now = NIODeadline.now()
+        cache.set(Output(value: "1"), for: key, operation: "Get", now: now)
+        XCTAssertEqual(cache.output(for: key, type: Output.self, now: now + .seconds(9))?.value, "1")
+        XCTAssertNil(cache.output(for: key, type: Output.self, now: now + .seconds(11)))
+        XCTAssertEqual(cache.count, 0)
+    }
+
+    func testOutputsAreSeparatedByClientAndCredential() throws {
+        let cache = AWSResponseCache(timeToLive: ["Get": .minutes(1)])
+        let otherClient = UUID()
+        cache.set(Output(value: "1"), for: try self.key("one"), operation: "Get")
+        cache.set(Output(value: "2"), for: try self.key("one", client: otherClient), operation: "Get")
+        XCTAssertNil(cache.output(for: try self.key("one", credential: "OTHERACCESSKEY"), type: Output.self))
+        XCTAssertEqual(cache.output(for: try self.key("one"), type: Output.self)?.value, "1")
+        XCTAssertEqual(cache.output(for: try self.key("one", client: otherClient), type: Output.self)?.value, "2")
+        // removing a client's outputs leaves the other client's outputs in place
+        cache.removeAll(client: self.clientID)
+        XCTAssertEqual(cache.count, 1)
+        XCTAssertNil(cache.output(for: try self.key("one"), type: Output.self))
+        XCTAssertEqual(cache.output(for: try self.key("one", client: otherClient), type: Output.self)?.value, "2")
+    }
+
+    func testClientUsesCache() {
+        do {
+            let eventLoopGroup = MultiThreadedEventLoopGroup(numberOfThreads: 1)
+            defer { XCTAssertNoThrow(try eventLoopGroup.syncShutdownGracefully()) }
+            let awsServer = AWSTestServer(serviceProtocol: .json)
+            let cache = AWSResponseCache(timeToLive: ["Get": .minutes(1)])
+            let config = createServiceConfig(serviceProtocol: .json(version: "1.1"), endpoint: awsServer.address)
+                .with(patch: .init(responseCache: cache))
+            let client = createAWSClient(credentialProvider: .empty, httpClientProvider: .createNewWithEventLoopGroup(eventLoopGroup))
+            defer { XCTAssertNoThrow(try awsServer.stop()) }
+            let response: EventLoopFuture<Output> = client.execute(operation: "Get", path: "/", httpMethod: .POST, serviceConfig: config, input: Input(name: "param"), logger: TestEnvironment.logger)
+            try awsServer.process { (input: Input) -> AWSTestServer.Result<Output> in
+                return .result(Output(value: input.name))
+            }
+            XCTAssertEqual(try response.wait().value, "param")
+            XCTAssertEqual(cache.count, 1)
+
+            // second request is served from the cache without reaching the server
+            let response2: EventLoopFuture<Output> = client.execute(operation: "Get", path: "/", httpMethod: .POST, serviceConfig: config, input: Input(name: "param"), logger: TestEnvironment.logger)
+            XCTAssertEqual(try response2.wait().value, "param")
+
+            // shutting down the client removes its outputs from the cache
+            try client.syncShutdown()
+            XCTAssertEqual(cache.count, 0)
+        } catch {
+            XCTFail("Unexpected error: \(error)")
+        }
+    }
+}
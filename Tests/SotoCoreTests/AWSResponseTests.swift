@@ -197,6 +197,85 @@ class AWSResponseTests: XCTestCase {
         XCTAssertEqual(output?.name, "hello")
     }
 
+    func testValidateJSONResponseWithNonObjectBody() {
+        struct Output: AWSDecodableShape {
+            static let _encoding = [
+                AWSMemberEncoding(label: "requestId", location: .header(locationName: "x-amz-request-id")),
+            ]
+            let name: String?
+            let requestId: String
+
+            private enum CodingKeys: String, CodingKey {
+                case name
+                case requestId = "x-amz-request-id"
+            }
+        }
+        // a body that isn't a JSON object is decoded as an empty object
+        let response = AWSHTTPResponseImpl(
+            status: .ok,
+            headers: ["X-Amz-Request-Id": "1234"],
+            bodyData: Data("[1, 2]".utf8)
+        )
+
+        var awsResponse: AWSResponse?
+        var output: Output?
+        XCTAssertNoThrow(awsResponse = try AWSResponse(from: response, serviceProtocol: .json(version: "1.1"), raw: false))
+        XCTAssertNoThrow(output = try awsResponse?.generateOutputShape(operation: "Test"))
+        XCTAssertNil(output?.name)
+        XCTAssertEqual(output?.requestId, "1234")
+    }
+
+    func testValidateJSONResponseWithHeadersAndStatusCode() {
+        struct Item: AWSDecodableShape {
+            let id: Int
+            let tags: [String]
+        }
+        struct Output: AWSDecodableShape {
+            static let _encoding = [
+                AWSMemberEncoding(label: "requestId", location: .header(locationName: "x-amz-request-id")),
+                AWSMemberEncoding(label: "count", location: .header(locationName: "x-count")),
+                AWSMemberEncoding(label: "date", location: .header(locationName: "Last-Modified")),
+                AWSMemberEncoding(label: "status", location: .statusCode),
+            ]
+            let items: [Item]
+            let created: Date
+            let requestId: String
+            let count: Int?
+            let missing: String?
+            @OptionalCustomCoding<HTTPHeaderDateCoder>
+            var date: Date?
+            let status: Int
+
+            private enum CodingKeys: String, CodingKey {
+                case items
+                case created
+                case requestId = "x-amz-request-id"
+                case count = "x-count"
+                case missing = "x-missing"
+                case date = "Last-Modified"
+                case status
+            }
+        }
+        let response = AWSHTTPResponseImpl(
+            status: .accepted,
+            headers: ["X-Amz-Request-Id": "1234", "x-count": "2", "Last-Modified": "Tue, 15 Nov 1994 12:45:26 GMT"],
+            bodyData: Data("{\"items\":[{\"id\":1,\"tags\":[\"a\"]},{\"id\":2,\"tags\":[]}],\"created\":784903526}".utf8)
+        )
+
+        var awsResponse: AWSResponse?
+        var output: Output?
+        XCTAssertNoThrow(awsResponse = try AWSResponse(from: response, serviceProtocol: .restjson, raw: false))
+        XCTAssertNoThrow(output = try awsResponse?.generateOutputShape(operation: "Test"))
+        XCTAssertEqual(output?.items.map { $0.id }, [1, 2])
+        XCTAssertEqual(output?.items.first?.tags, ["a"])
+        XCTAssertEqual(output?.created, Date(timeIntervalSince1970: 784_903_526))
+        XCTAssertEqual(output?.requestId, "1234")
+        XCTAssertEqual(output?.count, 2)
+        XCTAssertNil(output?.missing)
+        XCTAssertEqual(output?.date, Date(timeIntervalSince1970: 784_903_526))
+        XCTAssertEqual(output?.status, 202)
+    }
+
     func testValidateJSONCodablePayloadResponse() {
         class Output2: AWSDecodableShape {
             let name: String
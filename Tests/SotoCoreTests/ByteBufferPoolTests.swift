@@ -0,0 +1,103 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the Soto for AWS open source project
+//
+// Copyright (c) 2017-2020 the Soto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.txt for the list of Soto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import NIO
+@testable import SotoCore
+import XCTest
+
+class ByteBufferPoolTests: XCTestCase {
+    func testBorrowAndGiveBack() throws {
+        let eventLoop = EmbeddedEventLoop()
+        let pool = ByteBufferPool(maximumBytes: 64 * 1024)
+        var loan = try pool.borrow(capacity: 16 * 1024, on: eventLoop).wait()
+        XCTAssertGreaterThanOrEqual(loan.buffer.capacity, 16 * 1024)
+        XCTAssertEqual(loan.charge, loan.buffer.capacity)
+        XCTAssertEqual(pool.borrowedBytes, loan.charge)
+        loan.buffer.writeString("Hello")
+        pool.giveBack(loan)
+        XCTAssertEqual(pool.availableCount, 1)
+        XCTAssertEqual(pool.borrowedBytes, 0)
+        // reuses the buffer returned
+        let loan2 = try pool.borrow(capacity: 8 * 1024, on: eventLoop).wait()
+        XCTAssertEqual(loan2.buffer.readableBytes, 0)
+        XCTAssertEqual(pool.availableCount, 0)
+        XCTAssertEqual(pool.allocatedBytes, loan.charge)
+    }
+
+    func testWaitForBuffer() throws {
+        let eventLoop = EmbeddedEventLoop()
+        let pool = ByteBufferPool(maximumBytes: 32 * 1024)
+        let loan = try pool.borrow(capacity: 32 * 1024, on: eventLoop).wait()
+        var waitingLoan: ByteBufferPool.Loan?
+        pool.borrow(capacity: 16 * 1024, on: eventLoop).whenSuccess { waitingLoan = $0 }
+        eventLoop.run()
+        XCTAssertNil(waitingLoan)
+        pool.giveBack(loan)
+        eventLoop.run()
+        XCTAssertNotNil(waitingLoan)
+        XCTAssertLessThanOrEqual(pool.allocatedBytes, pool.maximumBytes)
+    }
+
+    func testFreeSmallBuffersForLargerBorrow() throws {
+        let eventLoop = EmbeddedEventLoop()
+        let pool = ByteBufferPool(maximumBytes: 32 * 1024)
+        let loan = try pool.borrow(capacity: 16 * 1024, on: eventLoop).wait()
+        pool.giveBack(loan)
+        // available buffer is too small so it is freed to make room for the larger one
+        let loan2 = try pool.borrow(capacity: 24 * 1024, on: eventLoop).wait()
+        XCTAssertGreaterThanOrEqual(loan2.buffer.capacity, 24 * 1024)
+        XCTAssertEqual(pool.availableCount, 0)
+        XCTAssertEqual(pool.allocatedBytes, loan2.charge)
+        XCTAssertLessThanOrEqual(pool.allocatedBytes, pool.maximumBytes)
+        // buffers larger than the pool are allocated outside of it
+        let largeLoan = try pool.borrow(capacity: 64 * 1024, on: eventLoop).wait()
+        XCTAssertEqual(largeLoan.charge, 0)
+        pool.giveBack(largeLoan)
+        XCTAssertEqual(pool.availableCount, 0)
+        XCTAssertEqual(pool.allocatedBytes, loan2.charge)
+    }
+
+    func testGiveBackGrownBuffer() throws {
+        let eventLoop = EmbeddedEventLoop()
+        let pool = ByteBufferPool(maximumBytes: 64 * 1024)
+        var loan = try pool.borrow(capacity: 16 * 1024, on: eventLoop).wait()
+        // writing past the end of the buffer reallocates it, so it is no longer the size the pool charged for
+        loan.buffer.writeBytes([UInt8](repeating: 0, count: 48 * 1024))
+        pool.giveBack(loan)
+        XCTAssertEqual(pool.availableCount, 0)
+        XCTAssertEqual(pool.allocatedBytes, 0)
+        XCTAssertEqual(pool.borrowedBytes, 0)
+    }
+
+    func testAllocatedBytesNeverExceedsMaximum() throws {
+        let eventLoop = EmbeddedEventLoop()
+        // capacity that isn't a power of two, in case the allocator rounds it up
+        let capacity = 24 * 1024 + 1
+        let pool = ByteBufferPool(maximumBytes: 3 * capacity)
+        var loans: [ByteBufferPool.Loan] = []
+        for _ in 0..<8 {
+            pool.borrow(capacity: capacity, on: eventLoop).whenSuccess { loans.append($0) }
+        }
+        eventLoop.run()
+        XCTAssertGreaterThan(loans.count, 0)
+        XCTAssertLessThan(loans.count, 8)
+        XCTAssertLessThanOrEqual(pool.allocatedBytes, pool.maximumBytes)
+        while let loan = loans.popLast() {
+            pool.giveBack(loan)
+            eventLoop.run()
+            XCTAssertLessThanOrEqual(pool.allocatedBytes, pool.maximumBytes)
+        }
+        XCTAssertEqual(pool.borrowedBytes, 0)
+    }
+}
@@ -703,6 +703,59 @@ class ConfigFileLoadersTests: XCTestCase {
         }
     }
 
+    // MARK: - INI file scanning
+
+    func testINIFileSections() throws {
+        let content = "; comment\r\nfree = 1\r\n[default]\r\nregion = us-east-1 # comment\r\n\r\n[other]\r\nkey = \"a b\"\r\n[empty]\r\n"
+        var byteBuffer = ByteBufferAllocator().buffer(capacity: content.utf8.count)
+        byteBuffer.writeString(content)
+        let file = INIFile(byteBuffer)
+
+        XCTAssertEqual(try file.section("default"), ["region": "us-east-1"])
+        XCTAssertEqual(try file.sections(["other", "missing"]), ["other": ["key": "\"a b\""]])
+        // sections without settings are not returned
+        XCTAssertNil(try file.section("empty"))
+    }
+
+    func testINIFileInvalidSyntaxOutsideSection() {
+        let content = """
+        [default]
+        region = us-east-1
+        [other
+        """
+        var byteBuffer = ByteBufferAllocator().buffer(capacity: content.utf8.count)
+        byteBuffer.writeString(content)
+
+        XCTAssertThrowsError(try INIFile(byteBuffer).section("default")) { error in
+            XCTAssertEqual(error as? INIFile.Error, .invalidSyntax)
+        }
+    }
+
+    func testConfigFileCache() throws {
+        let path = try save(content: "[default]\nregion = us-east-1\n", prefix: "config")
+        let threadPool = NIOThreadPool(numberOfThreads: 1)
+        threadPool.start()
+        let eventLoopGroup = MultiThreadedEventLoopGroup(numberOfThreads: 1)
+        defer {
+            try? FileManager.default.removeItem(atPath: path)
+            XCTAssertNoThrow(try threadPool.syncShutdownGracefully())
+            XCTAssertNoThrow(try eventLoopGroup.syncShutdownGracefully())
+        }
+        let fileIO = NonBlockingFileIO(threadPool: threadPool)
+        let eventLoop = eventLoopGroup.next()
+        let cache = ConfigFileCache()
+
+        let file = try cache.file(path: path, on: eventLoop, threadPool: threadPool, using: fileIO).wait()
+        let file2 = try cache.file(path: path, on: eventLoop, threadPool: threadPool, using: fileIO).wait()
+        XCTAssert(file === file2)
+
+        // file is loaded again once it has changed
+        try "[default]\nregion = eu-west-1\n".write(toFile: path, atomically: true, encoding: .utf8)
+        let file3 = try cache.file(path: path, on: eventLoop, threadPool: threadPool, using: fileIO).wait()
+        XCTAssert(file !== file3)
+        XCTAssertEqual(try file3.section("default"), ["region": "eu-west-1"])
+    }
+
     // MARK: - Config file path expansion
 
     func testExpandTildeInFilePath() {
@@ -35,6 +35,19 @@ class RotatingCredentialProviderTests: XCTestCase {
         }
     }
 
+    /// Credential provider returning the future from its callback directly, so it can already be complete
+    class ImmediateTestClient: CredentialProvider {
+        let callback: (EventLoop) -> EventLoopFuture<ExpiringCredential>
+
+        init(_ callback: @escaping (EventLoop) -> EventLoopFuture<ExpiringCredential>) {
+            self.callback = callback
+        }
+
+        func getCredential(on eventLoop: EventLoop, logger: Logger) -> EventLoopFuture<Credential> {
+            self.callback(eventLoop).map { $0 }
+        }
+    }
+
     func testGetCredentialAndReuseIfStillValid() {
         let group = MultiThreadedEventLoopGroup(numberOfThreads: 1)
         defer { XCTAssertNoThrow(try group.syncShutdownGracefully()) }
@@ -172,6 +185,102 @@ class RotatingCredentialProviderTests: XCTestCase {
         // ensure callback was only hit once
         XCTAssertEqual(hitCount, iterations)
     }
+
+    func testBackgroundRefresh() {
+        let group = MultiThreadedEventLoopGroup(numberOfThreads: 1)
+        defer { XCTAssertNoThrow(try group.syncShutdownGracefully()) }
+        let httpClient = HTTPClient(eventLoopGroupProvider: .shared(group))
+        defer { XCTAssertNoThrow(try httpClient.syncShutdown()) }
+        // background refreshes are scheduled on the provider's EventLoop, so time can be moved forward
+        let loop = EmbeddedEventLoop()
+
+        let hitCount = NIOAtomic<Int>.makeAtomic(value: 0)
+        let client = ImmediateTestClient { eventLoop in
+            let count = hitCount.add(1) + 1
+            // second refresh fails, and is retried in the background
+            if count == 2 {
+                return eventLoop.makeFailedFuture(CredentialProviderError.noProvider)
+            }
+            let cred = TestExpiringCredential(
+                accessKeyId: "key\(count)",
+                secretAccessKey: "abc123",
+                expiration: Date(timeIntervalSinceNow: 60 * 60)
+            )
+            return eventLoop.makeSucceededFuture(cred)
+        }
+        let context = CredentialProviderFactory.Context(httpClient: httpClient, eventLoop: loop, logger: TestEnvironment.logger, options: .init())
+        // refresh a second after getting credentials
+        let provider = RotatingCredentialProvider(context: context, provider: client, backgroundRefreshMargin: 60 * 60 - 1)
+        defer { XCTAssertNoThrow(try provider.shutdown(on: loop).wait()) }
+        var credential: Credential?
+        XCTAssertNoThrow(credential = try provider.getCredential(on: loop, logger: TestEnvironment.logger).wait())
+        XCTAssertEqual(credential?.accessKeyId, "key1")
+        XCTAssertEqual(hitCount.load(), 1)
+
+        // background refresh fails after a second, and is retried within another second
+        loop.advanceTime(by: .seconds(1))
+        XCTAssertEqual(hitCount.load(), 2)
+        XCTAssertNoThrow(credential = try provider.getCredential(on: loop, logger: TestEnvironment.logger).wait())
+        XCTAssertEqual(credential?.accessKeyId, "key1")
+        loop.advanceTime(by: .seconds(1))
+        XCTAssertEqual(hitCount.load(), 3)
+
+        // request gets the new credential without waiting on a refresh
+        XCTAssertNoThrow(credential = try provider.getCredential(on: loop, logger: TestEnvironment.logger).wait())
+        XCTAssertEqual(credential?.accessKeyId, "key3")
+        XCTAssertEqual(hitCount.load(), 3)
+    }
+
+    func testBackgroundRefreshBacksOffForExpiredCredential() {
+        let group = MultiThreadedEventLoopGroup(numberOfThreads: 1)
+        defer { XCTAssertNoThrow(try group.syncShutdownGracefully()) }
+        let httpClient = HTTPClient(eventLoopGroupProvider: .shared(group))
+        defer { XCTAssertNoThrow(try httpClient.syncShutdown()) }
+        let loop = EmbeddedEventLoop()
+
+        let hitCount = NIOAtomic<Int>.makeAtomic(value: 0)
+        // provider keeps returning a credential that has already expired
+        let client = ImmediateTestClient { eventLoop in
+            _ = hitCount.add(1)
+            let cred = TestExpiringCredential(accessKeyId: "key", secretAccessKey: "abc123", expiration: Date(timeIntervalSinceNow: -1))
+            return eventLoop.makeSucceededFuture(cred)
+        }
+        let context = CredentialProviderFactory.Context(httpClient: httpClient, eventLoop: loop, logger: TestEnvironment.logger, options: .init())
+        let provider = RotatingCredentialProvider(context: context, provider: client, backgroundRefreshMargin: 60)
+        defer { XCTAssertNoThrow(try provider.shutdown(on: loop).wait()) }
+        XCTAssertEqual(hitCount.load(), 1)
+
+        // refreshes back off 1, 2, 4 ... seconds instead of running every second
+        for _ in 0..<60 {
+            loop.advanceTime(by: .seconds(1))
+        }
+        XCTAssertGreaterThan(hitCount.load(), 1)
+        XCTAssertLessThanOrEqual(hitCount.load(), 8)
+    }
+
+    func testFailedRefreshIsRetried() {
+        let group = MultiThreadedEventLoopGroup(numberOfThreads: 1)
+        defer { XCTAssertNoThrow(try group.syncShutdownGracefully()) }
+        let httpClient = HTTPClient(eventLoopGroupProvider: .shared(group))
+        defer { XCTAssertNoThrow(try httpClient.syncShutdown()) }
+        let loop = EmbeddedEventLoop()
+
+        let hitCount = NIOAtomic<Int>.makeAtomic(value: 0)
+        // first refresh fails straight away, returning a future that is already complete
+        let client = ImmediateTestClient { eventLoop in
+            if hitCount.add(1) == 0 {
+                return eventLoop.makeFailedFuture(CredentialProviderError.noProvider)
+            }
+            return eventLoop.makeSucceededFuture(TestExpiringCredential(accessKeyId: "key", secretAccessKey: "abc123"))
+        }
+        let context = CredentialProviderFactory.Context(httpClient: httpClient, eventLoop: loop, logger: TestEnvironment.logger, options: .init())
+        let provider = RotatingCredentialProvider(context: context, provider: client)
+        defer { XCTAssertNoThrow(try provider.shutdown(on: loop).wait()) }
+        var credential: Credential?
+        XCTAssertNoThrow(credential = try provider.getCredential(on: loop, logger: TestEnvironment.logger).wait())
+        XCTAssertEqual(credential?.accessKeyId, "key")
+        XCTAssertEqual(hitCount.load(), 2)
+    }
 }
 
 /// Provide AWS credentials directly
@@ -194,4 +303,8 @@ struct TestExpiringCredential: ExpiringCredential {
         }
         return false
     }
+
+    var expirationDate: Date? {
+        return self.expiration
+    }
 }
@@ -14,6 +14,7 @@
 
 import AsyncHTTPClient
 import NIO
+import NIOConcurrencyHelpers
 @testable import SotoCore
 import SotoTestUtils
 import XCTest
@@ -123,6 +124,90 @@ class PaginateTests: XCTestCase {
         }
     }
 
+    func testIntegerTokenPaginateWithPrefetch() throws {
+        let eventLoop = self.eventLoopGroup.next()
+        var finalArray: [Int] = []
+        var requested = 0
+        var processed = 0
+        var maxPagesAhead = 0
+        let input = CounterInput(inputToken: nil, pageSize: 4)
+        let future = self.client.paginate(
+            input: input,
+            command: { input, logger, eventLoop in
+                requested += 1
+                return self.counter(input, logger: logger, on: eventLoop)
+            },
+            tokenKey: \CounterOutput.outputToken,
+            prefetch: 2,
+            logger: TestEnvironment.logger,
+            on: eventLoop
+        ) { result, eventLoop in
+            processed += 1
+            finalArray.append(contentsOf: result.array)
+            // slow page processing so requests are sent ahead of it
+            return eventLoop.scheduleTask(in: .milliseconds(5)) { () -> Bool in
+                maxPagesAhead = max(maxPagesAhead, requested - processed)
+                return true
+            }.futureResult
+        }
+
+        let arraySize = 23
+        XCTAssertNoThrow(try self.awsServer.process { (input: CounterInput) throws -> AWSTestServer.Result<CounterOutput> in
+            let startIndex = input.inputToken ?? 0
+            let endIndex = min(startIndex + input.pageSize, arraySize)
+            let output = CounterOutput(array: Array(startIndex..<endIndex), outputToken: endIndex != arraySize ? endIndex : nil)
+            return .result(output, continueProcessing: endIndex != arraySize)
+        })
+
+        XCTAssertNoThrow(try future.wait())
+        XCTAssertEqual(finalArray, Array(0..<arraySize))
+        XCTAssertEqual(requested, 6)
+        // next request is sent while a page is being processed, but never more than `prefetch` pages ahead
+        XCTAssertGreaterThan(maxPagesAhead, 0)
+        XCTAssertLessThanOrEqual(maxPagesAhead, 2)
+    }
+
+    func testPartitionedPaginate() throws {
+        let eventLoop = self.eventLoopGroup.next()
+        let lock = Lock()
+        var requestsInFlight = 0
+        var maxRequestsInFlight = 0
+        var requestEventLoops = Set<ObjectIdentifier>()
+        // each partition is a range of 10 integers starting at its input token
+        let partitions = (0..<6).map { CounterInput(inputToken: $0 * 100, pageSize: 4) }
+        let future = self.client.paginate(
+            partitions: partitions,
+            initialValue: [Int](),
+            command: { (input: CounterInput, _, requestEventLoop: EventLoop?) -> EventLoopFuture<CounterOutput> in
+                let requestEventLoop = requestEventLoop!
+                lock.withLockVoid {
+                    requestsInFlight += 1
+                    maxRequestsInFlight = max(maxRequestsInFlight, requestsInFlight)
+                    requestEventLoops.insert(ObjectIdentifier(requestEventLoop))
+                }
+                let startIndex = input.inputToken!
+                let endIndex = min(startIndex + input.pageSize, (startIndex / 100) * 100 + 10)
+                return requestEventLoop.scheduleTask(in: .milliseconds(2)) { () -> CounterOutput in
+                    lock.withLockVoid { requestsInFlight -= 1 }
+                    return CounterOutput(array: Array(startIndex..<endIndex), outputToken: endIndex % 100 != 10 ? endIndex : nil)
+                }.futureResult
+            },
+            tokenKey: \CounterOutput.outputToken,
+            maxConcurrentPartitions: 3,
+            logger: TestEnvironment.logger,
+            on: eventLoop
+        ) { current, result, pageEventLoop in
+            XCTAssertTrue(eventLoop.inEventLoop)
+            XCTAssertTrue(eventLoop === pageEventLoop)
+            return pageEventLoop.makeSucceededFuture((true, current + result.array))
+        }
+
+        let result = try future.wait()
+        XCTAssertEqual(result.sorted(), (0..<6).flatMap { Array(($0 * 100)..<($0 * 100 + 10)) })
+        XCTAssertLessThanOrEqual(maxRequestsInFlight, 3)
+        XCTAssertGreaterThan(requestEventLoops.count, 1)
+    }
+
     // test structures/functions
     struct StringListInput: AWSEncodableShape, AWSPaginateToken, Decodable {
         let inputToken: String?
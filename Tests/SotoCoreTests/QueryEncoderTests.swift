@@ -12,6 +12,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+import NIO
 @testable import SotoCore
 import SotoTestUtils
 import XCTest
@@ -23,6 +24,8 @@ class QueryEncoderTests: XCTestCase {
         do {
             let query2 = try QueryEncoder().encode(value)
             XCTAssertEqual(query2, query)
+            let buffer = try QueryEncoder().encode(value, byteBufferAllocator: ByteBufferAllocator())
+            XCTAssertEqual(buffer.map { String(buffer: $0) }, query)
         } catch {
             XCTFail("\(error)")
         }
@@ -213,4 +216,26 @@ class QueryEncoderTests: XCTestCase {
             XCTFail("\(error)")
         }
     }
+
+    func testAdditionalKeysAndPercentEncoding() {
+        struct Test: AWSEncodableShape {
+            let values: [[String]]
+            let name: String?
+
+            private enum CodingKeys: String, CodingKey {
+                case values = "Values"
+                case name = "Name"
+            }
+        }
+        do {
+            let value = Test(values: [["a b", "c&d"], ["é"]], name: nil)
+            var queryEncoder = QueryEncoder()
+            queryEncoder.additionalKeys = ["Action": "Test", "Version": "2020-01-01"]
+            let query = try queryEncoder.encode(value)
+
+            XCTAssertEqual(query, "Action=Test&Values.11=a%20b&Values.12=c%26d&Values.21=%C3%A9&Version=2020-01-01")
+        } catch {
+            XCTFail("\(error)")
+        }
+    }
 }
@@ -0,0 +1,200 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the Soto for AWS open source project
+//
+// Copyright (c) 2020 the Soto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.txt for the list of Soto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import AsyncHTTPClient
+import NIO
+import NIOConcurrencyHelpers
+@testable import SotoCore
+import SotoTestUtils
+import XCTest
+
+class RetryQuotaTests: XCTestCase {
+    func testRetryQuota() {
+        let quota = RetryQuota(capacity: 12)
+        XCTAssertEqual(quota.acquire(cost: RetryQuota.retryCost), 5)
+        XCTAssertEqual(quota.acquire(cost: RetryQuota.retryCost), 5)
+        XCTAssertNil(quota.acquire(cost: RetryQuota.retryCost))
+        quota.release(RetryQuota.noRetryIncrement)
+        XCTAssertEqual(quota.availableCapacity, 3)
+        // quota is never filled past its initial capacity
+        quota.release(RetryQuota.initialCapacity)
+        XCTAssertEqual(quota.availableCapacity, 12)
+    }
+
+    func testRateLimiterOnlyEnabledAfterThrottle() {
+        let rateLimiter = ClientRateLimiter(now: 0)
+        // send at 10 requests a second
+        for i in 0..<20 {
+            XCTAssertNil(rateLimiter.acquire(now: Double(i) / 10))
+            rateLimiter.update(isThrottle: false, now: Double(i) / 10)
+        }
+        XCTAssertFalse(rateLimiter.isEnabled)
+
+        rateLimiter.update(isThrottle: true, now: 2)
+        XCTAssertTrue(rateLimiter.isEnabled)
+        // rate is cut below the measured rate
+        let throttledRate = rateLimiter.sendingRate
+        XCTAssertLessThan(throttledRate, 10)
+        XCTAssertGreaterThan(throttledRate, 0)
+
+        // requests sent at the same time queue up behind each other
+        let wait1 = rateLimiter.acquire(now: 2)
+        let wait2 = rateLimiter.acquire(now: 2)
+        XCTAssertNotNil(wait1)
+        XCTAssertGreaterThan(wait2 ?? 0, wait1 ?? 0)
+    }
+
+    func testRateLimiterRecoversAfterThrottle() {
+        let rateLimiter = ClientRateLimiter(now: 0)
+        for i in 0..<20 {
+            rateLimiter.update(isThrottle: false, now: Double(i) / 10)
+        }
+        rateLimiter.update(isThrottle: true, now: 2)
+        let throttledRate = rateLimiter.sendingRate
+        // rate grows back while requests succeed
+        for i in 21..<100 {
+            rateLimiter.update(isThrottle: false, now: Double(i) / 10)
+        }
+        XCTAssertGreaterThan(rateLimiter.sendingRate, throttledRate)
+    }
+
+    func testThrottleErrors() {
+        let context = AWSErrorContext(message: "", responseCode: .badRequest, headers: [:])
+        XCTAssertTrue(TokenBucketRetry.isThrottle(AWSResponseError(errorCode: "ThrottlingException", context: context)))
+        XCTAssertFalse(TokenBucketRetry.isThrottle(AWSResponseError(errorCode: "AccessDenied", context: context)))
+        let context429 = AWSErrorContext(message: "", responseCode: .tooManyRequests, headers: [:])
+        XCTAssertTrue(TokenBucketRetry.isThrottle(AWSResponseError(errorCode: "AccessDenied", context: context429)))
+    }
+
+    func testClientStopsRetryingWhenQuotaEmpty() {
+        let quota = RetryQuota(capacity: RetryQuota.retryCost)
+        let retryPolicy = TokenBucketRetry(base: .milliseconds(10), maxRetries: 4, rateLimiting: true, quota: quota)
+        do {
+            let httpClient = AsyncHTTPClient.HTTPClient(eventLoopGroupProvider: .createNew)
+            let awsServer = AWSTestServer(serviceProtocol: .json)
+            let config = createServiceConfig(serviceProtocol: .json(version: "1.1"), endpoint: awsServer.address)
+            let client = createAWSClient(credentialProvider: .empty, retryPolicy: .init(retryPolicy: retryPolicy), httpClientProvider: .shared(httpClient))
+            defer {
+                XCTAssertNoThrow(try awsServer.stop())
+                XCTAssertNoThrow(try client.syncShutdown())
+                XCTAssertNoThrow(try httpClient.syncShutdown())
+            }
+            let response = client.execute(operation: "test", path: "/", httpMethod: .POST, serviceConfig: config, logger: TestEnvironment.logger)
+
+            // quota only has enough tokens for one retry
+            var count = 0
+            try awsServer.processRaw { _ in
+                count += 1
+                return .error(.internal, continueProcessing: count < 2)
+            }
+
+            try response.wait()
+            XCTFail("Request should have failed")
+        } catch let error as AWSServerError where error == .internalFailure {
+            XCTAssertEqual(quota.availableCapacity, 0)
+        } catch {
+            XCTFail("Unexpected error: \(error)")
+        }
+    }
+
+    func testClientRefillsQuota() {
+        let quota = RetryQuota(capacity: 100)
+        let retryPolicy = TokenBucketRetry(base: .milliseconds(10), maxRetries: 4, rateLimiting: false, quota: quota)
+        do {
+            let httpClient = AsyncHTTPClient.HTTPClient(eventLoopGroupProvider: .createNew)
+            let awsServer = AWSTestServer(serviceProtocol: .json)
+            let config = createServiceConfig(serviceProtocol: .json(version: "1.1"), endpoint: awsServer.address)
+            let client = createAWSClient(credentialProvider: .empty, retryPolicy: .init(retryPolicy: retryPolicy), httpClientProvider: .shared(httpClient))
+            defer {
+                XCTAssertNoThrow(try awsServer.stop())
+                XCTAssertNoThrow(try client.syncShutdown())
+                XCTAssertNoThrow(try httpClient.syncShutdown())
+            }
+            let response = client.execute(operation: "test", path: "/", httpMethod: .POST, serviceConfig: config, logger: TestEnvironment.logger)
+
+            var count = 0
+            try awsServer.processRaw { _ in
+                count += 1
+                if count < 2 {
+                    return .error(.serviceUnavailable, continueProcessing: true)
+                } else {
+                    return .result(.ok)
+                }
+            }
+
+            try response.wait()
+            // tokens taken by the retry are returned when it succeeds
+            XCTAssertEqual(quota.availableCapacity, 100)
+        } catch {
+            XCTFail("Unexpected error: \(error)")
+        }
+    }
+
+    /// Retry policy that retries every error once, refuses to send the retry and records the attempts completed
+    final class RefusingRetryPolicy: RetryQuotaPolicy {
+        struct RefusedError: Error {}
+
+        var waitCount = 0
+        var completedErrors: [Error?] = []
+        private let lock = Lock()
+
+        func getRetryWaitTime(error: Error, attempt: Int) -> RetryStatus? {
+            return attempt == 0 ? .retry(wait: .milliseconds(1)) : .dontRetry
+        }
+
+        func waitToSend(service: String, on eventLoop: EventLoop) -> EventLoopFuture<Void> {
+            let waitCount: Int = self.lock.withLock {
+                self.waitCount += 1
+                return self.waitCount
+            }
+            return waitCount == 1 ? eventLoop.makeSucceededFuture(()) : eventLoop.makeFailedFuture(RefusedError())
+        }
+
+        func attemptCompleted(service: String, error: Error?) {
+            self.lock.withLockVoid { self.completedErrors.append(error) }
+        }
+
+        func acquireRetryTokens(error: Error) -> Int? {
+            return 0
+        }
+
+        func releaseRetryTokens(_ tokens: Int?) {}
+    }
+
+    func testClientCompletesAttemptsWithoutResponse() {
+        let retryPolicy = RefusingRetryPolicy()
+        do {
+            let httpClient = AsyncHTTPClient.HTTPClient(eventLoopGroupProvider: .createNew)
+            // nothing is listening on the address once the server has stopped, so the request fails to connect
+            let awsServer = AWSTestServer(serviceProtocol: .json)
+            let config = createServiceConfig(serviceProtocol: .json(version: "1.1"), endpoint: awsServer.address)
+            try awsServer.stop()
+            let client = createAWSClient(credentialProvider: .empty, retryPolicy: .init(retryPolicy: retryPolicy), httpClientProvider: .shared(httpClient))
+            defer {
+                XCTAssertNoThrow(try client.syncShutdown())
+                XCTAssertNoThrow(try httpClient.syncShutdown())
+            }
+            let response = client.execute(operation: "test", path: "/", httpMethod: .POST, serviceConfig: config, logger: TestEnvironment.logger)
+            // the retry is refused by waitToSend, which fails the request
+            XCTAssertThrowsError(try response.wait()) { error in
+                XCTAssert(error is RefusingRetryPolicy.RefusedError, "Unexpected error: \(error)")
+            }
+            XCTAssertEqual(retryPolicy.waitCount, 2)
+            XCTAssertEqual(retryPolicy.completedErrors.count, 1)
+            XCTAssertNotNil(retryPolicy.completedErrors.first ?? nil)
+        } catch {
+            XCTFail("Unexpected error: \(error)")
+        }
+    }
+}
@@ -203,6 +203,39 @@ class TimeStampTests: XCTestCase {
         XCTAssertEqual(request?.body.asString(), "{\"date\":23983978378}")
     }
 
+    func testTimestampFormatsMatchDateFormatter() {
+        let httpDateFormatter = DateFormatter()
+        httpDateFormatter.locale = Locale(identifier: "en_US_POSIX")
+        httpDateFormatter.dateFormat = "EEE, d MMM yyy HH:mm:ss z"
+        httpDateFormatter.timeZone = TimeZone(secondsFromGMT: 0)
+        // includes dates before 1970, leap days and the end of a century
+        let times: [Double] = [0, -1, -86_399.5, 951_782_400, 951_868_799.5, 1_582_934_400.25, 4_107_542_399.75, 23_984_978_378.125]
+        for time in times {
+            let date = Date(timeIntervalSince1970: time)
+            XCTAssertEqual(TimestampFormat.iso8601WithFractionalSeconds.string(from: date), self.dateFormatter.string(from: date))
+            XCTAssertEqual(TimestampFormat.httpDate.string(from: date), httpDateFormatter.string(from: date))
+
+            let iso8601String = self.dateFormatter.string(from: date)
+            XCTAssertEqual(TimestampFormat.iso8601WithFractionalSeconds.date(from: iso8601String), self.dateFormatter.date(from: iso8601String))
+            let httpDateString = httpDateFormatter.string(from: date)
+            XCTAssertEqual(TimestampFormat.httpDate.date(from: httpDateString), httpDateFormatter.date(from: httpDateString))
+        }
+    }
+
+    func testTimestampFormatParsing() {
+        XCTAssertEqual(TimestampFormat.iso8601.date(from: "2020-02-29T23:59:59Z")?.timeIntervalSince1970, 1_583_020_799)
+        XCTAssertEqual(TimestampFormat.iso8601WithFractionalSeconds.date(from: "2020-02-29T23:59:59.5Z")?.timeIntervalSince1970, 1_583_020_799.5)
+        XCTAssertEqual(TimestampFormat.httpDate.date(from: "Sat, 29 Feb 2020 23:59:59 UTC")?.timeIntervalSince1970, 1_583_020_799)
+        XCTAssertNil(TimestampFormat.iso8601.date(from: "2021-02-29T00:00:00Z"))
+        XCTAssertNil(TimestampFormat.iso8601.date(from: "2020-01-01T24:00:00Z"))
+        XCTAssertNil(TimestampFormat.iso8601.date(from: "2020-01-01T00:00:00.000Z"))
+        XCTAssertNil(TimestampFormat.iso8601WithFractionalSeconds.date(from: "2020-01-01T00:00:00Z"))
+        XCTAssertNil(TimestampFormat.iso8601.date(from: "2020-01-01T00:00:00Z "))
+        XCTAssertNil(TimestampFormat.httpDate.date(from: "Sat, 29 Feb 2020 23:59:59 PST"))
+        // HTTPHeaderDateCoder falls back to DateFormatter for timezones other than GMT or UTC
+        XCTAssertEqual(HTTPHeaderDateCoder.date(from: "Sat, 29 Feb 2020 15:59:59 PST")?.timeIntervalSince1970, 1_583_020_799)
+    }
+
     // MARK: Types used in tests
 
     struct AWSHTTPResponseImpl: AWSHTTPResponse {
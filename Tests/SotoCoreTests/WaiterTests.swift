@@ -322,4 +322,102 @@ class WaiterTests: XCTestCase {
 
         XCTAssertNoThrow(try response.wait())
     }
+
+    func testBatchedWaiter() {
+        struct InstancesInput: AWSEncodableShape & Decodable {
+            let ids: [String]
+        }
+        struct InstancesOutput: AWSDecodableShape & Encodable {
+            struct Instance: AWSDecodableShape & Encodable {
+                let id: String
+                let running: Bool
+            }
+
+            let instances: [Instance]
+        }
+        func operation(input: InstancesInput, logger: Logger, eventLoop: EventLoop?) -> EventLoopFuture<InstancesOutput> {
+            self.client.execute(operation: "Describe", path: "/", httpMethod: .POST, serviceConfig: self.config, input: input, logger: logger, on: eventLoop)
+        }
+        let waiter = AWSClient.Waiter(
+            acceptors: [
+                .init(state: .success, matcher: try! JMESAllPathMatcher("instances[*].running", expected: true)),
+            ],
+            minDelayTime: .milliseconds(200),
+            command: operation
+        )
+        let batching = AWSClient.WaiterBatching<InstancesInput, InstancesOutput>(
+            maxBatchSize: 10,
+            batchKey: { _ in 0 },
+            combine: { InstancesInput(ids: $0.flatMap { $0.ids }.sorted()) },
+            split: { output, input in InstancesOutput(instances: output.instances.filter { input.ids.contains($0.id) }) }
+        )
+        let inputs = ["a", "b", "c"].map { InstancesInput(ids: [$0]) }
+        let response = self.client.waitUntil(inputs, waiter: waiter, batching: batching, logger: TestEnvironment.logger)
+
+        var requests: [[String]] = []
+        XCTAssertNoThrow(try self.awsServer.process { (input: InstancesInput) -> AWSTestServer.Result<InstancesOutput> in
+            requests.append(input.ids)
+            // "a" is running from the first request, the others from the second
+            let instances = input.ids.map { InstancesOutput.Instance(id: $0, running: $0 == "a" || requests.count > 1) }
+            return .result(InstancesOutput(instances: instances), continueProcessing: requests.count < 2)
+        })
+
+        XCTAssertNoThrow(try response.wait())
+        XCTAssertEqual(requests, [["a", "b", "c"], ["b", "c"]])
+    }
+
+    func testBatchedWaiterStopsPollingAfterFailure() {
+        struct InstancesInput: AWSEncodableShape & Decodable {
+            let ids: [String]
+        }
+        struct InstancesOutput: AWSDecodableShape & Encodable {
+            struct Instance: AWSDecodableShape & Encodable {
+                let id: String
+                let running: Bool
+                let terminated: Bool
+            }
+
+            let instances: [Instance]
+        }
+        func operation(input: InstancesInput, logger: Logger, eventLoop: EventLoop?) -> EventLoopFuture<InstancesOutput> {
+            self.client.execute(operation: "Describe", path: "/", httpMethod: .POST, serviceConfig: self.config, input: input, logger: logger, on: eventLoop)
+        }
+        let waiter = AWSClient.Waiter(
+            acceptors: [
+                .init(state: .success, matcher: try! JMESAllPathMatcher("instances[*].running", expected: true)),
+                .init(state: .failure, matcher: try! JMESAnyPathMatcher("instances[*].terminated", expected: true)),
+            ],
+            minDelayTime: .milliseconds(200),
+            command: operation
+        )
+        let batching = AWSClient.WaiterBatching<InstancesInput, InstancesOutput>(
+            maxBatchSize: 10,
+            batchKey: { _ in 0 },
+            combine: { InstancesInput(ids: $0.flatMap { $0.ids }.sorted()) },
+            split: { output, input in InstancesOutput(instances: output.instances.filter { input.ids.contains($0.id) }) }
+        )
+        let coordinator = AWSClient.WaiterCoordinator(waiter: waiter, batching: batching, eventLoop: self.client.eventLoopGroup.next())
+        var requests: [[String]] = []
+
+        // "a" is terminated so the waiters for "b" and "c" should stop polling
+        let response = coordinator.waitUntil(["a", "b", "c"].map { InstancesInput(ids: [$0]) }, logger: TestEnvironment.logger)
+        XCTAssertNoThrow(try self.awsServer.process { (input: InstancesInput) -> AWSTestServer.Result<InstancesOutput> in
+            requests.append(input.ids)
+            let instances = input.ids.map { InstancesOutput.Instance(id: $0, running: false, terminated: $0 == "a") }
+            return .result(InstancesOutput(instances: instances), continueProcessing: false)
+        })
+        XCTAssertThrowsError(try response.wait()) { error in
+            XCTAssertEqual(error as? AWSClient.ClientError, .waiterFailed)
+        }
+
+        // if "b" and "c" were still waiting they would be polled along with "d"
+        let response2 = coordinator.waitUntil(InstancesInput(ids: ["d"]), logger: TestEnvironment.logger)
+        XCTAssertNoThrow(try self.awsServer.process { (input: InstancesInput) -> AWSTestServer.Result<InstancesOutput> in
+            requests.append(input.ids)
+            let instances = input.ids.map { InstancesOutput.Instance(id: $0, running: true, terminated: false) }
+            return .result(InstancesOutput(instances: instances), continueProcessing: false)
+        })
+        XCTAssertNoThrow(try response2.wait())
+        XCTAssertEqual(requests, [["a", "b", "c"], ["d"]])
+    }
 }
@@ -140,11 +140,19 @@ final class SotoCryptoTests: XCTestCase {
         XCTAssertEqual(authenticationKey, authenticationKey2)
         XCTAssertEqual(authenticationKey.hexDigest(), authenticationKey2.hexDigest())
     }
-}
 
-public extension Sequence where Element == UInt8 {
-    /// return a hexEncoded string buffer from an array of bytes
-    func hexDigest() -> String {
-        return map { String(format: "%02x", $0) }.joined(separator: "")
+    func testHexDigest() {
+        XCTAssertEqual([UInt8]().hexDigest(), "")
+        XCTAssertEqual(([0x00, 0x0F, 0xA0, 0xFF] as [UInt8]).hexDigest(), "000fa0ff")
+        // non contiguous sequence
+        XCTAssertEqual((0..<4).lazy.map { UInt8($0 * 0x11) }.hexDigest(), "00112233")
+        // larger than the stack buffer
+        let data = self.createRandomBuffer(45, 1798, size: 300)
+        let expected = data.map { String(format: "%02x", $0) }.joined()
+        XCTAssertEqual(data.hexDigest(), expected)
+        XCTAssertEqual(Data(data).hexDigest(), expected)
+        var buffer: [UInt8] = Array("hash=".utf8)
+        data.prefix(32).hexDigest(into: &buffer)
+        XCTAssertEqual(String(decoding: buffer, as: Unicode.UTF8.self), "hash=" + expected.prefix(64))
     }
 }
@@ -54,6 +54,18 @@ final class AWSSignerTests: XCTestCase {
         XCTAssertEqual(headers["Authorization"].first, "AWS4-HMAC-SHA256 Credential=MYACCESSKEY/20010101/eu-west-1/sns/aws4_request, SignedHeaders=content-type;host;x-amz-content-sha256;x-amz-date, Signature=1d29943055a8ad094239e8de06082100f2426ebbb2c6a5bbcbb04c63e6a3f274")
     }
 
+    func testSignHeadersWithHashedPayload() {
+        let signer = AWSSigner(credentials: credentials, name: "s3", region: "us-east-1")
+        let url = URL(string: "https://s3.us-east-1.amazonaws.com/bucket/file")!
+        let date = Date(timeIntervalSinceReferenceDate: 2_000_000)
+        let headers = signer.signHeaders(url: url, method: .PUT, hashedPayload: "STREAMING-UNSIGNED-PAYLOAD-TRAILER", date: date)
+        XCTAssertEqual(headers["x-amz-content-sha256"].first, "STREAMING-UNSIGNED-PAYLOAD-TRAILER")
+        // passing the hash of a body gives the same result as passing the body
+        let bodyHeaders = signer.signHeaders(url: url, method: .PUT, body: .unsignedPayload, date: date)
+        let hashedHeaders = signer.signHeaders(url: url, method: .PUT, hashedPayload: "UNSIGNED-PAYLOAD", date: date)
+        XCTAssertEqual(bodyHeaders["Authorization"], hashedHeaders["Authorization"])
+    }
+
     func testSignS3GetURL() {
         let signer = AWSSigner(credentials: credentials, name: "s3", region: "us-east-1")
         let url = signer.signURL(url: URL(string: "https://s3.us-east-1.amazonaws.com/")!, method: .GET, expires: .hours(24), date: Date(timeIntervalSinceReferenceDate: 100_000))
@@ -110,6 +122,9 @@ final class AWSSignerTests: XCTestCase {
         XCTAssertNotNil(headers1["Authorization"].first)
         XCTAssertEqual(headers1["Authorization"].first, headers2["Authorization"].first)
         XCTAssertEqual(headers2["Authorization"].first, headers3["Authorization"].first)
+        XCTAssertEqual(AWSSigner.hashedPayload(.string(string)), "2d4ecec14e46c203d72885726de017823a59c9a3a309ebaee001496ae5217118")
+        XCTAssertEqual(AWSSigner.hashedPayload(.data(data)), "2d4ecec14e46c203d72885726de017823a59c9a3a309ebaee001496ae5217118")
+        XCTAssertEqual(AWSSigner.hashedPayload(.byteBuffer(buffer)), "2d4ecec14e46c203d72885726de017823a59c9a3a309ebaee001496ae5217118")
     }
 
     func testCanonicalRequest() throws {
@@ -136,4 +151,103 @@ final class AWSSignerTests: XCTestCase {
         """
         XCTAssertEqual(request, expectedRequest)
     }
+
+    func testCanonicalRequestPathEncodingAndDuplicateHeaders() throws {
+        let url = URL(string: "https://test.s3.amazonaws.com/folder/test%20file+1.txt?acl=")!
+        let headers: HTTPHeaders = ["host": "test.s3.amazonaws.com", "x-amz-meta-a": " one ", "X-Amz-Meta-A": "two\t", "Authorization": "ignored"]
+        let s3Signer = AWSSigner(credentials: credentials, name: "s3", region: "eu-west-1")
+        let s3SigningData = AWSSigner.SigningData(url: url, headers: headers, date: AWSSigner.timestamp(Date(timeIntervalSince1970: 234_873)), signer: s3Signer)
+        XCTAssertEqual(s3SigningData.signedHeaders, "host;x-amz-meta-a")
+        XCTAssertEqual(s3Signer.canonicalRequest(signingData: s3SigningData), """
+        GET
+        /folder/test%20file%2B1.txt
+        acl=
+        host:test.s3.amazonaws.com
+        x-amz-meta-a:one,two
+
+        host;x-amz-meta-a
+        UNSIGNED-PAYLOAD
+        """)
+
+        // non S3 paths are encoded twice
+        let signer = AWSSigner(credentials: credentials, name: "sns", region: "eu-west-1")
+        let signingData = AWSSigner.SigningData(url: url, headers: ["host": "localhost"], date: AWSSigner.timestamp(Date(timeIntervalSince1970: 234_873)), signer: signer)
+        XCTAssertEqual(signer.canonicalRequest(signingData: signingData), """
+        GET
+        /folder/test%2520file%2B1.txt
+        acl=
+        host:localhost
+
+        host
+        e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855
+        """)
+    }
+
+    func testCanonicalHeaderValueWhitespace() throws {
+        let url = URL(string: "https://test.com/")!
+        let headers: HTTPHeaders = ["host": "localhost", "x-amz-meta-b": "\t  a   b \t c  ", "x-amz-meta-c": "   "]
+        let signer = AWSSigner(credentials: credentials, name: "sns", region: "eu-west-1")
+        let signingData = AWSSigner.SigningData(url: url, headers: headers, date: AWSSigner.timestamp(Date(timeIntervalSince1970: 234_873)), signer: signer)
+        XCTAssertEqual(signer.canonicalRequest(signingData: signingData), """
+        GET
+        /
+
+        host:localhost
+        x-amz-meta-b:a b c
+        x-amz-meta-c:
+
+        host;x-amz-meta-b;x-amz-meta-c
+        e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855
+        """)
+    }
+
+    func testSigningKeyCache() {
+        let cache = SigningKeyCache()
+        let signer = AWSSigner(credentials: credentials, name: "glacier", region: "us-east-1", signingKeyCache: cache)
+        for _ in 0..<2 {
+            let headers = signer.signHeaders(url: URL(string: "https://glacier.us-east-1.amazonaws.com/-/vaults")!, method: .GET, headers: ["x-amz-glacier-version": "2012-06-01"], date: Date(timeIntervalSinceReferenceDate: 2_000_000))
+            XCTAssertEqual(headers["Authorization"].first, "AWS4-HMAC-SHA256 Credential=MYACCESSKEY/20010124/us-east-1/glacier/aws4_request, SignedHeaders=host;x-amz-content-sha256;x-amz-date;x-amz-glacier-version, Signature=acfa9b03fca6b098d7b88bfd9bbdb4687f5b34e944a9c6ed9f4814c1b0b06d62")
+        }
+        XCTAssertEqual(cache.count, 1)
+
+        // different region, date and secret all generate new keys
+        let signer2 = AWSSigner(credentials: credentials, name: "glacier", region: "eu-west-1", signingKeyCache: cache)
+        XCTAssertEqual(signer2.scope(date: "20010124"), "20010124/eu-west-1/glacier/aws4_request")
+        XCTAssertEqual(signer2.scope(date: "20010125"), "20010125/eu-west-1/glacier/aws4_request")
+        let signer3 = AWSSigner(credentials: StaticCredential(accessKeyId: "MYACCESSKEY", secretAccessKey: "OTHERSECRET"), name: "glacier", region: "eu-west-1", signingKeyCache: cache)
+        XCTAssertNotEqual(signer3.signingKey(date: "20010124").withUnsafeBytes { [UInt8]($0) }, signer2.signingKey(date: "20010124").withUnsafeBytes { [UInt8]($0) })
+        XCTAssertEqual(cache.count, 4)
+        XCTAssertEqual(signer2.signingKey(date: "20010124").withUnsafeBytes { [UInt8]($0) }, signer2.deriveSigningKey(date: "20010124").withUnsafeBytes { [UInt8]($0) })
+    }
+
+    func testSigningKeyCacheFlush() {
+        let cache = SigningKeyCache(maxCount: 2)
+        let signer = AWSSigner(credentials: credentials, name: "sns", region: "eu-west-1", signingKeyCache: cache)
+        _ = signer.signingKey(date: "20010101")
+        _ = signer.signingKey(date: "20010102")
+        XCTAssertEqual(cache.count, 2)
+        _ = signer.signingKey(date: "20010103")
+        XCTAssertEqual(cache.count, 1)
+        cache.removeAll()
+        XCTAssertEqual(cache.count, 0)
+    }
+
+    func testSignChunkWithHashedPayload() {
+        let signer = AWSSigner(credentials: credentials, name: "s3", region: "us-east-1")
+        let (_, seedSigningData) = signer.startSigningChunks(url: URL(string: "https://test-bucket.s3.amazonaws.com/test-put.txt")!, method: .PUT, date: Date(timeIntervalSinceReferenceDate: 100_000))
+        var chunk = ByteBufferAllocator().buffer(capacity: 32)
+        chunk.writeString("testing, testing, 1,2,1,2")
+        let signingData = signer.signChunk(body: .byteBuffer(chunk), signingData: seedSigningData)
+        let signingData2 = signer.signChunk(hashedPayload: AWSSigner.hashedPayload(.byteBuffer(chunk)), signingData: seedSigningData)
+        XCTAssertEqual(signingData.signature, signingData2.signature)
+        let finalSigningData = signer.signChunk(body: .string(""), signingData: signingData)
+        let finalSigningData2 = signer.signChunk(hashedPayload: AWSSigner.hashedPayload(nil), signingData: signingData2)
+        XCTAssertEqual(finalSigningData.signature, finalSigningData2.signature)
+    }
+
+    func testHexDigest() {
+        // hexDigest is still available from SotoSignerV4
+        XCTAssertEqual(([0x00, 0x0F, 0xA0, 0xFF] as [UInt8]).hexDigest(), "000fa0ff")
+        XCTAssertEqual("abc".utf8.hexDigest(), "616263")
+    }
 }
@@ -476,4 +476,134 @@ class XMLCoderTests: XCTestCase {
             XCTFail(error.localizedDescription)
         }
     }
+
+    /// helper test function decoding with XMLStreamingDecoder
+    func testStreamingDecode<T: Decodable>(type: T.Type, xml: String) -> T? {
+        do {
+            var xml = xml
+            return try xml.withUTF8 { try XMLStreamingDecoder().decode(T.self, from: UnsafeRawBufferPointer($0)) }
+        } catch {
+            XCTFail("\(error)")
+        }
+        return nil
+    }
+
+    func testStreamingDecodeXML() {
+        do {
+            let xml = try XMLEncoder().encode(self.testShape)
+            let testShape2 = try XCTUnwrap(self.testStreamingDecode(type: Shape.self, xml: xml.xmlString))
+            let xml2 = try XMLEncoder().encode(testShape2)
+
+            XCTAssertEqual(xml.xmlString, xml2.xmlString)
+        } catch {
+            XCTFail("\(error)")
+        }
+    }
+
+    func testStreamingDecodeDictionariesXML() {
+        do {
+            let xml = try XMLEncoder().encode(self.testShapeWithDictionaries)
+            let testShape2 = self.testStreamingDecode(type: ShapeWithDictionaries.self, xml: xml.xmlString)
+
+            XCTAssertEqual(testShape2?.dictionaries.dictionaryOfNatives["second"], 2)
+            XCTAssertEqual(testShape2?.dictionaries.dictionaryOfShapes["strings2"]?.stringEnum, .fourth)
+        } catch {
+            XCTFail("\(error)")
+        }
+    }
+
+    func testStreamingDecodeAttributesDatesAndData() {
+        struct Test: Codable {
+            let type: String
+            let date: Date
+            let data: Data
+            let optional: String?
+            let values: [Int]
+        }
+        let base64 = "Hello, world".data(using: .utf8)!.base64EncodedString()
+        let xml = "<Test type=\"Hello\"><date>2020-03-01T20:00:00.000Z</date>\n<data>\(base64)</data><values>1</values><values>2</values></Test>"
+        let value = self.testStreamingDecode(type: Test.self, xml: xml)
+        XCTAssertEqual(value?.type, "Hello")
+        XCTAssertEqual(value?.date, Date(timeIntervalSince1970: 1_583_092_800))
+        XCTAssertEqual(value?.data, "Hello, world".data(using: .utf8))
+        XCTAssertNil(value?.optional)
+        XCTAssertEqual(value?.values, [1, 2])
+    }
+
+    func testStreamingParserChunks() throws {
+        struct Test: Codable {
+            let a: String
+            let b: [Int]
+        }
+        let xml = "<Test><a>Hello &amp; goodbye</a><b>1</b><b>2</b><b>3</b></Test>"
+        let bytes = [UInt8](xml.utf8)
+        let parser = try XMLStreamingDecoder.Parser()
+        for index in stride(from: 0, to: bytes.count, by: 3) {
+            try bytes[index..<min(index + 3, bytes.count)].withUnsafeBytes { try parser.feed($0) }
+        }
+        let document = try XCTUnwrap(parser.finish())
+        XCTAssertEqual(document.rootElement.name, "Test")
+        XCTAssertEqual(document.rootElement.firstChild?.name, "a")
+        let value = try XMLStreamingDecoder().decode(Test.self, from: document.rootElement)
+        XCTAssertEqual(value.a, "Hello & goodbye")
+        XCTAssertEqual(value.b, [1, 2, 3])
+    }
+
+    func testNonConformingFloatDecoding() throws {
+        struct Test: Codable {
+            let a: Double
+            let b: Float
+            let c: Double
+            let d: Double
+        }
+        let strategy = XMLDecoder.NonConformingFloatDecodingStrategy.convertFromString(positiveInfinity: "PosInf", negativeInfinity: "NegInf", nan: "NotANumber")
+        var xml = "<Test><a>PosInf</a><b>NegInf</b><c>NotANumber</c><d>1.5</d></Test>"
+
+        var streamingDecoder = XMLStreamingDecoder()
+        streamingDecoder.nonConformingFloatDecodingStrategy = strategy
+        let value = try xml.withUTF8 { try streamingDecoder.decode(Test.self, from: UnsafeRawBufferPointer($0)) }
+        XCTAssertEqual(value.a, .infinity)
+        XCTAssertEqual(value.b, -.infinity)
+        XCTAssert(value.c.isNaN)
+        XCTAssertEqual(value.d, 1.5)
+
+        var decoder = XMLDecoder()
+        decoder.nonConformingFloatDecodingStrategy = strategy
+        let value2 = try decoder.decode(Test.self, from: XML.Element(xmlString: xml))
+        XCTAssertEqual(value2.a, .infinity)
+        XCTAssertEqual(value2.b, -.infinity)
+        XCTAssert(value2.c.isNaN)
+        XCTAssertEqual(value2.d, 1.5)
+
+        // without the strategy the strings are not numbers
+        XCTAssertThrowsError(try xml.withUTF8 { try XMLStreamingDecoder().decode(Test.self, from: UnsafeRawBufferPointer($0)) })
+        XCTAssertThrowsError(try XMLDecoder().decode(Test.self, from: XML.Element(xmlString: xml)))
+    }
+
+    func testStreamingDecodeBase64() {
+        struct Test: Codable {
+            let data: Data
+        }
+        // no padding, one and two padding characters
+        for string in ["Hello!", "Hello", "Hell", ""] {
+            let base64 = string.data(using: .utf8)!.base64EncodedString()
+            let value = self.testStreamingDecode(type: Test.self, xml: "<Test><data>\(base64)</data></Test>")
+            XCTAssertEqual(value?.data, string.data(using: .utf8))
+        }
+        for invalid in ["SGVsbG8", "SGV=bG8h", "SGVsbG8h!!!!"] {
+            var xml = "<Test><data>\(invalid)</data></Test>"
+            XCTAssertThrowsError(try xml.withUTF8 { try XMLStreamingDecoder().decode(Test.self, from: UnsafeRawBufferPointer($0)) })
+        }
+    }
+
+    func testStreamingDecodeTextSplitByElement() {
+        struct Test: Codable {
+            let a: String
+            let b: String
+        }
+        let xml = "<Test><a>Hello<c>1</c>, world</a>\n  <b> </b></Test>"
+        let value = self.testStreamingDecode(type: Test.self, xml: xml)
+        XCTAssertEqual(value?.a, "Hello, world")
+        XCTAssertEqual(value?.b, "")
+    }
 }
@@ -126,6 +126,139 @@ class XMLTests: XCTestCase {
         XCTAssertNoThrow(try self.testDecodeEncode(xml: xml))
     }
 
+    func testIncrementalParser() throws {
+        let xml = "<test><a>Hello &amp; goodbye</a><b attribute=\"value\">  </b><c>a  &amp;  b</c></test>"
+        let bytes = Array(xml.utf8)
+        let parser = try XML.IncrementalParser()
+        // feed parser in small blocks so elements, attributes and text are split across blocks
+        for index in stride(from: 0, to: bytes.count, by: 3) {
+            try bytes[index..<min(index + 3, bytes.count)].withUnsafeBytes { try parser.feed($0) }
+        }
+        let element = try XCTUnwrap(parser.finish())
+        XCTAssertEqual(element.xmlString, "<test><a>Hello &amp; goodbye</a><b attribute=\"value\"></b><c>a  &amp;  b</c></test>")
+    }
+
+    func testIncrementalParserFillBuffer() throws {
+        let bytes = Array("<test><a>Hello</a><b>Goodbye</b></test>".utf8)
+        let parser = try XML.IncrementalParser()
+        for index in stride(from: 0, to: bytes.count, by: 8) {
+            let block = bytes[index..<min(index + 8, bytes.count)]
+            try parser.feed(capacity: 8) { buffer in
+                buffer.copyBytes(from: block)
+                return block.count
+            }
+        }
+        let element = try XCTUnwrap(parser.finish())
+        XCTAssertEqual(element.xmlString, "<test><a>Hello</a><b>Goodbye</b></test>")
+    }
+
+    func testEmbeddedNul() {
+        // data after the NUL should not be silently ignored
+        let xml = "<test>Hello</test>\u{0}<test>Goodbye</test>"
+        XCTAssertThrowsError(try XML.Document(data: Data(xml.utf8)))
+        XCTAssertThrowsError(try XML.Document(string: xml))
+    }
+
+    func testIncrementalParserNoData() throws {
+        let parser = try XML.IncrementalParser()
+        XCTAssertNil(try parser.finish())
+    }
+
+    func testAttributesInDocumentOrder() throws {
+        let xml = "<test b=\"2\" a=\"1\" c=\"3\"><member></member><member key=\"value\"></member></test>"
+        let element = try XML.Element(xmlString: xml)
+        XCTAssertEqual(element.xmlString, xml)
+    }
+
+    func testAttributeLookup() throws {
+        var values: [String?] = []
+        let parser = try Expat()
+            .onStartElement { _, attributes in
+                values.append(attributes["a"])
+            }
+        _ = try parser.feed("<test b=\"2\" a=\"1\"><child></child></test>", final: true)
+        XCTAssertEqual(values, ["1", nil])
+    }
+
+    func testIndexedElementLookup() throws {
+        let xml = "<test>" + (0..<20).map { "<a\($0 % 5)>\($0)</a\($0 % 5)>" }.joined() + "</test>"
+        let element = try XML.Element(xmlString: xml)
+        XCTAssertEqual(element.elements(forName: "a2").map { $0.stringValue }, ["2", "7", "12", "17"])
+        XCTAssertEqual(element.firstElement(forName: "a4")?.stringValue, "4")
+        XCTAssertNil(element.firstElement(forName: "b"))
+        // index is discarded when children change
+        element.addChild(XML.Element(name: "b", stringValue: "new"))
+        XCTAssertEqual(element.firstElement(forName: "b")?.stringValue, "new")
+        element.firstElement(forName: "a4")?.detach()
+        XCTAssertEqual(element.firstElement(forName: "a4")?.stringValue, "9")
+        element.firstElement(forName: "a4")?.name = "c"
+        XCTAssertEqual(element.firstElement(forName: "a4")?.stringValue, "14")
+        XCTAssertEqual(element.firstElement(forName: "c")?.stringValue, "9")
+    }
+
+    func testParserReuse() throws {
+        let parser = try XML.IncrementalParser()
+        try parser.feed(UnsafeRawBufferPointer(start: nil, count: 0))
+        XCTAssertNil(try parser.finish())
+        // parser recycled by finish should be returned by the next request for a parser
+        let expat = try Expat.make()
+        expat.recycle()
+        XCTAssert(try Expat.make() === expat)
+        expat.recycle()
+
+        for index in 0..<3 {
+            let xml = "<test\(index) a=\"\(index)\"><value>\(index)</value></test\(index)>"
+            let element = try XML.Element(xmlString: xml)
+            XCTAssertEqual(element.xmlString, xml)
+        }
+        // reused parser still reports errors
+        XCTAssertThrowsError(try XML.Element(xmlString: "<test><value></test>"))
+        XCTAssertEqual(try XML.Element(xmlString: "<test><value>1</value></test>").xmlString, "<test><value>1</value></test>")
+    }
+
+    func testArenaParser() throws {
+        var count = 0
+        let expat = try Expat(memory: .arena)
+        _ = expat.onStartElement { _, _ in count += 1 }
+        // large enough to need more than one arena block
+        let xml = "<test>" + (0..<2000).map { "<value\($0 % 50) a=\"\($0)\">\($0)</value\($0 % 50)>" }.joined() + "</test>"
+        _ = try expat.feed(xml, final: true)
+        XCTAssertEqual(count, 2001)
+        // the arena holds the parser's own buffers so it can't be reset, and it isn't pooled
+        XCTAssertFalse(expat.reset())
+        expat.recycle()
+        let pooled = try Expat.make()
+        XCTAssert(pooled !== expat)
+        pooled.recycle()
+    }
+
+    func testArenaParserGrowsAllocationsInPlace() throws {
+        // the attribute value is built in a buffer Expat grows with realloc. If each growth abandoned the
+        // previous allocation the arena would need around twice the memory
+        let length = 300_000
+        var value = 0
+        let expat = try Expat(memory: .arena)
+        _ = expat.onStartElement { _, attributes in value = attributes["a"]?.count ?? 0 }
+        _ = try expat.feed("<test a=\"\(String(repeating: "x", count: length))\"></test>", final: true)
+        XCTAssertEqual(value, length)
+        XCTAssertLessThan(expat.arenaCapacity, 4 * length)
+    }
+
+    func testLongCharacterData() throws {
+        // check markup and non-ASCII characters are found at every position in and around a block of 16 bytes
+        let base64 = Data((0..<96).map { UInt8($0) }).base64EncodedString()
+        for index in 0..<40 {
+            let prefix = String(base64.prefix(index))
+            let suffix = String(base64.dropFirst(index))
+            for (text, value) in [("&amp;", "&"), ("é", "é"), ("]", "]"), ("\t", "\t"), ("\n", "\n"), ("<b/>", "")] {
+                let element = try XML.Element(xmlString: "<test>\(prefix)\(text)\(suffix)</test>")
+                XCTAssertEqual(element.stringValue, prefix + value + suffix)
+            }
+        }
+        XCTAssertThrowsError(try XML.Element(xmlString: "<test>\(base64)\u{01}\(base64)</test>"))
+        XCTAssertThrowsError(try XML.Element(xmlString: "<test>\(base64)]]>\(base64)</test>"))
+    }
+
     func testDecodeRubbish() {
         let xml = "{}"
         XCTAssertThrowsError(try XML.Document(data: Data(xml.utf8)))